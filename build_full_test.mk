@@ -17,8 +17,12 @@
 
 TEST_PATH=tests/$(TEST)
 
+# A test's rules.mk can point these somewhere else, see tests/simulator
+TEST_KEYMAP_C ?= $(TEST_PATH)/keymap.c
+TEST_CONFIG_H ?= $(TEST_PATH)/config.h
+
 $(TEST)_SRC= \
-	$(TEST_PATH)/keymap.c \
+	$(TEST_KEYMAP_C) \
 	$(TMK_COMMON_SRC) \
 	$(QUANTUM_SRC) \
 	$(SRC) \
@@ -29,5 +33,5 @@ $(TEST)_SRC= \
 $(TEST)_SRC += $(patsubst $(ROOTDIR)/%,%,$(wildcard $(TEST_PATH)/*.cpp))
 
 $(TEST)_DEFS=$(TMK_COMMON_DEFS) $(OPT_DEFS)
-$(TEST)_CONFIG=$(TEST_PATH)/config.h
+$(TEST)_CONFIG=$(TEST_CONFIG_H)
 VPATH+=$(TOP_DIR)/tests/test_common
\ No newline at end of file
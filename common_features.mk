@@ -17,6 +17,7 @@ SERIAL_PATH := $(QUANTUM_PATH)/serial_link
 
 QUANTUM_SRC += \
     $(QUANTUM_DIR)/quantum.c \
+    $(QUANTUM_DIR)/process_keycode/process_dispatch.c \
     $(QUANTUM_DIR)/keymap_common.c \
     $(QUANTUM_DIR)/keycode_config.c
 
@@ -34,6 +35,9 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/process_keycode/process_audio.c
     SRC += $(QUANTUM_DIR)/process_keycode/process_clicky.c
     SRC += $(QUANTUM_DIR)/audio/audio_$(PLATFORM_KEY).c
+    ifneq ($(PLATFORM_KEY),avr)
+        SRC += $(QUANTUM_DIR)/audio/synth.c
+    endif
     SRC += $(QUANTUM_DIR)/audio/voices.c
     SRC += $(QUANTUM_DIR)/audio/luts.c
 endif
@@ -378,6 +382,11 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
     endif
 endif
 
+ifeq ($(strip $(MATRIX_IDLE_ENABLE)), yes)
+    OPT_DEFS += -DMATRIX_IDLE_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/matrix_idle.c
+endif
+
 DEBOUNCE_DIR:= $(QUANTUM_DIR)/debounce
 # Debounce Modules. Set DEBOUNCE_TYPE=custom if including one manually.
 DEBOUNCE_TYPE?= sym_g
@@ -407,6 +416,9 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
             QUANTUM_LIB_SRC += serial.c
         else
             QUANTUM_LIB_SRC += serial_$(strip $(SERIAL_DRIVER)).c
+            ifeq ($(strip $(SERIAL_DRIVER)), usart_duplex)
+                QUANTUM_LIB_SRC += serial_duplex.c
+            endif
         endif
     endif
     COMMON_VPATH += $(QUANTUM_PATH)/split_common
@@ -484,6 +496,16 @@ ifeq ($(strip $(GRAVE_ESC_ENABLE)), yes)
     OPT_DEFS += -DGRAVE_ESC_ENABLE
 endif
 
+ifeq ($(strip $(SCAN_PROFILE_ENABLE)), yes)
+    OPT_DEFS += -DSCAN_PROFILE_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/scan_profile.c
+endif
+
+ifeq ($(strip $(SEND_STRING_QUEUE_ENABLE)), yes)
+    OPT_DEFS += -DSEND_STRING_QUEUE_ENABLE
+    QUANTUM_SRC += $(QUANTUM_DIR)/send_string_queue.c
+endif
+
 ifeq ($(strip $(DYNAMIC_MACRO_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/process_keycode/process_dynamic_macro.c
     OPT_DEFS += -DDYNAMIC_MACRO_ENABLE
@@ -0,0 +1,115 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Physical layer of the full duplex split transport, using the DMA backed
+ * UART driver. Please ensure that HAL_USE_UART and UART_USE_WAIT are TRUE in
+ * the halconf.h file and that the UART is enabled in the mcuconf.h file.
+ * UARTD1 is the default driver which corresponds to pins A9 (TX) and A10 (RX).
+ * The TX pin of each half must be connected to the RX pin of the other one.
+ */
+
+#include "quantum.h"
+#include "serial_duplex.h"
+
+#ifndef SERIAL_USART_DRIVER
+#    define SERIAL_USART_DRIVER UARTD1
+#endif
+
+#ifndef SERIAL_USART_TX_PIN
+#    define SERIAL_USART_TX_PIN A9
+#endif
+
+#ifndef SERIAL_USART_RX_PIN
+#    define SERIAL_USART_RX_PIN A10
+#endif
+
+#ifndef SERIAL_USART_TX_PAL_MODE
+#    define SERIAL_USART_TX_PAL_MODE 7
+#endif
+
+#ifndef SERIAL_USART_RX_PAL_MODE
+#    define SERIAL_USART_RX_PAL_MODE 7
+#endif
+
+#ifndef SERIAL_USART_SPEED
+#    define SERIAL_USART_SPEED 1000000
+#endif
+
+// Maximum time to wait for a whole frame, in milliseconds
+#ifndef SERIAL_USART_TIMEOUT
+#    define SERIAL_USART_TIMEOUT 20
+#endif
+
+// The line is considered idle when nothing was received for about 20 byte times
+#define SERIAL_USART_IDLE_US (200000000 / SERIAL_USART_SPEED + 1)
+
+static const UARTConfig uart_config = {
+    .speed = SERIAL_USART_SPEED,
+};
+
+// DMA target when the input is discarded
+static uint8_t discard_buffer;
+
+// Keeps the target thread and the scan loop from using the transaction buffers at the same time
+static MUTEX_DECL(target_mutex);
+
+void soft_serial_target_lock(void) { chMtxLock(&target_mutex); }
+
+void soft_serial_target_unlock(void) { chMtxUnlock(&target_mutex); }
+
+static THD_WORKING_AREA(waSerialTargetThread, 256);
+static THD_FUNCTION(SerialTargetThread, arg) {
+    (void)arg;
+    chRegSetThreadName("split_serial");
+
+    while (true) {
+        serial_duplex_target_task();
+    }
+}
+
+void serial_duplex_phy_init(bool initiator) {
+#if defined(USE_GPIOV1)
+    palSetLineMode(SERIAL_USART_TX_PIN, PAL_MODE_STM32_ALTERNATE_PUSHPULL);
+    palSetLineMode(SERIAL_USART_RX_PIN, PAL_MODE_INPUT_PULLUP);
+#else
+    palSetLineMode(SERIAL_USART_TX_PIN, PAL_MODE_ALTERNATE(SERIAL_USART_TX_PAL_MODE) | PAL_STM32_OTYPE_PUSHPULL);
+    palSetLineMode(SERIAL_USART_RX_PIN, PAL_MODE_ALTERNATE(SERIAL_USART_RX_PAL_MODE) | PAL_STM32_PUPDR_PULLUP);
+#endif
+
+    uartStart(&SERIAL_USART_DRIVER, &uart_config);
+
+    // the target answers from its own thread, so the scan loop never waits on the line
+    if (!initiator) {
+        chThdCreateStatic(waSerialTargetThread, sizeof(waSerialTargetThread), HIGHPRIO, SerialTargetThread, NULL);
+    }
+}
+
+void serial_duplex_phy_clear(void) {
+    size_t size;
+    do {
+        size = 1;
+    } while (uartReceiveTimeout(&SERIAL_USART_DRIVER, &size, &discard_buffer, TIME_US2I(SERIAL_USART_IDLE_US)) == MSG_OK);
+}
+
+bool serial_duplex_phy_send(const uint8_t *data, uint16_t size) {
+    size_t n = size;
+    return uartSendFullTimeout(&SERIAL_USART_DRIVER, &n, data, TIME_MS2I(SERIAL_USART_TIMEOUT)) == MSG_OK;
+}
+
+bool serial_duplex_phy_receive(uint8_t *data, uint16_t size, bool wait) {
+    size_t n = size;
+    return uartReceiveTimeout(&SERIAL_USART_DRIVER, &n, data, wait ? TIME_INFINITE : TIME_MS2I(SERIAL_USART_TIMEOUT)) == MSG_OK;
+}
@@ -63,6 +63,11 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][144];
 bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+// One bit per PWM register changed since the last update
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][144 / 8] = {{0}};
+
+// Maximum number of unchanged registers written between two changed ones, instead of starting a new transfer
+#define ISSI_PWM_MAX_GAP 2
 
 uint8_t g_led_control_registers[DRIVER_COUNT][18]             = {{0}, {0}};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
@@ -121,6 +126,45 @@ void IS31FL3731_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+// Writes the PWM registers changed since the last update, in transfers of up to 16 registers
+static void IS31FL3731_write_pwm_dirty(uint8_t addr, uint8_t index) {
+    // assumes bank is already selected
+    uint8_t *dirty = g_pwm_buffer_dirty[index];
+
+    for (uint8_t start = 0; start < 144; start++) {
+        if (dirty[start / 8] == 0) {
+            start |= 7;
+            continue;
+        }
+        if (!(dirty[start / 8] & (1 << (start % 8)))) {
+            continue;
+        }
+
+        // extend the transfer over the following changed registers
+        uint8_t end = start + 1;
+        for (uint8_t i = end; i < 144 && i < start + 16 && i <= end + ISSI_PWM_MAX_GAP; i++) {
+            if (dirty[i / 8] & (1 << (i % 8))) {
+                end = i + 1;
+            }
+        }
+
+        g_twi_transfer_buffer[0] = 0x24 + start;
+        for (uint8_t i = start; i < end; i++) {
+            g_twi_transfer_buffer[1 + i - start] = g_pwm_buffer[index][i];
+            dirty[i / 8] &= ~(1 << (i % 8));
+        }
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 1 + end - start, ISSI_TIMEOUT) == 0) break;
+        }
+#else
+        i2c_transmit(addr << 1, g_twi_transfer_buffer, 1 + end - start, ISSI_TIMEOUT);
+#endif
+        start = end - 1;
+    }
+}
+
 void IS31FL3731_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, first enable software shutdown,
@@ -173,15 +217,22 @@ void IS31FL3731_init(uint8_t addr) {
     IS31FL3731_write_register(addr, ISSI_COMMANDREGISTER, 0);
 }
 
+static inline void IS31FL3731_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty[driver][reg / 8] |= (1 << (reg % 8));
+        g_pwm_buffer_update_required[driver] = true;
+    }
+}
+
 void IS31FL3731_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         is31_led led = g_is31_leds[index];
 
         // Subtract 0x24 to get the second index of g_pwm_buffer
-        g_pwm_buffer[led.driver][led.r - 0x24]   = red;
-        g_pwm_buffer[led.driver][led.g - 0x24]   = green;
-        g_pwm_buffer[led.driver][led.b - 0x24]   = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3731_set_pwm(led.driver, led.r - 0x24, red);
+        IS31FL3731_set_pwm(led.driver, led.g - 0x24, green);
+        IS31FL3731_set_pwm(led.driver, led.b - 0x24, blue);
     }
 }
 
@@ -222,7 +273,7 @@ void IS31FL3731_set_led_control_register(uint8_t index, bool red, bool green, bo
 
 void IS31FL3731_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
-        IS31FL3731_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        IS31FL3731_write_pwm_dirty(addr, index);
     }
     g_pwm_buffer_update_required[index] = false;
 }
@@ -67,6 +67,11 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
 bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+// One bit per PWM register changed since the last update
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][192 / 8] = {{0}};
+
+// Maximum number of unchanged registers written between two changed ones, instead of starting a new transfer
+#define ISSI_PWM_MAX_GAP 2
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24]             = {{0}, {0}};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
@@ -121,6 +126,54 @@ bool IS31FL3733_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     return true;
 }
 
+// Writes the PWM registers changed since the last update, in transfers of up to 16 registers.
+// Registers are only marked clean once written, if any of the transactions fails function returns false.
+static bool IS31FL3733_write_pwm_dirty(uint8_t addr, uint8_t index) {
+    // Assumes PG1 is already selected.
+    uint8_t *dirty = g_pwm_buffer_dirty[index];
+
+    for (uint8_t start = 0; start < 192; start++) {
+        if (dirty[start / 8] == 0) {
+            start |= 7;
+            continue;
+        }
+        if (!(dirty[start / 8] & (1 << (start % 8)))) {
+            continue;
+        }
+
+        // Extend the transfer over the following changed registers.
+        uint8_t end = start + 1;
+        for (uint8_t i = end; i < 192 && i < start + 16 && i <= end + ISSI_PWM_MAX_GAP; i++) {
+            if (dirty[i / 8] & (1 << (i % 8))) {
+                end = i + 1;
+            }
+        }
+
+        g_twi_transfer_buffer[0] = start;
+        for (uint8_t i = start; i < end; i++) {
+            g_twi_transfer_buffer[1 + i - start] = g_pwm_buffer[index][i];
+        }
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 1 + end - start, ISSI_TIMEOUT) != 0) {
+                return false;
+            }
+        }
+#else
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 1 + end - start, ISSI_TIMEOUT) != 0) {
+            return false;
+        }
+#endif
+
+        for (uint8_t i = start; i < end; i++) {
+            dirty[i / 8] &= ~(1 << (i % 8));
+        }
+        start = end - 1;
+    }
+    return true;
+}
+
 void IS31FL3733_init(uint8_t addr, uint8_t sync) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -163,14 +216,21 @@ void IS31FL3733_init(uint8_t addr, uint8_t sync) {
     wait_ms(10);
 }
 
+static inline void IS31FL3733_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty[driver][reg / 8] |= (1 << (reg % 8));
+        g_pwm_buffer_update_required[driver] = true;
+    }
+}
+
 void IS31FL3733_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         is31_led led = g_is31_leds[index];
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3733_set_pwm(led.driver, led.r, red);
+        IS31FL3733_set_pwm(led.driver, led.g, green);
+        IS31FL3733_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -216,9 +276,10 @@ void IS31FL3733_update_pwm_buffers(uint8_t addr, uint8_t index) {
         IS31FL3733_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
         // If any of the transactions fail we risk writing dirty PG0,
-        // refresh page 0 just in case.
-        if (!IS31FL3733_write_pwm_buffer(addr, g_pwm_buffer[index])) {
+        // refresh page 0 just in case, and retry the registers that weren't written.
+        if (!IS31FL3733_write_pwm_dirty(addr, index)) {
             g_led_control_registers_update_required[index] = true;
+            return;
         }
     }
     g_pwm_buffer_update_required[index] = false;
@@ -65,6 +65,11 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
 bool    g_pwm_buffer_update_required = false;
+// One bit per PWM register changed since the last update
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][192 / 8] = {{0}};
+
+// Maximum number of unchanged registers written between two changed ones, instead of starting a new transfer
+#define ISSI_PWM_MAX_GAP 2
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24] = {{0}, {0}};
 bool    g_led_control_registers_update_required   = false;
@@ -108,6 +113,45 @@ void IS31FL3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+// Writes the PWM registers changed since the last update, in transfers of up to 16 registers
+static void IS31FL3736_write_pwm_dirty(uint8_t addr, uint8_t index) {
+    // assumes PG1 is already selected
+    uint8_t *dirty = g_pwm_buffer_dirty[index];
+
+    for (uint8_t start = 0; start < 192; start++) {
+        if (dirty[start / 8] == 0) {
+            start |= 7;
+            continue;
+        }
+        if (!(dirty[start / 8] & (1 << (start % 8)))) {
+            continue;
+        }
+
+        // extend the transfer over the following changed registers
+        uint8_t end = start + 1;
+        for (uint8_t i = end; i < 192 && i < start + 16 && i <= end + ISSI_PWM_MAX_GAP; i++) {
+            if (dirty[i / 8] & (1 << (i % 8))) {
+                end = i + 1;
+            }
+        }
+
+        g_twi_transfer_buffer[0] = start;
+        for (uint8_t i = start; i < end; i++) {
+            g_twi_transfer_buffer[1 + i - start] = g_pwm_buffer[index][i];
+            dirty[i / 8] &= ~(1 << (i % 8));
+        }
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 1 + end - start, ISSI_TIMEOUT) == 0) break;
+        }
+#else
+        i2c_transmit(addr << 1, g_twi_transfer_buffer, 1 + end - start, ISSI_TIMEOUT);
+#endif
+        start = end - 1;
+    }
+}
+
 void IS31FL3736_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -149,14 +193,21 @@ void IS31FL3736_init(uint8_t addr) {
     wait_ms(10);
 }
 
+static inline void IS31FL3736_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty[driver][reg / 8] |= (1 << (reg % 8));
+        g_pwm_buffer_update_required = true;
+    }
+}
+
 void IS31FL3736_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         is31_led led = g_is31_leds[index];
 
-        g_pwm_buffer[led.driver][led.r] = red;
-        g_pwm_buffer[led.driver][led.g] = green;
-        g_pwm_buffer[led.driver][led.b] = blue;
-        g_pwm_buffer_update_required    = true;
+        IS31FL3736_set_pwm(led.driver, led.r, red);
+        IS31FL3736_set_pwm(led.driver, led.g, green);
+        IS31FL3736_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -213,9 +264,7 @@ void IS31FL3736_mono_set_brightness(int index, uint8_t value) {
     if (index >= 0 && index < 96) {
         // Index in range 0..95 -> A1..A8, B1..B8, etc.
         // Map index 0..95 to registers 0x00..0xBE (interleaved)
-        uint8_t pwm_register          = index * 2;
-        g_pwm_buffer[0][pwm_register] = value;
-        g_pwm_buffer_update_required  = true;
+        IS31FL3736_set_pwm(0, index * 2, value);
     }
 }
 
@@ -249,7 +298,7 @@ void IS31FL3736_update_pwm_buffers(uint8_t addr1, uint8_t addr2) {
         IS31FL3736_write_register(addr1, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
         IS31FL3736_write_register(addr1, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
-        IS31FL3736_write_pwm_buffer(addr1, g_pwm_buffer[0]);
+        IS31FL3736_write_pwm_dirty(addr1, 0);
         // IS31FL3736_write_pwm_buffer(addr2, g_pwm_buffer[1]);
     }
     g_pwm_buffer_update_required = false;
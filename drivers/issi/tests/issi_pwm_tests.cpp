@@ -0,0 +1,200 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "i2c_master.h"
+#if defined(IS31FL3731)
+#    include "is31fl3731.h"
+#elif defined(IS31FL3733)
+#    include "is31fl3733.h"
+#elif defined(IS31FL3736)
+#    include "is31fl3736.h"
+#elif defined(IS31FL3737)
+#    include "is31fl3737.h"
+#endif
+}
+
+// The same tests run against each driver, which only differ in where their PWM registers start and how they are flushed
+#if defined(IS31FL3731)
+#    define PWM_FIRST 0x24
+#    define PWM_COUNT 144
+#    define set_color IS31FL3731_set_color
+#    define update_pwm_buffers() IS31FL3731_update_pwm_buffers(kAddr, 0)
+#elif defined(IS31FL3733)
+#    define PWM_FIRST 0x00
+#    define PWM_COUNT 192
+#    define set_color IS31FL3733_set_color
+#    define update_pwm_buffers() IS31FL3733_update_pwm_buffers(kAddr, 0)
+#elif defined(IS31FL3736)
+#    define PWM_FIRST 0x00
+#    define PWM_COUNT 192
+#    define set_color IS31FL3736_set_color
+#    define update_pwm_buffers() IS31FL3736_update_pwm_buffers(kAddr, 0)
+#elif defined(IS31FL3737)
+#    define PWM_FIRST 0x00
+#    define PWM_COUNT 192
+#    define set_color IS31FL3737_set_color
+#    define update_pwm_buffers() IS31FL3737_update_pwm_buffers(kAddr, 0)
+#endif
+
+namespace {
+const uint8_t kAddr = 0x50;
+
+struct Transfer {
+    uint8_t reg;
+    uint8_t length;
+};
+
+// Register file of the driver chip, and the PWM register transfers it received
+uint8_t               device[256];
+std::vector<Transfer> transfers;
+bool                  connected = true;
+}  // namespace
+
+// Three consecutive PWM registers per LED
+#define LED(i) \
+    { 0, PWM_FIRST + 3 * (i), PWM_FIRST + 3 * (i) + 1, PWM_FIRST + 3 * (i) + 2 }
+#define LED10(i) LED(i), LED(i + 1), LED(i + 2), LED(i + 3), LED(i + 4), LED(i + 5), LED(i + 6), LED(i + 7), LED(i + 8), LED(i + 9)
+
+extern "C" {
+const is31_led g_is31_leds[DRIVER_LED_TOTAL] = {LED10(0), LED10(10), LED10(20), LED10(30)};
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    EXPECT_EQ(address, kAddr << 1);
+    if (!connected) {
+        return I2C_STATUS_TIMEOUT;
+    }
+    // the chip increments the register for every data byte after the first
+    memcpy(device + data[0], data + 1, length - 1);
+    if (data[0] >= PWM_FIRST && data[0] < PWM_FIRST + PWM_COUNT) {
+        transfers.push_back({data[0], (uint8_t)(length - 1)});
+    }
+    return I2C_STATUS_SUCCESS;
+}
+}
+
+class IssiPwm : public testing::Test {
+   public:
+    IssiPwm() {
+        // start from all LEDs off on both sides
+        connected = true;
+        for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+            set_color(i, 0, 0, 0);
+        }
+        update_pwm_buffers();
+        memset(device, 0, sizeof(device));
+        transfers.clear();
+    }
+
+    void expect_device_matches(const uint8_t colors[DRIVER_LED_TOTAL][3]) {
+        for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+            for (int c = 0; c < 3; c++) {
+                EXPECT_EQ(device[PWM_FIRST + 3 * i + c], colors[i][c]) << "LED " << i << " channel " << c;
+            }
+        }
+    }
+};
+
+TEST_F(IssiPwm, FirstFrameIsWrittenInBursts) {
+    uint8_t colors[DRIVER_LED_TOTAL][3];
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        colors[i][0] = i + 1;
+        colors[i][1] = i + 2;
+        colors[i][2] = i + 3;
+        set_color(i, colors[i][0], colors[i][1], colors[i][2]);
+    }
+    update_pwm_buffers();
+    // 120 registers in transfers of 16
+    EXPECT_EQ(transfers.size(), 8u);
+    expect_device_matches(colors);
+}
+
+TEST_F(IssiPwm, RepeatedFrameIsNotWritten) {
+    for (int frame = 0; frame < 3; frame++) {
+        transfers.clear();
+        for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+            set_color(i, 10, 20, 30);
+        }
+        update_pwm_buffers();
+    }
+    EXPECT_EQ(transfers.size(), 0u);
+}
+
+TEST_F(IssiPwm, ChangedLedIsWrittenAlone) {
+    set_color(5, 1, 2, 3);
+    update_pwm_buffers();
+    ASSERT_EQ(transfers.size(), 1u);
+    EXPECT_EQ(transfers[0].reg, PWM_FIRST + 15);
+    EXPECT_EQ(transfers[0].length, 3);
+}
+
+TEST_F(IssiPwm, SmallGapsAreWrittenOver) {
+    // red of LED 0 and LED 1 are two registers apart
+    set_color(0, 1, 0, 0);
+    set_color(1, 1, 0, 0);
+    update_pwm_buffers();
+    ASSERT_EQ(transfers.size(), 1u);
+    EXPECT_EQ(transfers[0].reg, PWM_FIRST);
+    EXPECT_EQ(transfers[0].length, 4);
+
+    // red of LED 2 and green of LED 3 are three apart
+    transfers.clear();
+    set_color(2, 1, 0, 0);
+    set_color(3, 0, 1, 0);
+    update_pwm_buffers();
+    ASSERT_EQ(transfers.size(), 2u);
+    EXPECT_EQ(transfers[0].reg, PWM_FIRST + 6);
+    EXPECT_EQ(transfers[0].length, 1);
+    EXPECT_EQ(transfers[1].reg, PWM_FIRST + 10);
+    EXPECT_EQ(transfers[1].length, 1);
+}
+
+TEST_F(IssiPwm, DeviceFollowsRandomChanges) {
+    uint8_t  colors[DRIVER_LED_TOTAL][3] = {{0}};
+    uint32_t state                       = 1;
+    for (int frame = 0; frame < 200; frame++) {
+        for (int n = 0; n < frame % 7; n++) {
+            state    = state * 1103515245 + 12345;
+            int  led = (state >> 16) % DRIVER_LED_TOTAL;
+            for (int c = 0; c < 3; c++) {
+                colors[led][c] = state >> (8 * c);
+            }
+            set_color(led, colors[led][0], colors[led][1], colors[led][2]);
+        }
+        update_pwm_buffers();
+        expect_device_matches(colors);
+    }
+}
+
+#if defined(IS31FL3733)
+TEST_F(IssiPwm, FailedTransfersAreRetried) {
+    uint8_t colors[DRIVER_LED_TOTAL][3] = {{0}};
+    colors[7][1]                        = 99;
+    set_color(7, 0, 99, 0);
+
+    connected = false;
+    update_pwm_buffers();
+    EXPECT_EQ(device[PWM_FIRST + 22], 0);
+
+    connected = true;
+    update_pwm_buffers();
+    expect_device_matches(colors);
+}
+#endif
@@ -0,0 +1,55 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+ISSI_TEST_SRC :=\
+	$(DRIVER_PATH)/issi/tests/issi_pwm_tests.cpp \
+	$(TMK_PATH)/common/test/timer.c
+
+ISSI_TEST_INC := $(DRIVER_PATH)/issi $(DRIVER_PATH)/avr
+
+ISSI_TEST_DEFS := -DDRIVER_COUNT=2 -DDRIVER_LED_TOTAL=40
+
+issi_is31fl3731_SRC :=\
+	$(ISSI_TEST_SRC) \
+	$(DRIVER_PATH)/issi/is31fl3731.c
+
+issi_is31fl3731_INC := $(ISSI_TEST_INC)
+
+issi_is31fl3731_DEFS := $(ISSI_TEST_DEFS) -DIS31FL3731
+
+issi_is31fl3733_SRC :=\
+	$(ISSI_TEST_SRC) \
+	$(DRIVER_PATH)/issi/is31fl3733.c
+
+issi_is31fl3733_INC := $(ISSI_TEST_INC)
+
+issi_is31fl3733_DEFS := $(ISSI_TEST_DEFS) -DIS31FL3733
+
+issi_is31fl3736_SRC :=\
+	$(ISSI_TEST_SRC) \
+	$(DRIVER_PATH)/issi/is31fl3736.c
+
+issi_is31fl3736_INC := $(ISSI_TEST_INC)
+
+issi_is31fl3736_DEFS := $(ISSI_TEST_DEFS) -DIS31FL3736
+
+issi_is31fl3737_SRC :=\
+	$(ISSI_TEST_SRC) \
+	$(DRIVER_PATH)/issi/is31fl3737.c
+
+issi_is31fl3737_INC := $(ISSI_TEST_INC)
+
+issi_is31fl3737_DEFS := $(ISSI_TEST_DEFS) -DIS31FL3737
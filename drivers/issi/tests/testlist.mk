@@ -0,0 +1,5 @@
+TEST_LIST +=\
+	issi_is31fl3731\
+	issi_is31fl3733\
+	issi_is31fl3736\
+	issi_is31fl3737
@@ -24,6 +24,10 @@
      qadd8( i, j) == MIN( (i + j), 0xFF )
      qsub8( i, j) == MAX( (i - j), 0 )
 
+   Four bytes packed into a uint32_t can be added
+   at once, one saturating add per byte lane.
+     qadd8x4( i, j)
+
  - Saturating signed 8-bit ("7-bit") add.
      qadd7( i, j) == MIN( (i + j), 0x7F)
 
@@ -32,6 +36,7 @@
    Scaledown value is specified in 1/256ths.
      scale8( i, sc) == (i * sc) / 256
      scale16by8( i, sc) == (i * sc) / 256
+     scale8x4( i, sc) == scale8 of each byte of i
 
    Example: scaling a 0-255 value down into a
    range from 0-99:
@@ -177,16 +182,22 @@ Lib8tion is pronounced like 'libation': lie-BAY-shun
 
 #if defined(__arm__)
 
-#if defined(FASTLED_TEENSY3)
+#if defined(FASTLED_TEENSY3) || defined(__ARM_FEATURE_DSP)
 // Can use Cortex M4 DSP instructions
 #define QADD8_C 0
 #define QADD7_C 0
+#define QADD8X4_C 0
+#define SCALE8X4_C 0
 #define QADD8_ARM_DSP_ASM 1
 #define QADD7_ARM_DSP_ASM 1
+#define QADD8X4_ARM_DSP_ASM 1
+#define SCALE8X4_ARM_DSP_ASM 1
 #else
 // Generic ARM
 #define QADD8_C 1
 #define QADD7_C 1
+#define QADD8X4_C 1
+#define SCALE8X4_C 1
 #endif
 
 #define QSUB8_C 1
@@ -221,6 +232,9 @@ Lib8tion is pronounced like 'libation': lie-BAY-shun
 #define AVG16_C 0
 #define AVG15_C 0
 
+#define QADD8X4_C 1
+#define SCALE8X4_C 1
+
 #define QADD8_AVRASM 1
 #define QADD7_AVRASM 1
 #define QSUB8_AVRASM 1
@@ -274,6 +288,8 @@ Lib8tion is pronounced like 'libation': lie-BAY-shun
 // no ASM, everything in C
 #define QADD8_C 1
 #define QADD7_C 1
+#define QADD8X4_C 1
+#define SCALE8X4_C 1
 #define QSUB8_C 1
 #define SCALE8_C 1
 #define SCALE16BY8_C 1
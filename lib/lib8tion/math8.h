@@ -83,6 +83,28 @@ LIB8STATIC_ALWAYS_INLINE int8_t qadd7( int8_t i, int8_t j)
 #endif
 }
 
+/// add four bytes packed into a uint32_t to four others,
+/// each byte lane saturating at 0xFF like qadd8
+/// @param i - first four bytes to add
+/// @param j - second four bytes to add
+/// @returns the lane by lane sums of i & j, each capped at 0xFF
+LIB8STATIC_ALWAYS_INLINE uint32_t qadd8x4( uint32_t i, uint32_t j)
+{
+#if QADD8X4_C == 1
+    // Add the low seven bits of each lane so nothing carries across lanes,
+    // then work out the top bit and the carry out of each lane by hand.
+    uint32_t low   = (i & 0x7F7F7F7F) + (j & 0x7F7F7F7F);
+    uint32_t sum   = low ^ ((i ^ j) & 0x80808080);
+    uint32_t carry = ((i & j) | ((i ^ j) & low)) & 0x80808080;
+    return sum | ((carry >> 7) * 0xFF);
+#elif QADD8X4_ARM_DSP_ASM == 1
+    asm( "uqadd8 %0, %0, %1" : "+r" (i) : "r" (j));
+    return i;
+#else
+#error "No implementation for qadd8x4 available."
+#endif
+}
+
 /// subtract one byte from another, saturating at 0x00
 /// @returns i - j with a floor of 0
 LIB8STATIC_ALWAYS_INLINE uint8_t qsub8( uint8_t i, uint8_t j)
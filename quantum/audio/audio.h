@@ -83,6 +83,8 @@ void increase_tempo(uint8_t tempo_change);
 void decrease_tempo(uint8_t tempo_change);
 
 void audio_init(void);
+// Keeps streaming drivers supplied with samples, called from the main loop
+void audio_task(void);
 
 #ifdef PWM_AUDIO
 void play_sample(uint8_t* s, uint16_t l, bool r);
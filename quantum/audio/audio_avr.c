@@ -228,6 +228,9 @@ void audio_init() {
     }
 }
 
+// Notes are played straight from the timer interrupts, there is nothing to do here
+void audio_task(void) {}
+
 void stop_all_notes() {
     dprintf("audio stop all notes");
 
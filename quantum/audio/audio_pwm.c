@@ -155,6 +155,9 @@ void audio_init() {
     audio_initialized = true;
 }
 
+// Notes are played straight from the timer interrupts, there is nothing to do here
+void audio_task(void) {}
+
 void stop_all_notes() {
     if (!audio_initialized) {
         audio_init();
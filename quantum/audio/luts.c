@@ -25,3 +25,24 @@ const uint16_t frequency_lut[FREQUENCY_LUT_LENGTH] = {
     0x1A38, 0x19D8, 0x1979, 0x191C, 0x18C0, 0x1865, 0x180B, 0x17B3, 0x175C, 0x1706, 0x16B2, 0x165E, 0x160C, 0x15BB, 0x156C, 0x151D, 0x14CF, 0x1483, 0x1438, 0x13EE, 0x13A4, 0x135C, 0x1315, 0x12CF, 0x128A, 0x1246, 0x1203, 0x11C1, 0x1180, 0x1140, 0x1100, 0x10C2, 0x1084, 0x1048, 0x100C, 0xFD1,  0xF97,  0xF5E,  0xF25,  0xEEE,  0xEB7,  0xE81,  0xE4C,  0xE17,  0xDE4,  0xDB1,  0xD7E,  0xD4D,  0xD1C,  0xCEC,  0xCBC,  0xC8E,  0xC60,  0xC32,  0xC05,  0xBD9,  0xBAE,  0xB83,  0xB59,  0xB2F,  0xB06,  0xADD,  0xAB6,  0xA8E,  0xA67,  0xA41,  0xA1C,  0x9F7,  0x9D2,  0x9AE,  0x98A,  0x967,  0x945,  0x923,  0x901,  0x8E0,  0x8C0,  0x8A0,  0x880,  0x861,  0x842,  0x824,  0x806,  0x7E8,  0x7CB,  0x7AF,  0x792,  0x777,  0x75B,  0x740,  0x726,  0x70B,  0x6F2,  0x6D8,  0x6BF,  0x6A6,  0x68E,  0x676,  0x65E,  0x647,  0x630,  0x619,  0x602,  0x5EC,  0x5D7,  0x5C1,  0x5AC,  0x597,  0x583,  0x56E,  0x55B,  0x547,  0x533,  0x520,  0x50E,  0x4FB,  0x4E9,
     0x4D7,  0x4C5,  0x4B3,  0x4A2,  0x491,  0x480,  0x470,  0x460,  0x450,  0x440,  0x430,  0x421,  0x412,  0x403,  0x3F4,  0x3E5,  0x3D7,  0x3C9,  0x3BB,  0x3AD,  0x3A0,  0x393,  0x385,  0x379,  0x36C,  0x35F,  0x353,  0x347,  0x33B,  0x32F,  0x323,  0x318,  0x30C,  0x301,  0x2F6,  0x2EB,  0x2E0,  0x2D6,  0x2CB,  0x2C1,  0x2B7,  0x2AD,  0x2A3,  0x299,  0x290,  0x287,  0x27D,  0x274,  0x26B,  0x262,  0x259,  0x251,  0x248,  0x240,  0x238,  0x230,  0x228,  0x220,  0x218,  0x210,  0x209,  0x201,  0x1FA,  0x1F2,  0x1EB,  0x1E4,  0x1DD,  0x1D6,  0x1D0,  0x1C9,  0x1C2,  0x1BC,  0x1B6,  0x1AF,  0x1A9,  0x1A3,  0x19D,  0x197,  0x191,  0x18C,  0x186,  0x180,  0x17B,  0x175,  0x170,  0x16B,  0x165,  0x160,  0x15B,  0x156,  0x151,  0x14C,  0x148,  0x143,  0x13E,  0x13A,  0x135,  0x131,  0x12C,  0x128,  0x124,  0x120,  0x11C,  0x118,  0x114,  0x110,  0x10C,  0x108,  0x104,  0x100,  0xFD,   0xF9,   0xF5,   0xF2,   0xEE,
 };
+
+// vibrato_lut as offsets in 1/256ths of a semitone
+const int8_t vibrato_pitch_lut[VIBRATO_LUT_LENGTH] = {
+    10, 19, 26, 30, 32, 30, 26, 19, 10, 0, -10, -19, -26, -30, -32, -30, -26, -19, -10, 0,
+};
+
+// 2^(i / PITCH_LUT_LENGTH) scaled by 0x8000, one entry per 1/16th of a semitone across an octave
+const uint16_t pitch_lut[PITCH_LUT_LENGTH] = {
+    0x8000, 0x8077, 0x80ED, 0x8165, 0x81DD, 0x8255, 0x82CE, 0x8347, 0x83C0, 0x843A, 0x84B5, 0x852F, 0x85AB, 0x8627, 0x86A3, 0x871F,
+    0x879C, 0x881A, 0x8898, 0x8917, 0x8995, 0x8A15, 0x8A95, 0x8B15, 0x8B96, 0x8C17, 0x8C99, 0x8D1B, 0x8D9E, 0x8E21, 0x8EA4, 0x8F28,
+    0x8FAD, 0x9032, 0x90B7, 0x913D, 0x91C4, 0x924B, 0x92D2, 0x935A, 0x93E3, 0x946C, 0x94F5, 0x957F, 0x9609, 0x9694, 0x9720, 0x97AC,
+    0x9838, 0x98C5, 0x9952, 0x99E0, 0x9A6F, 0x9AFE, 0x9B8D, 0x9C1D, 0x9CAE, 0x9D3F, 0x9DD0, 0x9E63, 0x9EF5, 0x9F88, 0xA01C, 0xA0B0,
+    0xA145, 0xA1DA, 0xA270, 0xA307, 0xA39E, 0xA435, 0xA4CD, 0xA566, 0xA5FF, 0xA699, 0xA733, 0xA7CE, 0xA869, 0xA905, 0xA9A1, 0xAA3E,
+    0xAADC, 0xAB7A, 0xAC19, 0xACB8, 0xAD58, 0xADF9, 0xAE9A, 0xAF3B, 0xAFDE, 0xB081, 0xB124, 0xB1C8, 0xB26D, 0xB312, 0xB3B8, 0xB45E,
+    0xB505, 0xB5AD, 0xB655, 0xB6FE, 0xB7A7, 0xB851, 0xB8FC, 0xB9A7, 0xBA53, 0xBAFF, 0xBBAC, 0xBC5A, 0xBD09, 0xBDB8, 0xBE67, 0xBF18,
+    0xBFC9, 0xC07A, 0xC12C, 0xC1DF, 0xC293, 0xC347, 0xC3FC, 0xC4B1, 0xC567, 0xC61E, 0xC6D5, 0xC78D, 0xC846, 0xC900, 0xC9BA, 0xCA75,
+    0xCB30, 0xCBEC, 0xCCA9, 0xCD66, 0xCE25, 0xCEE3, 0xCFA3, 0xD063, 0xD124, 0xD1E6, 0xD2A8, 0xD36B, 0xD42F, 0xD4F3, 0xD5B9, 0xD67E,
+    0xD745, 0xD80C, 0xD8D4, 0xD99D, 0xDA67, 0xDB31, 0xDBFC, 0xDCC7, 0xDD94, 0xDE61, 0xDF2F, 0xDFFD, 0xE0CD, 0xE19D, 0xE26E, 0xE340,
+    0xE412, 0xE4E5, 0xE5B9, 0xE68E, 0xE763, 0xE839, 0xE910, 0xE9E8, 0xEAC1, 0xEB9A, 0xEC74, 0xED4F, 0xEE2B, 0xEF07, 0xEFE5, 0xF0C3,
+    0xF1A2, 0xF281, 0xF362, 0xF443, 0xF525, 0xF608, 0xF6EC, 0xF7D1, 0xF8B6, 0xF99D, 0xFA84, 0xFB6C, 0xFC54, 0xFD3E, 0xFE29, 0xFF14,
+};
@@ -18,9 +18,11 @@
 #    include <avr/io.h>
 #    include <avr/interrupt.h>
 #    include <avr/pgmspace.h>
-#else
+#elif defined(PROTOCOL_CHIBIOS)
 #    include "ch.h"
 #    include "hal.h"
+#else
+#    include <stdint.h>
 #endif
 
 #ifndef LUTS_H
@@ -30,7 +32,11 @@
 
 #    define FREQUENCY_LUT_LENGTH 349
 
+#    define PITCH_LUT_LENGTH 192
+
 extern const float    vibrato_lut[VIBRATO_LUT_LENGTH];
+extern const int8_t   vibrato_pitch_lut[VIBRATO_LUT_LENGTH];
 extern const uint16_t frequency_lut[FREQUENCY_LUT_LENGTH];
+extern const uint16_t pitch_lut[PITCH_LUT_LENGTH];
 
 #endif /* LUTS_H */
@@ -0,0 +1,654 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "audio.h"
+#include "synth.h"
+#include "print.h"
+#include "eeconfig.h"
+#include "wave.h"
+
+// Envelopes, glides, vibrato and songs advance once per control tick
+#define AUDIO_SYNTH_CONTROL_RATE 1000
+#define AUDIO_SYNTH_CONTROL_SAMPLES (AUDIO_SAMPLE_RATE / AUDIO_SYNTH_CONTROL_RATE)
+
+#if AUDIO_SAMPLE_RATE % AUDIO_SYNTH_CONTROL_RATE != 0 || AUDIO_SAMPLE_RATE / AUDIO_SYNTH_CONTROL_RATE > 255
+#    error "AUDIO_SAMPLE_RATE must be a multiple of 1000 no larger than 255000"
+#endif
+
+#if AUDIO_OSCILLATORS < 1 || AUDIO_OSCILLATORS > 8
+#    error "AUDIO_OSCILLATORS must be between 1 and 8"
+#endif
+
+#if (AUDIO_SYNTH_BUFFER_SIZE & (AUDIO_SYNTH_BUFFER_SIZE - 1)) != 0 || AUDIO_SYNTH_BUFFER_SIZE > 32768
+#    error "AUDIO_SYNTH_BUFFER_SIZE must be a power of two no larger than 32768"
+#endif
+
+#if SINE_LENGTH != 2048
+#    error "audio_synth_sine() expects an 11 bit wave table"
+#endif
+
+#define AUDIO_SYNTH_OCTAVE (12 * AUDIO_SYNTH_SEMITONE)
+// How far below A4 the pitch conversions reach, in octaves
+#define AUDIO_SYNTH_OCTAVES_DOWN 8
+#define AUDIO_SYNTH_PITCH_MIN (-AUDIO_SYNTH_OCTAVES_DOWN * AUDIO_SYNTH_OCTAVE)
+#define AUDIO_SYNTH_A4_INCREMENT ((uint32_t)(440ULL * (1ULL << 32) / AUDIO_SAMPLE_RATE))
+// Glides move 220 semitones a second whatever the pitch
+#define AUDIO_SYNTH_GLISSANDO_STEP (220 * AUDIO_SYNTH_SEMITONE / AUDIO_SYNTH_CONTROL_RATE)
+// Anything lower is a rest, NOTE_REST is 1 Hz on ARM
+#define AUDIO_SYNTH_FREQ_MIN 20.0f
+// Gap after each note of a song, only silent between two notes of the same pitch
+#define AUDIO_SYNTH_REST_TICKS 5
+// Length of one unit of song note duration at tempo 100, as on AVR
+#define AUDIO_SYNTH_NOTE_UNIT_US 8192
+// Peak of a single oscillator, two of them together stay clear of clipping
+#define AUDIO_SYNTH_AMPLITUDE 16383
+#define AUDIO_SYNTH_RING_AT(i) (ring[(i) & (AUDIO_SYNTH_BUFFER_SIZE - 1)])
+
+typedef struct {
+    float    frequency;  // what the oscillator was asked to play
+    int16_t  target;     // pitch of frequency
+    int16_t  pitch;      // trails target while gliding
+    int16_t  output;     // pitch that increment was worked out for
+    uint32_t increment;
+    uint32_t phase;
+    bool     sounding;
+} audio_synth_osc_t;
+
+static audio_synth_osc_t  oscs[AUDIO_OSCILLATORS];
+static audio_synth_osc_t *mixed[AUDIO_OSCILLATORS];
+static uint8_t            mixed_count       = 0;
+// Applied to the sum of the oscillators in 1/256ths, so that more than two of them do not clip
+static uint16_t           mix_gain          = 256;
+static audio_waveform_t   waveform          = AUDIO_WAVEFORM_DEFAULT;
+static uint32_t           duty              = 0x80000000;
+static float              duty_timbre       = TIMBRE_50;
+static uint8_t            control_countdown = 0;
+
+static int16_t  ring[AUDIO_SYNTH_BUFFER_SIZE];
+static uint16_t ring_head = 0;
+static uint16_t ring_tail = 0;
+
+static int   voices         = 0;
+static int   voice_place    = 0;
+static float frequencies[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+static bool     playing_notes  = false;
+static bool     playing_note   = false;
+static float    note_frequency = 0;
+static uint16_t note_ticks     = 0;
+static uint8_t  note_tempo     = TEMPO_DEFAULT;
+float           note_timbre    = TIMBRE_DEFAULT;
+static float (*notes_pointer)[][2];
+static uint16_t notes_count;
+static bool     notes_repeat;
+static bool     note_resting = false;
+static uint16_t current_note = 0;
+
+#ifdef VIBRATO_ENABLE
+// Position in vibrato_pitch_lut and the rest in 1/256ths
+static uint16_t vibrato_counter  = 0;
+static uint16_t vibrato_strength = 128;
+static uint16_t vibrato_rate     = 32;
+static int16_t  vibrato_offset   = 0;
+#endif
+
+float           polyphony_rate        = 0;
+static float    polyphony_period_rate = 0;
+static uint16_t polyphony_period      = 0;
+static uint16_t polyphony_place       = 0;
+
+static bool audio_initialized = false;
+
+audio_config_t audio_config;
+
+uint16_t        envelope_index    = 0;
+static uint16_t envelope_fraction = 0;
+bool            glissando         = true;
+
+#ifndef STARTUP_SONG
+#    define STARTUP_SONG SONG(STARTUP_SOUND)
+#endif
+float startup_song[][2] = STARTUP_SONG;
+
+/** \brief Converts a frequency to 1/256ths of a semitone from A4
+ *
+ * A binary search of pitch_lut, only done when a note changes.
+ */
+int16_t audio_synth_freq_to_pitch(float freq) {
+    // ratio to A4 AUDIO_SYNTH_OCTAVES_DOWN octaves down, 0x8000 being 1
+    uint32_t ratio = (uint32_t)(freq * (32768.0f * (1 << AUDIO_SYNTH_OCTAVES_DOWN) / 440.0f));
+    if (ratio < 0x8000) {
+        return AUDIO_SYNTH_PITCH_MIN;
+    }
+    int16_t pitch = AUDIO_SYNTH_PITCH_MIN;
+    while (ratio >= 0x10000) {
+        ratio >>= 1;
+        pitch += AUDIO_SYNTH_OCTAVE;
+    }
+
+    uint8_t low = 0, high = PITCH_LUT_LENGTH;
+    while (high - low > 1) {
+        uint8_t mid = (low + high) / 2;
+        if (pitch_lut[mid] <= ratio) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    uint32_t next = high < PITCH_LUT_LENGTH ? pitch_lut[high] : 0x10000;
+    pitch += low * (AUDIO_SYNTH_OCTAVE / PITCH_LUT_LENGTH);
+    pitch += (ratio - pitch_lut[low]) * (AUDIO_SYNTH_OCTAVE / PITCH_LUT_LENGTH) / (next - pitch_lut[low]);
+    return pitch;
+}
+
+/** \brief Converts a pitch to the amount added to an oscillator's phase each sample
+ *
+ * Interpolates between the pitch_lut entries either side of it.
+ */
+uint32_t audio_synth_pitch_to_increment(int16_t pitch) {
+    if (pitch < AUDIO_SYNTH_PITCH_MIN) {
+        pitch = AUDIO_SYNTH_PITCH_MIN;
+    }
+    uint16_t offset = pitch - AUDIO_SYNTH_PITCH_MIN;
+    uint8_t  octave = offset / AUDIO_SYNTH_OCTAVE;
+    uint16_t step   = offset % AUDIO_SYNTH_OCTAVE;
+    uint8_t  index  = step / (AUDIO_SYNTH_OCTAVE / PITCH_LUT_LENGTH);
+    uint8_t  frac   = step % (AUDIO_SYNTH_OCTAVE / PITCH_LUT_LENGTH);
+
+    uint32_t next  = index + 1 < PITCH_LUT_LENGTH ? pitch_lut[index + 1] : 0x10000;
+    uint32_t ratio = pitch_lut[index] + (next - pitch_lut[index]) * frac / (AUDIO_SYNTH_OCTAVE / PITCH_LUT_LENGTH);
+
+    uint64_t increment = ((uint64_t)AUDIO_SYNTH_A4_INCREMENT * ratio) >> (15 + AUDIO_SYNTH_OCTAVES_DOWN - octave);
+    // anything past half the sample rate is noise anyway
+    return increment > 0x80000000 ? 0x80000000 : increment;
+}
+
+static void audio_synth_silence(audio_synth_osc_t *osc) {
+    osc->sounding  = false;
+    osc->frequency = 0;
+}
+
+/** \brief Moves an oscillator on by one control tick
+ *
+ * Glides towards freq when glide is set, then applies vibrato and the voice
+ * envelope. The phase increment is only worked out again when the resulting
+ * pitch has changed.
+ */
+static void audio_synth_osc_update(audio_synth_osc_t *osc, float freq, bool glide) {
+    if (freq < AUDIO_SYNTH_FREQ_MIN) {
+        audio_synth_silence(osc);
+        return;
+    }
+    if (freq != osc->frequency) {
+        osc->frequency = freq;
+        osc->target    = audio_synth_freq_to_pitch(freq);
+    }
+    if (!glide || !osc->sounding) {
+        osc->pitch = osc->target;
+    } else if (osc->pitch < osc->target - AUDIO_SYNTH_GLISSANDO_STEP) {
+        osc->pitch += AUDIO_SYNTH_GLISSANDO_STEP;
+    } else if (osc->pitch > osc->target + AUDIO_SYNTH_GLISSANDO_STEP) {
+        osc->pitch -= AUDIO_SYNTH_GLISSANDO_STEP;
+    } else {
+        osc->pitch = osc->target;
+    }
+
+    int16_t pitch = osc->pitch;
+#ifdef VIBRATO_ENABLE
+    pitch += vibrato_offset;
+#endif
+
+    float enveloped = voice_envelope(freq);
+    if (enveloped != freq) {
+        if (enveloped < AUDIO_SYNTH_FREQ_MIN) {
+            osc->sounding = false;
+            return;
+        }
+        pitch += audio_synth_freq_to_pitch(enveloped) - osc->target;
+    }
+
+    if (!osc->sounding) {
+        osc->phase = 0;
+    }
+    if (!osc->sounding || pitch != osc->output) {
+        osc->output    = pitch;
+        osc->increment = audio_synth_pitch_to_increment(pitch);
+        osc->sounding  = true;
+    }
+}
+
+#ifdef VIBRATO_ENABLE
+
+// Sweeps the vibrato table faster for higher notes, like the timer driven drivers do
+static void audio_synth_vibrato_advance(uint32_t increment) {
+    uint32_t hz = ((uint64_t)increment * AUDIO_SAMPLE_RATE) >> 32;
+    vibrato_counter += (uint32_t)vibrato_rate * (hz + 440) / AUDIO_SYNTH_CONTROL_RATE;
+    vibrato_counter %= VIBRATO_LUT_LENGTH * 256;
+
+#    ifdef VIBRATO_STRENGTH_ENABLE
+    vibrato_offset = vibrato_pitch_lut[vibrato_counter >> 8] * vibrato_strength / 256;
+#    else
+    vibrato_offset = vibrato_strength ? vibrato_pitch_lut[vibrato_counter >> 8] : 0;
+#    endif
+}
+
+#endif
+
+// envelope_index counts periods of the note, which voice_envelope() scales back to time
+static void audio_synth_envelope_advance(uint32_t increment) {
+    uint32_t periods  = envelope_fraction + (increment >> 16) * AUDIO_SYNTH_CONTROL_SAMPLES;
+    envelope_fraction = periods & 0xFFFF;
+    periods           = envelope_index + (periods >> 16);
+    envelope_index    = periods > 0xFFFF ? 0xFFFF : periods;
+}
+
+static void audio_synth_song_load(void) {
+    envelope_index = 0;
+    note_frequency = (*notes_pointer)[current_note][0];
+    // tempo 100 is the default, higher values are slower
+    uint32_t ticks = (uint32_t)(*notes_pointer)[current_note][1] * note_tempo * AUDIO_SYNTH_NOTE_UNIT_US / (100UL * 1000000UL / AUDIO_SYNTH_CONTROL_RATE);
+    note_ticks     = ticks > 0xFFFF ? 0xFFFF : ticks ? ticks : 1;
+}
+
+static void audio_synth_song_advance(void) {
+    if (--note_ticks) {
+        return;
+    }
+    if (!note_resting) {
+        uint16_t next = current_note + 1;
+        if (next >= notes_count) {
+            if (!notes_repeat) {
+                playing_notes = false;
+                return;
+            }
+            next = 0;
+        }
+        note_resting = true;
+        if ((*notes_pointer)[next][0] == note_frequency) {
+            note_frequency = 0;
+        }
+        note_ticks = AUDIO_SYNTH_REST_TICKS;
+    } else {
+        note_resting = false;
+        current_note = current_note + 1 < notes_count ? current_note + 1 : 0;
+        audio_synth_song_load();
+    }
+}
+
+static void audio_synth_control(void) {
+    audio_synth_osc_t *lead = &oscs[0];
+
+    if (!audio_config.enable) {
+        playing_notes = false;
+        playing_note  = false;
+    }
+
+    audio_synth_envelope_advance(lead->increment);
+
+    if (playing_note && voices > 1 && polyphony_rate > 0) {
+        // arpeggiate over the held notes polyphony_rate times a second
+        if (polyphony_rate != polyphony_period_rate) {
+            polyphony_period_rate = polyphony_rate;
+            polyphony_period      = AUDIO_SYNTH_CONTROL_RATE / polyphony_rate;
+        }
+        voice_place %= voices;
+        if (++polyphony_place > polyphony_period) {
+            voice_place     = (voice_place + 1) % voices;
+            polyphony_place = 0;
+        }
+        audio_synth_osc_update(lead, frequencies[voice_place], false);
+        for (uint8_t i = 1; i < AUDIO_OSCILLATORS; i++) {
+            audio_synth_silence(&oscs[i]);
+        }
+    } else if (playing_note && voices > 0) {
+        // the newest notes take the oscillators, the first of them sets the envelope
+        for (uint8_t i = 0; i < AUDIO_OSCILLATORS; i++) {
+            if (i < voices) {
+                audio_synth_osc_update(&oscs[i], frequencies[voices - 1 - i], glissando);
+            } else {
+                audio_synth_silence(&oscs[i]);
+            }
+        }
+    } else if (playing_notes) {
+        audio_synth_osc_update(lead, note_frequency, false);
+        for (uint8_t i = 1; i < AUDIO_OSCILLATORS; i++) {
+            audio_synth_silence(&oscs[i]);
+        }
+        audio_synth_song_advance();
+    } else {
+        for (uint8_t i = 0; i < AUDIO_OSCILLATORS; i++) {
+            audio_synth_silence(&oscs[i]);
+        }
+    }
+
+    mixed_count = 0;
+    for (uint8_t i = 0; i < AUDIO_OSCILLATORS; i++) {
+        if (oscs[i].sounding) {
+            mixed[mixed_count++] = &oscs[i];
+        }
+    }
+    mix_gain = mixed_count > 2 ? 512 / mixed_count : 256;
+
+#ifdef VIBRATO_ENABLE
+    audio_synth_vibrato_advance(lead->increment);
+#endif
+
+    if (note_timbre != duty_timbre) {
+        duty_timbre = note_timbre;
+        duty        = note_timbre >= 1.0f ? 0xFFFFFFFF : (uint32_t)(note_timbre * 65536.0f) << 16;
+    }
+}
+
+static inline int16_t audio_synth_square(uint32_t phase) { return phase < duty ? AUDIO_SYNTH_AMPLITUDE : -AUDIO_SYNTH_AMPLITUDE; }
+
+static inline int16_t audio_synth_triangle(uint32_t phase) {
+    // fold the top half of the phase back down, then centre it on zero
+    uint16_t rise = phase >> 16;
+    if (rise & 0x8000) {
+        rise = ~rise;
+    }
+    return ((int32_t)rise * 2 - 0x7FFF) * AUDIO_SYNTH_AMPLITUDE / 0x8000;
+}
+
+static inline int16_t audio_synth_sine(uint32_t phase) { return ((int16_t)pgm_read_byte(&sinewave[phase >> 21]) - 0x80) * (AUDIO_SYNTH_AMPLITUDE >> 7); }
+
+/** \brief Mixes n samples of the sounding oscillators
+ *
+ * One loop per waveform so that the choice is made once per control tick
+ * rather than once per sample and oscillator.
+ */
+static void audio_synth_mix(int16_t *buffer, uint8_t n) {
+    if (!mixed_count) {
+        memset(buffer, 0, n * sizeof(*buffer));
+        return;
+    }
+    for (; n; n--) {
+        int32_t sum = 0;
+        switch (waveform) {
+            case AUDIO_WAVEFORM_SQUARE:
+                for (uint8_t i = 0; i < mixed_count; i++) {
+                    sum += audio_synth_square(mixed[i]->phase += mixed[i]->increment);
+                }
+                break;
+            case AUDIO_WAVEFORM_TRIANGLE:
+                for (uint8_t i = 0; i < mixed_count; i++) {
+                    sum += audio_synth_triangle(mixed[i]->phase += mixed[i]->increment);
+                }
+                break;
+            case AUDIO_WAVEFORM_SINE:
+                for (uint8_t i = 0; i < mixed_count; i++) {
+                    sum += audio_synth_sine(mixed[i]->phase += mixed[i]->increment);
+                }
+                break;
+        }
+        *buffer++ = sum * mix_gain / 256;
+    }
+}
+
+void audio_synth_render(int16_t *buffer, uint16_t count) {
+    while (count) {
+        if (!control_countdown) {
+            audio_synth_control();
+            control_countdown = AUDIO_SYNTH_CONTROL_SAMPLES;
+        }
+        uint8_t n = count < control_countdown ? count : control_countdown;
+        audio_synth_mix(buffer, n);
+        control_countdown -= n;
+        buffer += n;
+        count -= n;
+    }
+}
+
+static uint16_t audio_synth_ring_depth(void) { return ring_head - ring_tail; }
+
+// Renders straight into the ring, in at most two pieces where it wraps
+static void audio_synth_ring_fill(uint16_t count) {
+    while (count) {
+        uint16_t at = ring_head & (AUDIO_SYNTH_BUFFER_SIZE - 1);
+        uint16_t n  = AUDIO_SYNTH_BUFFER_SIZE - at < count ? AUDIO_SYNTH_BUFFER_SIZE - at : count;
+        audio_synth_render(&ring[at], n);
+        ring_head += n;
+        count -= n;
+    }
+}
+
+void audio_synth_task(void) {
+    if (AUDIO_SYNTH_BUFFER_SIZE - audio_synth_ring_depth() >= AUDIO_SYNTH_CHUNK_SIZE) {
+        audio_synth_ring_fill(AUDIO_SYNTH_CHUNK_SIZE);
+    }
+}
+
+void audio_synth_read(int16_t *buffer, uint16_t count) {
+    while (count) {
+        uint16_t depth = audio_synth_ring_depth();
+        if (!depth) {
+            // nothing rendered ahead, skip the ring altogether
+            audio_synth_render(buffer, count);
+            return;
+        }
+        uint16_t n = depth < count ? depth : count;
+        for (uint16_t i = 0; i < n; i++) {
+            *buffer++ = AUDIO_SYNTH_RING_AT(ring_tail);
+            ring_tail++;
+        }
+        count -= n;
+    }
+}
+
+bool audio_synth_is_active(void) { return playing_note || playing_notes || mixed_count || audio_synth_ring_depth(); }
+
+void audio_synth_set_waveform(audio_waveform_t new_waveform) { waveform = new_waveform; }
+
+audio_waveform_t audio_synth_get_waveform(void) { return waveform; }
+
+void audio_init() {
+    if (audio_initialized) {
+        return;
+    }
+
+// Check EEPROM
+#ifdef EEPROM_ENABLE
+    if (!eeconfig_is_enabled()) {
+        eeconfig_init();
+    }
+    audio_config.raw = eeconfig_read_audio();
+#else  // ARM EEPROM
+    audio_config.enable        = true;
+#    ifdef AUDIO_CLICKY_ON
+    audio_config.clicky_enable = true;
+#    endif
+#endif  // ARM EEPROM
+
+    audio_driver_initialize();
+
+    audio_initialized = true;
+
+    if (audio_config.enable) {
+        PLAY_SONG(startup_song);
+    } else {
+        stop_all_notes();
+    }
+}
+
+void stop_all_notes() {
+    dprintf("audio stop all notes");
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+    voices = 0;
+
+    playing_notes = false;
+    playing_note  = false;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        frequencies[i] = 0;
+    }
+}
+
+void stop_note(float freq) {
+    dprintf("audio stop note freq=%d", (int)freq);
+
+    if (playing_note) {
+        if (!audio_initialized) {
+            audio_init();
+        }
+        for (int i = 7; i >= 0; i--) {
+            if (frequencies[i] == freq) {
+                frequencies[i] = 0;
+                for (int j = i; (j < 7); j++) {
+                    frequencies[j]     = frequencies[j + 1];
+                    frequencies[j + 1] = 0;
+                }
+                break;
+            }
+        }
+        voices--;
+        if (voices < 0) {
+            voices = 0;
+        }
+        if (voice_place >= voices) {
+            voice_place = 0;
+        }
+        if (voices == 0) {
+            playing_note = false;
+        }
+    }
+}
+
+void play_note(float freq, int vol) {
+    dprintf("audio play note freq=%d vol=%d", (int)freq, vol);
+
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable && voices < 8) {
+        // Cancel notes if notes are playing
+        if (playing_notes) {
+            stop_all_notes();
+        }
+
+        playing_note = true;
+
+        envelope_index = 0;
+
+        if (freq > 0) {
+            frequencies[voices] = freq;
+            voices++;
+        }
+    }
+}
+
+void play_notes(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+    if (!audio_initialized) {
+        audio_init();
+    }
+
+    if (audio_config.enable) {
+        // Cancel note if a note is playing
+        if (playing_note) {
+            stop_all_notes();
+        }
+
+        playing_notes = true;
+
+        notes_pointer = np;
+        notes_count   = n_count;
+        notes_repeat  = n_repeat;
+
+        current_note = 0;
+        note_resting = false;
+        audio_synth_song_load();
+    }
+}
+
+bool is_playing_notes(void) { return playing_notes; }
+
+bool is_audio_on(void) { return (audio_config.enable != 0); }
+
+void audio_toggle(void) {
+    audio_config.enable ^= 1;
+    eeconfig_update_audio(audio_config.raw);
+    if (audio_config.enable) {
+        audio_on_user();
+    }
+}
+
+void audio_on(void) {
+    audio_config.enable = 1;
+    eeconfig_update_audio(audio_config.raw);
+    audio_on_user();
+}
+
+void audio_off(void) {
+    stop_all_notes();
+    audio_config.enable = 0;
+    eeconfig_update_audio(audio_config.raw);
+}
+
+#ifdef VIBRATO_ENABLE
+
+// Vibrato rate functions
+
+void set_vibrato_rate(float rate) { vibrato_rate = rate * 256; }
+
+void increase_vibrato_rate(float change) { vibrato_rate *= change; }
+
+void decrease_vibrato_rate(float change) { vibrato_rate /= change; }
+
+#    ifdef VIBRATO_STRENGTH_ENABLE
+
+void set_vibrato_strength(float strength) { vibrato_strength = strength * 256; }
+
+void increase_vibrato_strength(float change) { vibrato_strength *= change; }
+
+void decrease_vibrato_strength(float change) { vibrato_strength /= change; }
+
+#    endif /* VIBRATO_STRENGTH_ENABLE */
+
+#endif /* VIBRATO_ENABLE */
+
+// Polyphony functions
+
+void set_polyphony_rate(float rate) { polyphony_rate = rate; }
+
+void enable_polyphony() { polyphony_rate = 5; }
+
+void disable_polyphony() { polyphony_rate = 0; }
+
+void increase_polyphony_rate(float change) { polyphony_rate *= change; }
+
+void decrease_polyphony_rate(float change) { polyphony_rate /= change; }
+
+// Timbre function
+
+void set_timbre(float timbre) { note_timbre = timbre; }
+
+// Tempo functions
+
+void set_tempo(uint8_t tempo) { note_tempo = tempo; }
+
+void decrease_tempo(uint8_t tempo_change) { note_tempo += tempo_change; }
+
+void increase_tempo(uint8_t tempo_change) {
+    if (note_tempo - tempo_change < 10) {
+        note_tempo = 10;
+    } else {
+        note_tempo -= tempo_change;
+    }
+}
@@ -0,0 +1,89 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Fixed point note synthesizer.
+ *
+ * Implements the audio.h API for drivers that stream samples rather than
+ * retune a timer per note. Each oscillator is a 32 bit phase accumulator whose
+ * increment comes from a pitch held in 1/256ths of a semitone, so glissando
+ * and vibrato are additions and the only table lookups happen once per
+ * control tick. Envelopes, glides, vibrato and songs advance once per
+ * millisecond of output, from whatever calls audio_synth_render(), never from
+ * an interrupt.
+ *
+ * The newest AUDIO_OSCILLATORS held notes each get an oscillator and are
+ * mixed together. audio_synth_task() renders ahead into a ring buffer a chunk
+ * at a time from the main loop and drivers take samples out of it with
+ * audio_synth_read().
+ */
+
+// Samples per second handed to the driver
+#ifndef AUDIO_SAMPLE_RATE
+#    define AUDIO_SAMPLE_RATE 24000
+#endif
+
+// Notes that can sound at once
+#ifndef AUDIO_OSCILLATORS
+#    define AUDIO_OSCILLATORS 4
+#endif
+
+// Samples rendered ahead of the driver, must be a power of two
+#ifndef AUDIO_SYNTH_BUFFER_SIZE
+#    define AUDIO_SYNTH_BUFFER_SIZE 256
+#endif
+
+// Samples rendered by each call to audio_synth_task()
+#ifndef AUDIO_SYNTH_CHUNK_SIZE
+#    define AUDIO_SYNTH_CHUNK_SIZE 32
+#endif
+
+typedef enum {
+    AUDIO_WAVEFORM_SQUARE,
+    AUDIO_WAVEFORM_TRIANGLE,
+    AUDIO_WAVEFORM_SINE,
+} audio_waveform_t;
+
+#ifndef AUDIO_WAVEFORM_DEFAULT
+#    define AUDIO_WAVEFORM_DEFAULT AUDIO_WAVEFORM_SQUARE
+#endif
+
+// Pitch of A4 (440 Hz), one semitone is 256 above or below it
+#define AUDIO_SYNTH_PITCH_A4 0
+#define AUDIO_SYNTH_SEMITONE 256
+
+// Fill buffer with the next count samples of whatever is playing
+void audio_synth_render(int16_t *buffer, uint16_t count);
+// Render the next chunk into the ring buffer if there is room for it
+void audio_synth_task(void);
+// Take count samples out of the ring buffer, rendering any it is short of there and then
+void audio_synth_read(int16_t *buffer, uint16_t count);
+// False once all notes and songs have ended and the output is silent
+bool audio_synth_is_active(void);
+
+int16_t  audio_synth_freq_to_pitch(float freq);
+uint32_t audio_synth_pitch_to_increment(int16_t pitch);
+
+// The timbre set with set_timbre() is the duty cycle of the square wave
+void             audio_synth_set_waveform(audio_waveform_t waveform);
+audio_waveform_t audio_synth_get_waveform(void);
+
+// Provided by the platform driver, called once from audio_init()
+void audio_driver_initialize(void);
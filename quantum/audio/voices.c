@@ -32,8 +32,10 @@ void voice_iterate() { voice = (voice + 1) % number_of_voices; }
 void voice_deiterate() { voice = (voice - 1 + number_of_voices) % number_of_voices; }
 
 float voice_envelope(float frequency) {
+#ifdef AUDIO_VOICES
     // envelope_index ranges from 0 to 0xFFFF, which is preserved at 880.0 Hz
     __attribute__((unused)) uint16_t compensated_index = (uint16_t)((float)envelope_index * (880.0 / frequency));
+#endif
 
     switch (voice) {
         case default_voice:
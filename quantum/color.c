@@ -17,6 +17,7 @@
 #include "color.h"
 #include "led_tables.h"
 #include "progmem.h"
+#include "lib/lib8tion/lib8tion.h"
 
 RGB hsv_to_rgb(HSV hsv) {
     RGB      rgb;
@@ -86,6 +87,70 @@ RGB hsv_to_rgb(HSV hsv) {
     return rgb;
 }
 
+static RGB hsv_to_rgb_region(uint8_t region, uint8_t v, uint8_t p, uint8_t q, uint8_t t) {
+    switch (region) {
+        case 6:
+        case 0:
+            return (RGB){.r = v, .g = t, .b = p};
+        case 1:
+            return (RGB){.r = q, .g = v, .b = p};
+        case 2:
+            return (RGB){.r = p, .g = v, .b = t};
+        case 3:
+            return (RGB){.r = p, .g = q, .b = v};
+        case 4:
+            return (RGB){.r = t, .g = p, .b = v};
+        default:
+            return (RGB){.r = v, .g = p, .b = q};
+    }
+}
+
+/* Converts an array of colors, giving the same result as hsv_to_rgb for each one.
+ *
+ * Effects mostly vary only the hue from LED to LED, so four colors that share a
+ * saturation and value are converted together: q and t of all four come out of
+ * packed scale8x4 calls instead of sixteen separate multiplies. AVR has no 32-bit
+ * multiply, so it converts one color at a time.
+ */
+void hsv_to_rgb_array(const HSV *hsv, RGB *rgb, uint8_t count) {
+#if !defined(__AVR__) && (FASTLED_SCALE8_FIXED != 1)
+    for (; count >= 4; count -= 4, hsv += 4, rgb += 4) {
+        uint8_t s = hsv[0].s;
+        if (s == 0 || hsv[1].s != s || hsv[2].s != s || hsv[3].s != s || hsv[1].v != hsv[0].v || hsv[2].v != hsv[0].v || hsv[3].v != hsv[0].v) {
+            for (uint8_t i = 0; i < 4; i++) {
+                rgb[i] = hsv_to_rgb(hsv[i]);
+            }
+            continue;
+        }
+
+#    ifdef USE_CIE1931_CURVE
+        uint8_t v = pgm_read_byte(&CIE1931_CURVE[hsv[0].v]);
+#    else
+        uint8_t v = hsv[0].v;
+#    endif
+
+        uint8_t  region[4];
+        uint32_t remainder = 0;
+        for (uint8_t i = 0; i < 4; i++) {
+            region[i] = hsv[i].h * 6 / 255;
+            remainder |= (uint32_t)(uint8_t)((hsv[i].h * 2 - region[i] * 85) * 3) << (i * 8);
+        }
+
+        uint8_t  p = (v * (255 - s)) >> 8;
+        uint32_t q = scale8x4(~scale8x4(remainder, s), v);
+        uint32_t t = scale8x4(~scale8x4(~remainder, s), v);
+
+        for (uint8_t i = 0; i < 4; i++) {
+            rgb[i] = hsv_to_rgb_region(region[i], v, p, q >> (i * 8), t >> (i * 8));
+        }
+    }
+#endif
+
+    for (uint8_t i = 0; i < count; i++) {
+        rgb[i] = hsv_to_rgb(hsv[i]);
+    }
+}
+
 #ifdef RGBW
 #    ifndef MIN
 #        define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -63,7 +63,8 @@ typedef struct PACKED {
 #    pragma pack(pop)
 #endif
 
-RGB hsv_to_rgb(HSV hsv);
+RGB  hsv_to_rgb(HSV hsv);
+void hsv_to_rgb_array(const HSV *hsv, RGB *rgb, uint8_t count);
 #ifdef RGBW
 void convert_rgb_to_rgbw(LED_TYPE *led);
 #endif
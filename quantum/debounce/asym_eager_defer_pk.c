@@ -0,0 +1,109 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+Asymmetric per-key algorithm. Eager on key-down, deferred on key-up.
+After pressing a key, it immediately changes state. Bounces while the key is
+held are absorbed, because key-up is only pushed once the key has been
+released for DEBOUNCE milliseconds with no changes.
+Only keys waiting to be released have a timestamp, kept in a list, so keys
+that are idle or held down cost nothing per scan.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include <stdlib.h>
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+#if DEBOUNCE > 0
+typedef struct {
+    uint8_t  row;
+    uint8_t  col;
+    uint16_t time;
+} pending_release_t;
+
+static pending_release_t *pending_releases;
+static uint16_t           pending_count;
+static matrix_row_t *     pending_rows;
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    pending_releases = (pending_release_t *)malloc(num_rows * MATRIX_COLS * sizeof(pending_release_t));
+    pending_rows     = (matrix_row_t *)calloc(num_rows, sizeof(matrix_row_t));
+    pending_count    = 0;
+}
+
+// Pushes the key-ups that have been stable for DEBOUNCE ms, and forgets the ones that were pressed again.
+static void update_pending_releases(matrix_row_t raw[], matrix_row_t cooked[], uint16_t current_time) {
+    uint16_t kept = 0;
+    for (uint16_t i = 0; i < pending_count; i++) {
+        pending_release_t *pending = &pending_releases[i];
+        matrix_row_t       mask    = ROW_SHIFTER << pending->col;
+        if (raw[pending->row] & mask) {
+            pending_rows[pending->row] &= ~mask;
+        } else if (TIMER_DIFF_16(current_time, pending->time) >= DEBOUNCE) {
+            pending_rows[pending->row] &= ~mask;
+            cooked[pending->row] &= ~mask;
+        } else {
+            pending_releases[kept++] = *pending;
+        }
+    }
+    pending_count = kept;
+}
+
+// Pushes key-downs at once, and starts the timer of new key-ups.
+static void start_pending_releases(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint16_t current_time) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        cooked[row] |= delta & raw[row];
+
+        matrix_row_t releases = delta & ~raw[row] & ~pending_rows[row];
+        pending_rows[row] |= releases;
+        for (uint8_t col = 0; releases; col++, releases >>= 1) {
+            if (releases & 1) {
+                pending_releases[pending_count++] = (pending_release_t){.row = row, .col = col, .time = current_time};
+            }
+        }
+    }
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint16_t current_time = timer_read();
+    if (pending_count) {
+        update_pending_releases(raw, cooked, current_time);
+    }
+
+    if (changed) {
+        start_pending_releases(raw, cooked, num_rows, current_time);
+    }
+}
+#else  // no debouncing.
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    for (int i = 0; i < num_rows; i++) {
+        cooked[i] = raw[i];
+    }
+}
+#endif
+
+bool debounce_active(void) { return true; }
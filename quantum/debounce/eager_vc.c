@@ -0,0 +1,81 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+Eager per-key algorithm using vertical counters.
+After pressing a key, it immediately changes state, and starts its counter.
+No further inputs are accepted for that key until DEBOUNCE milliseconds have occurred.
+Behaves like eager_pk, but the counters of a whole row are stepped together.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "vertical_counter.h"
+#include <stdlib.h>
+
+#if DEBOUNCE > 0
+static vc_row_t *vc_rows;
+static uint16_t  last_time;
+static bool      counters_need_update;
+static bool      matrix_need_update;
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    vc_rows              = (vc_row_t *)calloc(num_rows, sizeof(vc_row_t));
+    last_time            = timer_read();
+    counters_need_update = false;
+    matrix_need_update   = false;
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time        = now;
+
+    if (!counters_need_update && !changed && !matrix_need_update) {
+        return;
+    }
+
+    bool transfer        = changed || matrix_need_update;
+    counters_need_update = false;
+    matrix_need_update   = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        vc_row_t *vc = &vc_rows[row];
+        vc_advance(vc, elapsed > DEBOUNCE ? DEBOUNCE : elapsed);
+
+        if (transfer) {
+            // Flip the keys that are not locked out, and lock them out
+            matrix_row_t delta = raw[row] ^ cooked[row];
+            matrix_row_t flip  = delta & ~vc->active;
+            cooked[row] ^= flip;
+            vc->active |= flip;
+            matrix_need_update |= (delta & ~flip) != 0;
+        }
+        counters_need_update |= vc->active != 0;
+    }
+}
+#else  // no debouncing.
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    for (int i = 0; i < num_rows; i++) {
+        cooked[i] = raw[i];
+    }
+}
+#endif
+
+bool debounce_active(void) { return true; }
@@ -0,0 +1,80 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+Symmetric per-key algorithm using vertical counters.
+When a key has not changed state for DEBOUNCE milliseconds, we push its state.
+Behaves like sym_pk, but the counters of a whole row are stepped together, so
+the cost per scan depends on the number of rows rather than the number of keys.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "vertical_counter.h"
+#include <stdlib.h>
+
+#if DEBOUNCE > 0
+static vc_row_t *vc_rows;
+static uint16_t  last_time;
+static bool      counters_active;
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    vc_rows         = (vc_row_t *)calloc(num_rows, sizeof(vc_row_t));
+    last_time       = timer_read();
+    counters_active = false;
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, last_time);
+    last_time        = now;
+
+    if (!counters_active && !changed) {
+        return;
+    }
+
+    counters_active = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        vc_row_t *vc = &vc_rows[row];
+        if (changed) {
+            // Keys that went back to their debounced state stop counting
+            matrix_row_t delta = raw[row] ^ cooked[row];
+            vc_clear(vc, vc->active & ~delta);
+            vc->active &= delta;
+        }
+
+        cooked[row] ^= vc_advance(vc, elapsed > DEBOUNCE ? DEBOUNCE : elapsed);
+
+        if (changed) {
+            // Keys that just changed start counting from zero
+            vc->active = raw[row] ^ cooked[row];
+        }
+        counters_active |= vc->active != 0;
+    }
+}
+#else  // no debouncing.
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    for (int i = 0; i < num_rows; i++) {
+        cooked[i] = raw[i];
+    }
+}
+#endif
+
+bool debounce_active(void) { return true; }
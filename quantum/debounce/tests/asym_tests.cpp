@@ -0,0 +1,122 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Traces for asym_eager_defer_pk, which reports key-down at once and key-up once the key has been up for DEBOUNCE (5) ms.
+
+#include "debounce_test_common.h"
+
+#include <iostream>
+
+extern "C" {
+#include "debounce.h"
+
+void sym_pk_debounce_init(uint8_t num_rows);
+void sym_pk_debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+}
+
+TEST_F(DebounceTest, CleanPressAndRelease) {
+    addTrace(0, 1, "__########__________",
+                   "__#############_____");
+    runTraces();
+}
+
+TEST_F(DebounceTest, BouncyPressAndRelease) {
+    addTrace(0, 1, "__#_##_#_##########_#_#__#____________",
+                   "__#############################_______");
+    runTraces();
+}
+
+TEST_F(DebounceTest, NoiseIsHeldUntilItStops) {
+    addTrace(2, 3, "____#___##____###_________",
+                   "____##################____");
+    runTraces();
+}
+
+TEST_F(DebounceTest, ChatteringKeyIsHeld) {
+    addTrace(1, 4, "_____#_#_#_#_#_#_#_#_#_#_______",
+                   "_____########################__");
+    runTraces();
+}
+
+TEST_F(DebounceTest, KeysAreDebouncedIndependently) {
+    addTrace(0, 0, "__#_##_#_##########_#_#__#____________",
+                   "__#############################_______");
+    addTrace(0, MATRIX_COLS - 1, "__########__________________________",
+                                 "__#############_____________________");
+    addTrace(0, 5, "______#_#______________###########___",
+                   "______########_________##############");
+    addTrace(MATRIX_ROWS - 1, 2, "____________________##########_______",
+                                 "____________________###############__");
+    runTraces();
+}
+
+TEST_F(DebounceTest, TimerWrapsAround) {
+    addTrace(0, 1, "__#_##_#_##########_#_#__#____________",
+                   "__#############################_______");
+    runTraces(65530);
+}
+
+TEST_F(DebounceTest, OneScanPerMillisecond) {
+    scans_per_ms = 1;
+    addTrace(0, 1, "__#_##_#_##########_#_#__#____________",
+                   "__#############################_______");
+    runTraces();
+}
+
+TEST_F(DebounceTest, LatencyComparedWithSymPk) {
+    static const char* recorded[] = {
+        "__#_##_#_##########_#_#__#____________",
+        "___#_###############__#_______________",
+        "__##_#_#############_##_#_____________",
+        "____###############___________________",
+        "_#_#_##_#_#########_#_#_#_#___________",
+    };
+    uint8_t col = 0;
+    for (const char* raw : recorded) {
+        // The cooked traces are only compared through their latency
+        addTrace(0, col++, raw, std::string(strlen(raw), '_'));
+    }
+
+    std::vector<std::string> asym   = replayTraces(debounce_init, debounce);
+    std::vector<std::string> sym_pk = replayTraces(sym_pk_debounce_init, sym_pk_debounce);
+
+    int asym_press = 0, asym_release = 0, sym_pk_press = 0, sym_pk_release = 0;
+    for (size_t i = 0; i < asym.size(); i++) {
+        std::string raw = recorded[i];
+        SCOPED_TRACE(raw);
+
+        // Press latency runs from the first raw key-down, release latency from the last raw key-up
+        int press             = asym[i].find('#') - raw.find('#');
+        int release           = asym[i].rfind('#') - raw.rfind('#');
+        int reference_press   = sym_pk[i].find('#') - raw.find('#');
+        int reference_release = sym_pk[i].rfind('#') - raw.rfind('#');
+
+        EXPECT_EQ(press, 0);
+        EXPECT_EQ(release, DEBOUNCE);
+        EXPECT_GE(reference_press, DEBOUNCE);
+        EXPECT_EQ(release, reference_release);
+
+        asym_press += press;
+        asym_release += release;
+        sym_pk_press += reference_press;
+        sym_pk_release += reference_release;
+    }
+
+    size_t count = asym.size();
+    std::cout << "[ LATENCY  ] asym_eager_defer_pk: press " << (float)asym_press / count << " ms, release " << (float)asym_release / count << " ms" << std::endl;
+    std::cout << "[ LATENCY  ] sym_pk:              press " << (float)sym_pk_press / count << " ms, release " << (float)sym_pk_release / count << " ms" << std::endl;
+}
@@ -0,0 +1,83 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "debounce_test_common.h"
+
+#include <algorithm>
+
+extern "C" {
+#include "debounce.h"
+
+void set_time(uint32_t t);
+}
+
+void DebounceTest::SetUp() { traces.clear(); }
+
+void DebounceTest::addTrace(uint8_t row, uint8_t col, const std::string& raw, const std::string& cooked) {
+    ASSERT_EQ(raw.size(), cooked.size()) << "raw and cooked traces of key " << (int)row << "," << (int)col << " differ in length";
+    traces.push_back({row, col, raw, cooked});
+}
+
+void DebounceTest::runTraces(uint32_t start_time) {
+    std::vector<std::string> actual = replayTraces(debounce_init, debounce, start_time);
+
+    for (size_t i = 0; i < traces.size(); i++) {
+        EXPECT_EQ(actual[i], traces[i].cooked) << "key " << (int)traces[i].row << "," << (int)traces[i].col << " raw " << traces[i].raw;
+    }
+}
+
+std::vector<std::string> DebounceTest::replayTraces(debounce_init_f init_func, debounce_f debounce_func, uint32_t start_time) {
+    matrix_row_t raw[MATRIX_ROWS]    = {0};
+    matrix_row_t cooked[MATRIX_ROWS] = {0};
+
+    size_t length = 0;
+    for (const Trace& trace : traces) {
+        length = std::max(length, trace.raw.size());
+    }
+
+    std::vector<std::string> actual(traces.size());
+
+    set_time(start_time);
+    init_func(MATRIX_ROWS);
+
+    for (size_t t = 0; t < length; t++) {
+        set_time(start_time + t);
+
+        matrix_row_t previous[MATRIX_ROWS];
+        std::copy(raw, raw + MATRIX_ROWS, previous);
+        for (const Trace& trace : traces) {
+            if (t >= trace.raw.size()) continue;
+            if (trace.raw[t] == '#') {
+                raw[trace.row] |= MATRIX_ROW_SHIFTER << trace.col;
+            } else {
+                raw[trace.row] &= ~(MATRIX_ROW_SHIFTER << trace.col);
+            }
+        }
+
+        for (uint8_t scan = 0; scan < scans_per_ms; scan++) {
+            bool changed = scan == 0 && !std::equal(raw, raw + MATRIX_ROWS, previous);
+            debounce_func(raw, cooked, MATRIX_ROWS, changed);
+        }
+
+        for (size_t i = 0; i < traces.size(); i++) {
+            if (t >= traces[i].raw.size()) continue;
+            actual[i] += (cooked[traces[i].row] & (MATRIX_ROW_SHIFTER << traces[i].col)) ? '#' : '_';
+        }
+    }
+
+    return actual;
+}
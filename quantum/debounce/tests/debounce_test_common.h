@@ -0,0 +1,58 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "matrix.h"
+}
+
+// Replays recorded key traces through the debounce algorithm under test.
+//
+// A trace is one character per millisecond, '#' while the key is down and '_' while it is up.
+// The raw trace is what the matrix scan reads, bounces included, and the cooked trace is what
+// the debounce algorithm is expected to report for the same key.
+class DebounceTest : public ::testing::Test {
+   protected:
+    void SetUp() override;
+
+    typedef void (*debounce_init_f)(uint8_t num_rows);
+    typedef void (*debounce_f)(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+
+    void addTrace(uint8_t row, uint8_t col, const std::string& raw, const std::string& cooked);
+    void runTraces(uint32_t start_time = 0);
+
+    // Replays the raw traces through the given algorithm and returns the cooked trace of each key
+    std::vector<std::string> replayTraces(debounce_init_f init_func, debounce_f debounce_func, uint32_t start_time = 0);
+
+    uint8_t scans_per_ms = 2;
+
+   private:
+    struct Trace {
+        uint8_t     row;
+        uint8_t     col;
+        std::string raw;
+        std::string cooked;
+    };
+
+    std::vector<Trace> traces;
+};
@@ -0,0 +1,69 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Traces for the eager algorithms, which report a change at once and then ignore the key for DEBOUNCE (5) ms.
+
+#include "debounce_test_common.h"
+
+TEST_F(DebounceTest, CleanPressAndRelease) {
+    addTrace(0, 1, "__########__________",
+                   "__########__________");
+    runTraces();
+}
+
+TEST_F(DebounceTest, BouncyPressAndRelease) {
+    addTrace(0, 1, "__#_##_#_##########_#_#__#____________",
+                   "__######_____######______#####________");
+    runTraces();
+}
+
+TEST_F(DebounceTest, NoiseIsReportedForAtLeastDebounce) {
+    addTrace(2, 3, "____#___##____###_________",
+                   "____######_____#####______");
+    runTraces();
+}
+
+TEST_F(DebounceTest, ChatteringKeyIsSlowedDown) {
+    addTrace(1, 4, "_____#_#_#_#_#_#_#_#_#_#_______",
+                   "_____#####_____#####___________");
+    runTraces();
+}
+
+TEST_F(DebounceTest, KeysAreDebouncedIndependently) {
+    addTrace(0, 0, "__#_##_#_##########_#_#__#____________",
+                   "__######_____######______#####________");
+    addTrace(0, MATRIX_COLS - 1, "__########__________________________",
+                                 "__########__________________________");
+    addTrace(0, 5, "______#_#______________###########___",
+                   "______#####____________###########___");
+    addTrace(MATRIX_ROWS - 1, 2, "____________________##########_______",
+                                 "____________________##########_______");
+    runTraces();
+}
+
+TEST_F(DebounceTest, TimerWrapsAround) {
+    addTrace(0, 1, "__#_##_#_##########_#_#__#____________",
+                   "__######_____######______#####________");
+    runTraces(65530);
+}
+
+TEST_F(DebounceTest, OneScanPerMillisecond) {
+    scans_per_ms = 1;
+    addTrace(0, 1, "__#_##_#_##########_#_#__#____________",
+                   "__######_____######______#####________");
+    runTraces();
+}
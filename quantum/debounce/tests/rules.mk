@@ -0,0 +1,57 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+DEBOUNCE_TEST_SRC :=\
+	$(QUANTUM_PATH)/debounce/tests/debounce_test_common.cpp \
+	$(TMK_PATH)/common/test/timer.c
+
+DEBOUNCE_TEST_DEFS := -DMATRIX_ROWS=6 -DMATRIX_COLS=22 -DDEBOUNCE=5
+
+debounce_sym_pk_SRC :=\
+	$(DEBOUNCE_TEST_SRC) \
+	$(QUANTUM_PATH)/debounce/tests/symmetric_tests.cpp \
+	$(QUANTUM_PATH)/debounce/sym_pk.c
+
+debounce_sym_pk_DEFS := $(DEBOUNCE_TEST_DEFS)
+
+debounce_sym_vc_SRC :=\
+	$(DEBOUNCE_TEST_SRC) \
+	$(QUANTUM_PATH)/debounce/tests/symmetric_tests.cpp \
+	$(QUANTUM_PATH)/debounce/sym_vc.c
+
+debounce_sym_vc_DEFS := $(DEBOUNCE_TEST_DEFS)
+
+debounce_eager_pk_SRC :=\
+	$(DEBOUNCE_TEST_SRC) \
+	$(QUANTUM_PATH)/debounce/tests/eager_tests.cpp \
+	$(QUANTUM_PATH)/debounce/eager_pk.c
+
+debounce_eager_pk_DEFS := $(DEBOUNCE_TEST_DEFS)
+
+debounce_eager_vc_SRC :=\
+	$(DEBOUNCE_TEST_SRC) \
+	$(QUANTUM_PATH)/debounce/tests/eager_tests.cpp \
+	$(QUANTUM_PATH)/debounce/eager_vc.c
+
+debounce_eager_vc_DEFS := $(DEBOUNCE_TEST_DEFS)
+
+debounce_asym_eager_defer_pk_SRC :=\
+	$(DEBOUNCE_TEST_SRC) \
+	$(QUANTUM_PATH)/debounce/tests/asym_tests.cpp \
+	$(QUANTUM_PATH)/debounce/tests/sym_pk_reference.c \
+	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c
+
+debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_TEST_DEFS)
@@ -0,0 +1,6 @@
+TEST_LIST +=\
+	debounce_sym_pk\
+	debounce_sym_vc\
+	debounce_eager_pk\
+	debounce_eager_vc\
+	debounce_asym_eager_defer_pk
@@ -0,0 +1,92 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+Vertical counters for the bit-parallel debounce algorithms.
+Bit b of the counter of the key in column n is kept in bit n of plane b, so
+stepping the counters of a whole row takes a few word-wide operations no
+matter how many columns the row has.
+Counters count milliseconds and stop when they reach DEBOUNCE.
+*/
+
+#pragma once
+
+#include "matrix.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+#if DEBOUNCE > 255
+#    error "The vertical counter debounce algorithms support DEBOUNCE up to 255"
+#elif DEBOUNCE > 127
+#    define VC_BITS 8
+#elif DEBOUNCE > 63
+#    define VC_BITS 7
+#elif DEBOUNCE > 31
+#    define VC_BITS 6
+#elif DEBOUNCE > 15
+#    define VC_BITS 5
+#elif DEBOUNCE > 7
+#    define VC_BITS 4
+#elif DEBOUNCE > 3
+#    define VC_BITS 3
+#elif DEBOUNCE > 1
+#    define VC_BITS 2
+#else
+#    define VC_BITS 1
+#endif
+
+typedef struct {
+    matrix_row_t active;  // keys whose counter is running
+    matrix_row_t count[VC_BITS];
+} vc_row_t;
+
+// Clears the counters of the keys in mask.
+static inline void vc_clear(vc_row_t *row, matrix_row_t mask) {
+    for (uint8_t b = 0; b < VC_BITS; b++) {
+        row->count[b] &= ~mask;
+    }
+}
+
+// Adds one to the counters of the keys in mask and returns the keys whose counter is now DEBOUNCE.
+static inline matrix_row_t vc_increment(vc_row_t *row, matrix_row_t mask) {
+    matrix_row_t carry   = mask;
+    matrix_row_t reached = mask;
+    for (uint8_t b = 0; b < VC_BITS; b++) {
+        matrix_row_t next = row->count[b] & carry;
+        row->count[b] ^= carry;
+        carry = next;
+        reached &= (DEBOUNCE & (1 << b)) ? row->count[b] : ~row->count[b];
+    }
+    return reached;
+}
+
+// Runs the counters of the active keys forward by elapsed milliseconds.
+// Returns the keys whose counter reached DEBOUNCE, which are cleared and no longer active.
+static inline matrix_row_t vc_advance(vc_row_t *row, uint8_t elapsed) {
+    matrix_row_t expired = 0;
+    for (; elapsed > 0 && row->active; elapsed--) {
+        matrix_row_t reached = vc_increment(row, row->active);
+        if (reached) {
+            vc_clear(row, reached);
+            row->active &= ~reached;
+            expired |= reached;
+        }
+    }
+    return expired;
+}
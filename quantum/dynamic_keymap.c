@@ -21,6 +21,7 @@
 #include "quantum.h"  // for send_string()
 #include "dynamic_keymap.h"
 #include "via.h"  // for default VIA_EEPROM_ADDR_END
+#include <string.h>
 
 #ifndef DYNAMIC_KEYMAP_LAYER_COUNT
 #    define DYNAMIC_KEYMAP_LAYER_COUNT 4
@@ -68,26 +69,117 @@
 #    define DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1)
 #endif
 
+#define DYNAMIC_KEYMAP_EEPROM_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+// How long the keymap has to be left alone before pending writes go to EEPROM
+#    ifndef DYNAMIC_KEYMAP_WRITE_DELAY
+#        define DYNAMIC_KEYMAP_WRITE_DELAY 1000
+#    endif
+// Maximum number of bytes written to EEPROM per call to dynamic_keymap_task()
+#    ifndef DYNAMIC_KEYMAP_WRITE_CHUNK
+#        define DYNAMIC_KEYMAP_WRITE_CHUNK 16
+#    endif
+
+// Copy of the keymap area of the EEPROM, in the same big-endian layout
+static uint8_t  dynamic_keymap_mirror[DYNAMIC_KEYMAP_EEPROM_SIZE];
+static bool     dynamic_keymap_mirror_loaded = false;
+// Writes are coalesced into a single [start, end) range of offsets into the mirror
+static uint16_t dynamic_keymap_dirty_start = DYNAMIC_KEYMAP_EEPROM_SIZE;
+static uint16_t dynamic_keymap_dirty_end   = 0;
+static uint16_t dynamic_keymap_last_write  = 0;
+
+static void dynamic_keymap_mirror_load(void) {
+    if (!dynamic_keymap_mirror_loaded) {
+        eeprom_read_block(dynamic_keymap_mirror, (void *)DYNAMIC_KEYMAP_EEPROM_ADDR, DYNAMIC_KEYMAP_EEPROM_SIZE);
+        dynamic_keymap_mirror_loaded = true;
+    }
+}
+
+static void dynamic_keymap_mark_dirty(uint16_t offset, uint16_t size) {
+    if (offset < dynamic_keymap_dirty_start) {
+        dynamic_keymap_dirty_start = offset;
+    }
+    if (offset + size > dynamic_keymap_dirty_end) {
+        dynamic_keymap_dirty_end = offset + size;
+    }
+    dynamic_keymap_last_write = timer_read();
+}
+
+// Writes up to max_size bytes of the pending range to EEPROM
+static void dynamic_keymap_write_back(uint16_t max_size) {
+    if (dynamic_keymap_dirty_start >= dynamic_keymap_dirty_end) {
+        return;
+    }
+    uint16_t size = dynamic_keymap_dirty_end - dynamic_keymap_dirty_start;
+    if (size > max_size) {
+        size = max_size;
+    }
+    eeprom_update_block(&dynamic_keymap_mirror[dynamic_keymap_dirty_start], ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + dynamic_keymap_dirty_start, size);
+    dynamic_keymap_dirty_start += size;
+    if (dynamic_keymap_dirty_start >= dynamic_keymap_dirty_end) {
+        dynamic_keymap_dirty_start = DYNAMIC_KEYMAP_EEPROM_SIZE;
+        dynamic_keymap_dirty_end   = 0;
+    }
+}
+
+void dynamic_keymap_init(void) { dynamic_keymap_mirror_load(); }
+
+void dynamic_keymap_flush(void) { dynamic_keymap_write_back(DYNAMIC_KEYMAP_EEPROM_SIZE); }
+
+bool dynamic_keymap_pending(void) { return dynamic_keymap_dirty_start < dynamic_keymap_dirty_end; }
+
+void dynamic_keymap_invalidate(void) {
+    dynamic_keymap_dirty_start   = DYNAMIC_KEYMAP_EEPROM_SIZE;
+    dynamic_keymap_dirty_end     = 0;
+    dynamic_keymap_mirror_loaded = false;
+    layer_lookup_cache_invalidate();
+}
+
+void dynamic_keymap_task(void) {
+    if (timer_elapsed(dynamic_keymap_last_write) >= DYNAMIC_KEYMAP_WRITE_DELAY) {
+        dynamic_keymap_write_back(DYNAMIC_KEYMAP_WRITE_CHUNK);
+    }
+}
+#endif
+
 uint8_t dynamic_keymap_get_layer_count(void) { return DYNAMIC_KEYMAP_LAYER_COUNT; }
 
-void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column) {
+static uint16_t dynamic_keymap_key_to_offset(uint8_t layer, uint8_t row, uint8_t column) {
     // TODO: optimize this with some left shifts
-    return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2);
+    return (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2);
 }
 
+void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column) { return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + dynamic_keymap_key_to_offset(layer, row, column); }
+
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    dynamic_keymap_mirror_load();
+    uint8_t *address = &dynamic_keymap_mirror[dynamic_keymap_key_to_offset(layer, row, column)];
+    return (address[0] << 8) | address[1];
+#else
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
     uint16_t keycode = eeprom_read_byte(address) << 8;
     keycode |= eeprom_read_byte(address + 1);
     return keycode;
+#endif
 }
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    dynamic_keymap_mirror_load();
+    uint16_t offset                   = dynamic_keymap_key_to_offset(layer, row, column);
+    dynamic_keymap_mirror[offset]     = (uint8_t)(keycode >> 8);
+    dynamic_keymap_mirror[offset + 1] = (uint8_t)(keycode & 0xFF);
+    dynamic_keymap_mark_dirty(offset, 2);
+#else
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address, (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+#endif
+    layer_lookup_cache_invalidate();
 }
 
 void dynamic_keymap_reset(void) {
@@ -104,11 +196,16 @@ void dynamic_keymap_reset(void) {
 }
 
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *target                     = data;
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    dynamic_keymap_mirror_load();
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
+        data[i] = offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE ? dynamic_keymap_mirror[offset + i] : 0x00;
+    }
+#else
+    void *   source = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    uint8_t *target = data;
+    for (uint16_t i = 0; i < size; i++) {
+        if (offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE) {
             *target = eeprom_read_byte(source);
         } else {
             *target = 0x00;
@@ -116,19 +213,32 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
         source++;
         target++;
     }
+#endif
 }
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *source                     = data;
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    dynamic_keymap_mirror_load();
+    if (offset >= DYNAMIC_KEYMAP_EEPROM_SIZE) {
+        return;
+    }
+    if (offset + size > DYNAMIC_KEYMAP_EEPROM_SIZE) {
+        size = DYNAMIC_KEYMAP_EEPROM_SIZE - offset;
+    }
+    memcpy(&dynamic_keymap_mirror[offset], data, size);
+    dynamic_keymap_mark_dirty(offset, size);
+#else
+    void *   target = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
+        if (offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE) {
             eeprom_update_byte(target, *source);
         }
         source++;
         target++;
     }
+#endif
+    layer_lookup_cache_invalidate();
 }
 
 // This overrides the one in quantum/keymap_common.c
@@ -145,7 +255,7 @@ uint8_t dynamic_keymap_macro_get_count(void) { return DYNAMIC_KEYMAP_MACRO_COUNT
 uint16_t dynamic_keymap_macro_get_buffer_size(void) { return DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE; }
 
 void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   source = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   source = ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + offset;
     uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
@@ -159,7 +269,9 @@ void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   target = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    // a macro being typed is read lazily, do not let it run into the new contents
+    send_string_queue_cancel();
+    void *   target = ((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + offset;
     uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
@@ -171,6 +283,7 @@ void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_reset(void) {
+    send_string_queue_cancel();
     void *p   = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
     void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
     while (p != end) {
@@ -210,6 +323,10 @@ void dynamic_keymap_macro_send(uint8_t id) {
         ++p;
     }
 
+#ifdef SEND_STRING_QUEUE_ENABLE
+    // Typed in the background, straight out of EEPROM
+    send_string_queue_macro_eeprom(p);
+#else
     // Send the macro string one or three chars at a time
     // by making temporary 1 or 3 char strings
     char data[4] = {0, 0, 0, 0};
@@ -234,4 +351,5 @@ void dynamic_keymap_macro_send(uint8_t id) {
         }
         send_string(data);
     }
+#endif
 }
@@ -18,6 +18,27 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+// With DYNAMIC_KEYMAP_RAM_MIRROR, the keymaps are read from a copy in RAM
+// and changes are written back to EEPROM by dynamic_keymap_task() once the
+// keymap hasn't been touched for DYNAMIC_KEYMAP_WRITE_DELAY milliseconds.
+// dynamic_keymap_flush() writes any pending changes immediately.
+// dynamic_keymap_invalidate() drops pending changes and reloads the copy from
+// EEPROM on next use, for when something else has rewritten or erased it.
+// dynamic_keymap_pending() tells whether changes are waiting to be written.
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+void dynamic_keymap_init(void);
+void dynamic_keymap_task(void);
+void dynamic_keymap_flush(void);
+void dynamic_keymap_invalidate(void);
+bool dynamic_keymap_pending(void);
+#else
+#    define dynamic_keymap_init()
+#    define dynamic_keymap_task()
+#    define dynamic_keymap_flush()
+#    define dynamic_keymap_invalidate()
+#    define dynamic_keymap_pending() false
+#endif
+
 uint8_t  dynamic_keymap_get_layer_count(void);
 void *   dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column);
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column);
@@ -20,6 +20,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debounce.h"
 #include "quantum.h"
+#include "scan_profile.h"
+#ifdef MATRIX_IDLE_ENABLE
+#    include "matrix_idle.h"
+#endif
+#ifdef MATRIX_PORT_READ
+#    include "matrix_port_read.h"
+#endif
 
 #ifdef DIRECT_PINS
 static pin_t direct_pins[MATRIX_ROWS][MATRIX_COLS] = DIRECT_PINS;
@@ -77,11 +84,19 @@ static void unselect_rows(void) {
     }
 }
 
+#        ifdef MATRIX_PORT_READ
+static matrix_port_run_t col_runs[MATRIX_COLS];
+static uint8_t           col_run_count;
+#        endif
+
 static void init_pins(void) {
     unselect_rows();
     for (uint8_t x = 0; x < MATRIX_COLS; x++) {
         setPinInputHigh(col_pins[x]);
     }
+#        ifdef MATRIX_PORT_READ
+    col_run_count = matrix_port_runs_init(col_runs, col_pins, MATRIX_COLS);
+#        endif
 }
 
 static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
@@ -95,6 +110,10 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
     select_row(current_row);
     matrix_io_delay();
 
+#        ifdef MATRIX_PORT_READ
+    // Read the cols a port at a time (active low)
+    current_matrix[current_row] = matrix_port_runs_read_low(col_runs, col_run_count);
+#        else
     // For each col...
     for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++) {
         // Select the col pin to read (active low)
@@ -103,6 +122,7 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
         // Populate the matrix row with the state of the col pin
         current_matrix[current_row] |= pin_state ? 0 : (MATRIX_ROW_SHIFTER << col_index);
     }
+#        endif
 
     // Unselect row
     unselect_row(current_row);
@@ -110,6 +130,20 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
     return (last_row_value != current_matrix[current_row]);
 }
 
+#        ifdef MATRIX_IDLE_ENABLE
+// In idle mode every row is selected, so a key going down anywhere pulls its col low
+static const pin_t *const idle_pins      = col_pins;
+static const uint8_t      idle_pin_count = MATRIX_COLS;
+
+static void select_idle(void) {
+    for (uint8_t x = 0; x < MATRIX_ROWS; x++) {
+        select_row(x);
+    }
+}
+
+static void unselect_idle(void) { unselect_rows(); }
+#        endif
+
 #    elif (DIODE_DIRECTION == ROW2COL)
 
 static void select_col(uint8_t col) {
@@ -125,11 +159,22 @@ static void unselect_cols(void) {
     }
 }
 
+#        ifdef MATRIX_PORT_READ
+#            if MATRIX_ROWS > 32
+#                error MATRIX_PORT_READ supports up to 32 rows with ROW2COL
+#            endif
+static matrix_port_run_t row_runs[MATRIX_ROWS];
+static uint8_t           row_run_count;
+#        endif
+
 static void init_pins(void) {
     unselect_cols();
     for (uint8_t x = 0; x < MATRIX_ROWS; x++) {
         setPinInputHigh(row_pins[x]);
     }
+#        ifdef MATRIX_PORT_READ
+    row_run_count = matrix_port_runs_init(row_runs, row_pins, MATRIX_ROWS);
+#        endif
 }
 
 static bool read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col) {
@@ -139,13 +184,22 @@ static bool read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col)
     select_col(current_col);
     matrix_io_delay();
 
+#        ifdef MATRIX_PORT_READ
+    // Read the rows a port at a time (active low)
+    uint32_t rows_low = matrix_port_runs_read_low(row_runs, row_run_count);
+#        endif
+
     // For each row...
     for (uint8_t row_index = 0; row_index < MATRIX_ROWS; row_index++) {
         // Store last value of row prior to reading
         matrix_row_t last_row_value = current_matrix[row_index];
 
         // Check row pin state
+#        ifdef MATRIX_PORT_READ
+        if (rows_low & ((uint32_t)1 << row_index)) {
+#        else
         if (readPin(row_pins[row_index]) == 0) {
+#        endif
             // Pin LO, set col bit
             current_matrix[row_index] |= (MATRIX_ROW_SHIFTER << current_col);
         } else {
@@ -165,6 +219,20 @@ static bool read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col)
     return matrix_changed;
 }
 
+#        ifdef MATRIX_IDLE_ENABLE
+// In idle mode every col is selected, so a key going down anywhere pulls its row low
+static const pin_t *const idle_pins      = row_pins;
+static const uint8_t      idle_pin_count = MATRIX_ROWS;
+
+static void select_idle(void) {
+    for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+        select_col(x);
+    }
+}
+
+static void unselect_idle(void) { unselect_cols(); }
+#        endif
+
 #    else
 #        error DIODE_DIRECTION must be one of COL2ROW or ROW2COL!
 #    endif
@@ -172,6 +240,59 @@ static bool read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col)
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+#ifdef MATRIX_IDLE_ENABLE
+#    ifdef DIRECT_PINS
+#        error MATRIX_IDLE_ENABLE needs a diode matrix, direct pins are read one by one anyway
+#    endif
+
+static bool any_idle_pin_low(void) {
+    for (uint8_t x = 0; x < idle_pin_count; x++) {
+        if (!readPin(idle_pins[x])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true while idle and no key has gone down, so the scan can be skipped
+static bool matrix_idle_skip_scan(void) {
+    if (!matrix_idle_is_active()) {
+        return false;
+    }
+
+    // a key that went down before the interrupts were armed would not wake the sleep
+    if (!any_idle_pin_low() && matrix_idle_allowed()) {
+        matrix_idle_sleep(MATRIX_IDLE_WAKE_INTERVAL);
+    }
+    if (!matrix_idle_leave(any_idle_pin_low())) {
+        return true;
+    }
+
+    // A key went down or work is pending, go back to full scans
+    matrix_idle_disarm();
+    unselect_idle();
+    matrix_io_delay();
+    return false;
+}
+
+// Goes idle once no key has been down, raw or debounced, for MATRIX_IDLE_TIMEOUT ms
+static void matrix_idle_update(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    bool keys_down = false;
+    for (uint8_t i = 0; i < num_rows; i++) {
+        if (raw[i] || cooked[i]) {
+            keys_down = true;
+            break;
+        }
+    }
+
+    if (matrix_idle_enter(keys_down)) {
+        select_idle();
+        matrix_io_delay();
+        matrix_idle_arm(idle_pins, idle_pin_count);
+    }
+}
+#endif
+
 void matrix_init(void) {
     // initialize key pins
     init_pins();
@@ -190,6 +311,14 @@ void matrix_init(void) {
 uint8_t matrix_scan(void) {
     bool changed = false;
 
+#ifdef MATRIX_IDLE_ENABLE
+    if (matrix_idle_skip_scan()) {
+        debounce(raw_matrix, matrix, MATRIX_ROWS, false);
+        matrix_scan_quantum();
+        return 0;
+    }
+#endif
+
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
@@ -202,7 +331,13 @@ uint8_t matrix_scan(void) {
     }
 #endif
 
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_DEBOUNCE);
     debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
+    SCAN_PROFILE_END(SCAN_PROFILE_DEBOUNCE);
+
+#ifdef MATRIX_IDLE_ENABLE
+    matrix_idle_update(raw_matrix, matrix, MATRIX_ROWS);
+#endif
 
     matrix_scan_quantum();
     return (uint8_t)changed;
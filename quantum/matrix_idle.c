@@ -0,0 +1,224 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "matrix_idle.h"
+
+static bool     matrix_idle_active = false;
+static uint16_t matrix_idle_timer;
+
+__attribute__((weak)) bool matrix_idle_allowed_user(void) { return true; }
+
+__attribute__((weak)) bool matrix_idle_allowed_kb(void) { return matrix_idle_allowed_user(); }
+
+bool matrix_idle_allowed(void) {
+#ifdef TAP_DANCE_ENABLE
+    if (tap_dance_pending()) {
+        return false;
+    }
+#endif
+#ifdef LEADER_ENABLE
+    if (leader_pending()) {
+        return false;
+    }
+#endif
+#ifdef COMBO_ENABLE
+    if (combo_pending()) {
+        return false;
+    }
+#endif
+#if !defined(NO_ACTION_ONESHOT) && defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0)
+    if (get_oneshot_mods() || get_oneshot_layer_state()) {
+        return false;
+    }
+#endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    if (dynamic_keymap_pending()) {
+        return false;
+    }
+#endif
+    if (send_string_queue_busy()) {
+        return false;
+    }
+    return matrix_idle_allowed_kb();
+}
+
+bool matrix_idle_enter(bool keys_down) {
+    if (keys_down || !matrix_idle_allowed()) {
+        matrix_idle_timer = timer_read();
+        return false;
+    }
+    if (timer_elapsed(matrix_idle_timer) < MATRIX_IDLE_TIMEOUT) {
+        return false;
+    }
+    matrix_idle_active = true;
+    return true;
+}
+
+bool matrix_idle_leave(bool keys_down) {
+    if (!keys_down && matrix_idle_allowed()) {
+        return false;
+    }
+    matrix_idle_active = false;
+    matrix_idle_timer  = timer_read();
+    return true;
+}
+
+bool matrix_idle_is_active(void) { return matrix_idle_active; }
+
+#if defined(__AVR__)
+#    include <avr/interrupt.h>
+#    include <avr/sleep.h>
+
+/* Pins on port B have pin change interrupts on every supported MCU, and the
+ * other ports are left to the timer tick, which wakes the MCU every ms. */
+
+static volatile bool matrix_idle_woken;
+#    if defined(PCMSK0) && defined(PINB_ADDRESS)
+// The pins armed in PCMSK0, the keyboard may be using the others
+static volatile uint8_t matrix_idle_pcmsk = 0;
+#    endif
+
+void matrix_idle_pin_changed(void) {
+    matrix_idle_woken = true;
+#    if defined(PCMSK0) && defined(PINB_ADDRESS)
+    // one wake is enough, don't come back here for every bounce
+    PCMSK0 &= ~matrix_idle_pcmsk;
+#    endif
+}
+
+#    if defined(PCMSK0) && defined(PINB_ADDRESS) && !defined(MATRIX_IDLE_CUSTOM_PCINT0)
+ISR(PCINT0_vect) { matrix_idle_pin_changed(); }
+#    endif
+
+void matrix_idle_arm(const pin_t pins[], uint8_t count) {
+    matrix_idle_woken = false;
+#    if defined(PCMSK0) && defined(PINB_ADDRESS)
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if ((pins[i] >> PORT_SHIFTER) == PINB_ADDRESS) {
+            mask |= _BV(pins[i] & 0xF);
+        }
+    }
+    if (mask) {
+        matrix_idle_pcmsk = mask;
+        PCMSK0 |= mask;
+        PCIFR = _BV(PCIF0);
+        PCICR |= _BV(PCIE0);
+    }
+#    endif
+}
+
+void matrix_idle_disarm(void) {
+#    if defined(PCMSK0) && defined(PINB_ADDRESS)
+    PCMSK0 &= ~matrix_idle_pcmsk;
+    matrix_idle_pcmsk = 0;
+    if (!PCMSK0) {
+        PCICR &= ~_BV(PCIE0);
+    }
+#    endif
+}
+
+void matrix_idle_sleep(uint16_t timeout_ms) {
+    // the timer tick ends the sleep every ms, whatever the timeout
+    (void)timeout_ms;
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    if (!matrix_idle_woken) {
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+    }
+    sei();
+    matrix_idle_woken = false;
+}
+
+#elif defined(PROTOCOL_CHIBIOS)
+
+/* The matrix thread is suspended until a PAL line event on one of the pins
+ * resumes it, which lets the idle thread stop the core in between. */
+
+static thread_reference_t matrix_idle_thread = NULL;
+static const pin_t *      matrix_idle_pins;
+static uint8_t            matrix_idle_count;
+// Set by an event that came in while the thread was not suspended yet
+static bool matrix_idle_woken;
+// Some of the pins could not be armed, sleeps are cut to a tick to poll them
+static bool matrix_idle_polling;
+
+void matrix_idle_pin_changed(void) {
+    chSysLockFromISR();
+    matrix_idle_woken = true;
+    chThdResumeI(&matrix_idle_thread, MSG_OK);
+    chSysUnlockFromISR();
+}
+
+static void matrix_idle_callback(void *arg) {
+    (void)arg;
+    matrix_idle_pin_changed();
+}
+
+void matrix_idle_arm(const pin_t pins[], uint8_t count) {
+    matrix_idle_pins    = pins;
+    matrix_idle_count   = count;
+    matrix_idle_woken   = false;
+    matrix_idle_polling = false;
+#    if defined(STM32_EXTI_NUM_LINES)
+    // one EXTI line per pin number, whichever port the pin is on
+    uint16_t lines = 0;
+#    endif
+    for (uint8_t i = 0; i < count; i++) {
+#    if defined(STM32_EXTI_NUM_LINES)
+        uint16_t line = 1 << PAL_PAD(pins[i]);
+        if (lines & line) {
+            matrix_idle_polling = true;
+            continue;
+        }
+        lines |= line;
+#    endif
+        palEnableLineEvent(pins[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(pins[i], matrix_idle_callback, NULL);
+    }
+}
+
+void matrix_idle_disarm(void) {
+    // this leaves a shared line alone when it was armed for another port
+    for (uint8_t i = 0; i < matrix_idle_count; i++) {
+        palDisableLineEvent(matrix_idle_pins[i]);
+    }
+    matrix_idle_count = 0;
+}
+
+void matrix_idle_sleep(uint16_t timeout_ms) {
+    if (matrix_idle_polling) {
+        timeout_ms = 1;
+    }
+    chSysLock();
+    if (!matrix_idle_woken) {
+        chThdSuspendTimeoutS(&matrix_idle_thread, timeout_ms ? TIME_MS2I(timeout_ms) : TIME_INFINITE);
+    }
+    matrix_idle_woken = false;
+    chSysUnlock();
+}
+
+#else
+
+__attribute__((weak)) void matrix_idle_disarm(void) {}
+__attribute__((weak)) void matrix_idle_sleep(uint16_t timeout_ms) {}
+__attribute__((weak)) void matrix_idle_pin_changed(void) {}
+
+#endif
@@ -0,0 +1,100 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include "quantum.h"
+
+#ifndef MATRIX_IDLE_TIMEOUT
+#    define MATRIX_IDLE_TIMEOUT 100
+#endif
+
+// Longest the main loop sleeps while idle, in ms, 0 to sleep until a key goes down. Features that
+// do their work from the main loop, animating LEDs or answering the host, keep it running at 60Hz.
+// Timers started by a key press, like tap dances, keep the matrix from going idle instead, see
+// matrix_idle_allowed().
+#ifndef MATRIX_IDLE_WAKE_INTERVAL
+#    if defined(RGB_MATRIX_ENABLE) || defined(LED_MATRIX_ENABLE) || defined(RGBLIGHT_ENABLE) || defined(BACKLIGHT_ENABLE) || defined(OLED_DRIVER_ENABLE) || defined(AUDIO_ENABLE) || defined(RAW_ENABLE) || defined(VIA_ENABLE) || defined(CONSOLE_ENABLE) || defined(MIDI_ENABLE) || defined(VIRTSER_ENABLE)
+#        define MATRIX_IDLE_WAKE_INTERVAL 16
+#    else
+#        define MATRIX_IDLE_WAKE_INTERVAL 0
+#    endif
+#endif
+
+#if defined(PROTOCOL_CHIBIOS) && PAL_USE_CALLBACKS != TRUE
+#    error MATRIX_IDLE_ENABLE needs PAL_USE_CALLBACKS set to TRUE in halconf.h to wake on a key press
+#endif
+
+/* Idle mode for the matrix scanning code.
+ *
+ * Once no key has been down for MATRIX_IDLE_TIMEOUT ms, and nothing is waiting
+ * on a timer, the matrix drives every row (or column) at once and only watches
+ * the input pins, sleeping until one of them changes.
+ */
+
+/** \brief Whether the matrix may go idle
+ *
+ * False while work driven from the main loop is waiting on a timer: a tap
+ * dance, leader sequence or combo that hasn't finished, timed oneshot mods or
+ * layer, queued send_string output, or dynamic keymap changes that haven't been
+ * written to EEPROM. Keyboards and keymaps add their own through
+ * matrix_idle_allowed_kb() and matrix_idle_allowed_user().
+ */
+bool matrix_idle_allowed(void);
+bool matrix_idle_allowed_kb(void);
+bool matrix_idle_allowed_user(void);
+
+/** \brief Called after every full scan, returns true when the matrix should go idle now */
+bool matrix_idle_enter(bool keys_down);
+
+/** \brief Called while idle, returns true when the matrix should go back to full scans */
+bool matrix_idle_leave(bool keys_down);
+
+/** \brief Whether the matrix is idle */
+bool matrix_idle_is_active(void);
+
+/* Platform hooks used to wait for one of the input pins to change */
+
+#if defined(__AVR__) || defined(PROTOCOL_CHIBIOS)
+/** \brief Arms a change interrupt on as many of the input pins as the platform can watch
+ *
+ * On STM32, pins with the same number on different ports share an EXTI line and
+ * only the first of them is armed. Sleeps are then cut to 1ms, so presses on
+ * the others are still seen.
+ */
+void matrix_idle_arm(const pin_t pins[], uint8_t count);
+#endif
+
+/** \brief Disarms the interrupts armed by matrix_idle_arm */
+void matrix_idle_disarm(void);
+
+/** \brief Sleeps until an armed pin changes, or for timeout_ms at most unless it is 0
+ *
+ * On AVR, only input pins on port B have a pin change interrupt, and the 1ms
+ * timer tick wakes the MCU from idle sleep anyway, so pins on the other ports
+ * are still read every ms.
+ */
+void matrix_idle_sleep(uint16_t timeout_ms);
+
+/** \brief Wakes the matrix from matrix_idle_sleep
+ *
+ * On AVR, matrix_idle.c defines the PCINT0 interrupt handler. A keyboard that
+ * needs the handler itself defines MATRIX_IDLE_CUSTOM_PCINT0 and calls this from
+ * its own ISR(PCINT0_vect).
+ */
+void matrix_idle_pin_changed(void);
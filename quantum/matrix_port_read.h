@@ -0,0 +1,85 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+#include "quantum.h"
+
+/* Reads a list of input pins a whole GPIO port at a time.
+ *
+ * At init the pins are grouped into runs: pins on the same port whose
+ * position in the list is the same distance from their pad number. One port
+ * read then gives every pin of a run at once with a mask and a shift, and
+ * runs on the same port share that read.
+ */
+
+typedef struct {
+    pin_t       pin;       // a pin on the port of the run
+    port_data_t mask;      // pads of the run
+    int8_t      shift;     // list position of pad 0
+    bool        new_port;  // first run on its port, which reads the port
+} matrix_port_run_t;
+
+// Groups the pins into runs, returns the number of runs
+static inline uint8_t matrix_port_runs_init(matrix_port_run_t runs[], const pin_t pins[], uint8_t count) {
+    uint8_t run_count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        int8_t  shift = i - getPinPad(pins[i]);
+        uint8_t run   = 0;
+        while (run < run_count && !(samePinPort(runs[run].pin, pins[i]) && runs[run].shift == shift)) {
+            run++;
+        }
+        if (run == run_count) {
+            // Keep the runs of a port together, so each port is read once
+            uint8_t position = run_count;
+            for (uint8_t j = 0; j < run_count; j++) {
+                if (samePinPort(runs[j].pin, pins[i])) {
+                    position = j + 1;
+                }
+            }
+            for (uint8_t j = run_count; j > position; j--) {
+                runs[j] = runs[j - 1];
+            }
+            runs[position] = (matrix_port_run_t){.pin = pins[i], .mask = 0, .shift = shift};
+            run            = position;
+            run_count++;
+        }
+        runs[run].mask |= (port_data_t)1 << getPinPad(pins[i]);
+    }
+
+    for (uint8_t run = 0; run < run_count; run++) {
+        runs[run].new_port = run == 0 || !samePinPort(runs[run - 1].pin, runs[run].pin);
+    }
+    return run_count;
+}
+
+// Returns a bit per pin, in list order, set when the pin reads low
+static inline uint32_t matrix_port_runs_read_low(const matrix_port_run_t runs[], uint8_t run_count) {
+    uint32_t    low  = 0;
+    port_data_t port = 0;
+    for (uint8_t run = 0; run < run_count; run++) {
+        if (runs[run].new_port) {
+            port = ~readPinPort(runs[run].pin);
+        }
+        uint32_t pads = port & runs[run].mask;
+        low |= runs[run].shift >= 0 ? pads << runs[run].shift : pads >> -runs[run].shift;
+    }
+    return low;
+}
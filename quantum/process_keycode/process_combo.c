@@ -16,9 +16,11 @@
 
 #include "print.h"
 #include "process_combo.h"
+#include <stdlib.h>
 
 #ifndef COMBO_VARIABLE_LEN
 __attribute__((weak)) combo_t key_combos[COMBO_COUNT] = {};
+#    define COMBO_LEN COMBO_COUNT
 #else
 extern combo_t  key_combos[];
 extern int      COMBO_LEN;
@@ -26,11 +28,19 @@ extern int      COMBO_LEN;
 
 __attribute__((weak)) void process_combo_event(uint8_t combo_index, bool pressed) {}
 
-static uint16_t timer               = 0;
-static uint8_t  current_combo_index = 0;
-static bool     drop_buffer         = false;
-static bool     is_active           = false;
-static bool     b_combo_enable      = true;  // defaults to enabled
+#define COMBO_NONE 0xFFFF
+
+static uint16_t timer                 = 0;
+static uint16_t current_combo_index   = 0;
+static bool     drop_buffer           = false;
+static bool     is_active             = true;
+static bool     b_combo_enable        = true;  // defaults to enabled
+static uint16_t combos_with_keys_down = 0;
+
+/* A completed combo that is held back because a longer combo containing it
+ * can still be completed. It fires once that is no longer possible. */
+static uint16_t pending_combo_index = COMBO_NONE;
+static uint8_t  pending_combo_size  = 0;
 
 static uint8_t buffer_size = 0;
 #ifdef COMBO_ALLOW_ACTION_KEYS
@@ -39,6 +49,29 @@ static keyrecord_t key_buffer[MAX_COMBO_LENGTH];
 static uint16_t key_buffer[MAX_COMBO_LENGTH];
 #endif
 
+/* Reverse index from keycode to the combos that contain it, built the first
+ * time a key is processed and sorted by keycode, so a keypress only visits
+ * the combos it belongs to. */
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+    uint8_t  key_index;
+    uint8_t  key_count;
+} combo_key_t;
+
+static combo_key_t *combo_keys       = NULL;
+static uint16_t     combo_keys_count = 0;
+static bool         combo_keys_built = false;
+
+/* State of the event being processed, filled in by the combo_key_handler_t callbacks */
+static bool     is_combo_key;
+static bool     extends_pending_combo;
+static bool     longer_combo_possible;
+static uint16_t completed_combo_index;
+static uint8_t  completed_combo_size;
+
+typedef void (*combo_key_handler_t)(const combo_key_t *key, keyrecord_t *record);
+
 static inline void send_combo(uint16_t action, bool pressed) {
     if (action) {
         if (pressed) {
@@ -71,60 +104,172 @@ static inline void dump_key_buffer(bool emit) {
     buffer_size = 0;
 }
 
-#define ALL_COMBO_KEYS_ARE_DOWN (((1 << count) - 1) == combo->state)
-#define KEY_STATE_DOWN(key)         \
-    do {                            \
-        combo->state |= (1 << key); \
-    } while (0)
-#define KEY_STATE_UP(key)            \
-    do {                             \
-        combo->state &= ~(1 << key); \
-    } while (0)
+static inline combo_state_t all_combo_keys_down(uint8_t count) { return count >= sizeof(combo_state_t) * 8 ? (combo_state_t)~0 : (((combo_state_t)1 << count) - 1); }
 
-static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record) {
+static uint8_t combo_length(const combo_t *combo) {
     uint8_t count = 0;
-    uint8_t index = -1;
-    /* Find index of keycode and number of combo keys */
-    for (const uint16_t *keys = combo->keys;; ++count) {
-        uint16_t key = pgm_read_word(&keys[count]);
-        if (keycode == key) index = count;
-        if (COMBO_END == key) break;
+    while (COMBO_END != pgm_read_word(&combo->keys[count])) {
+        count++;
     }
+    return count;
+}
 
-    /* Continue processing if not a combo key */
-    if (-1 == (int8_t)index) return false;
+/* Returns true if every key of inner is also part of outer */
+static bool combo_includes(const combo_t *outer, const combo_t *inner) {
+    for (const uint16_t *inner_keys = inner->keys;; inner_keys++) {
+        uint16_t key = pgm_read_word(inner_keys);
+        if (COMBO_END == key) return true;
 
-    bool is_combo_active = is_active;
+        for (const uint16_t *outer_keys = outer->keys;; outer_keys++) {
+            uint16_t outer_key = pgm_read_word(outer_keys);
+            if (key == outer_key) break;
+            if (COMBO_END == outer_key) return false;
+        }
+    }
+}
 
-    if (record->event.pressed) {
-        KEY_STATE_DOWN(index);
+static int compare_combo_keys(const void *a, const void *b) {
+    const combo_key_t *key_a = a;
+    const combo_key_t *key_b = b;
+    if (key_a->keycode != key_b->keycode) {
+        return key_a->keycode < key_b->keycode ? -1 : 1;
+    }
+    /* keep the key_combos order between combos sharing a key */
+    return (int)key_a->combo_index - (int)key_b->combo_index;
+}
+
+static void build_combo_index(void) {
+    combo_keys_built = true;
+
+    uint16_t total = 0;
+    for (uint16_t i = 0; i < (uint16_t)COMBO_LEN; i++) {
+        total += combo_length(&key_combos[i]);
+    }
+    if (total == 0) {
+        return;
+    }
 
-        if (is_combo_active) {
-            if (ALL_COMBO_KEYS_ARE_DOWN) { /* Combo was pressed */
-                send_combo(combo->keycode, true);
-                drop_buffer = true;
+    combo_keys = (combo_key_t *)malloc(total * sizeof(combo_key_t));
+    if (!combo_keys) {
+        dprintln("combo: not enough memory for the index, scanning all combos");
+        return;
+    }
+
+    combo_keys_count = 0;
+    for (uint16_t i = 0; i < (uint16_t)COMBO_LEN; i++) {
+        uint8_t count = combo_length(&key_combos[i]);
+        for (uint8_t k = 0; k < count; k++) {
+            combo_keys[combo_keys_count++] = (combo_key_t){
+                .keycode     = pgm_read_word(&key_combos[i].keys[k]),
+                .combo_index = i,
+                .key_index   = k,
+                .key_count   = count,
+            };
+        }
+    }
+    qsort(combo_keys, combo_keys_count, sizeof(combo_key_t), compare_combo_keys);
+}
+
+static void for_each_combo_with_key(uint16_t keycode, keyrecord_t *record, combo_key_handler_t handler) {
+    if (combo_keys) {
+        /* find the first index entry for the keycode */
+        uint16_t first = 0;
+        uint16_t last  = combo_keys_count;
+        while (first < last) {
+            uint16_t middle = first + (last - first) / 2;
+            if (combo_keys[middle].keycode < keycode) {
+                first = middle + 1;
+            } else {
+                last = middle;
             }
         }
+        for (uint16_t i = first; i < combo_keys_count && combo_keys[i].keycode == keycode; i++) {
+            handler(&combo_keys[i], record);
+        }
     } else {
-        if (ALL_COMBO_KEYS_ARE_DOWN) { /* Combo was released */
-            send_combo(combo->keycode, false);
-        } else {
-            /* continue processing without immediately returning */
-            is_combo_active = false;
+        for (uint16_t i = 0; i < (uint16_t)COMBO_LEN; i++) {
+            combo_key_t key = {.keycode = keycode, .combo_index = i, .key_index = 0xFF};
+            uint8_t     count;
+            for (count = 0;; count++) {
+                uint16_t combo_keycode = pgm_read_word(&key_combos[i].keys[count]);
+                if (COMBO_END == combo_keycode) break;
+                if (keycode == combo_keycode) key.key_index = count;
+            }
+            if (key.key_index != 0xFF) {
+                key.key_count = count;
+                handler(&key, record);
+            }
         }
+    }
+}
+
+static void fire_combo(uint16_t combo_index) {
+    combo_t *combo      = &key_combos[combo_index];
+    current_combo_index = combo_index;
+    combo->active       = true;
+    send_combo(combo->keycode, true);
+}
 
-        KEY_STATE_UP(index);
+static void resolve_pending_combo(void) {
+    if (pending_combo_index == COMBO_NONE) {
+        return;
+    }
+    fire_combo(pending_combo_index);
+    pending_combo_index = COMBO_NONE;
+    timer               = timer_read();
+    dump_key_buffer(false);
+}
+
+static void check_extends_pending_combo(const combo_key_t *key, keyrecord_t *record) {
+    if (key->combo_index != pending_combo_index && key->key_count > pending_combo_size && combo_includes(&key_combos[key->combo_index], &key_combos[pending_combo_index])) {
+        extends_pending_combo = true;
     }
+}
 
-    return is_combo_active;
+static void check_longer_combo_possible(const combo_key_t *key, keyrecord_t *record) {
+    combo_t *combo = &key_combos[key->combo_index];
+    if (key->key_count > completed_combo_size && combo->state != all_combo_keys_down(key->key_count) && combo_includes(combo, &key_combos[completed_combo_index])) {
+        longer_combo_possible = true;
+    }
 }
 
-#define NO_COMBO_KEYS_ARE_DOWN (0 == combo->state)
+static void process_single_combo(const combo_key_t *key, keyrecord_t *record) {
+    combo_t *           combo    = &key_combos[key->combo_index];
+    const combo_state_t key_mask = (combo_state_t)1 << key->key_index;
+    const combo_state_t all_down = all_combo_keys_down(key->key_count);
+
+    if (record->event.pressed) {
+        if (!combo->state) combos_with_keys_down++;
+        combo->state |= key_mask;
+
+        if (is_active) {
+            is_combo_key = true;
+            /* the longest of the combos completed by this key wins */
+            if (all_down == combo->state && !combo->active && key->key_count > completed_combo_size) {
+                completed_combo_index = key->combo_index;
+                completed_combo_size  = key->key_count;
+            }
+        }
+    } else {
+        if (all_down == combo->state) { /* Combo was released */
+            if (combo->active) {
+                current_combo_index = key->combo_index;
+                combo->active       = false;
+                send_combo(combo->keycode, false);
+            }
+            is_combo_key |= is_active;
+        }
+
+        combo->state &= ~key_mask;
+        if (!combo->state) combos_with_keys_down--;
+    }
+}
 
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    bool is_combo_key          = false;
-    drop_buffer                = false;
-    bool no_combo_keys_pressed = true;
+    is_combo_key          = false;
+    drop_buffer           = false;
+    completed_combo_index = COMBO_NONE;
+    completed_combo_size  = 0;
 
     if (keycode == CMB_ON && record->event.pressed) {
         combo_enable();
@@ -144,14 +289,36 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     if (!is_combo_enabled()) {
         return true;
     }
-#ifndef COMBO_VARIABLE_LEN
-    for (current_combo_index = 0; current_combo_index < COMBO_COUNT; ++current_combo_index) {
-#else
-    for (current_combo_index = 0; current_combo_index < COMBO_LEN; ++current_combo_index) {
-#endif
-        combo_t *combo = &key_combos[current_combo_index];
-        is_combo_key |= process_single_combo(combo, keycode, record);
-        no_combo_keys_pressed = no_combo_keys_pressed && NO_COMBO_KEYS_ARE_DOWN;
+
+    if (!combo_keys_built) {
+        build_combo_index();
+    }
+
+    if (pending_combo_index != COMBO_NONE) {
+        /* a held back combo fires unless this key can still complete a longer one */
+        extends_pending_combo = false;
+        if (record->event.pressed) {
+            for_each_combo_with_key(keycode, record, check_extends_pending_combo);
+        }
+        if (!extends_pending_combo) {
+            resolve_pending_combo();
+        }
+    }
+
+    for_each_combo_with_key(keycode, record, process_single_combo);
+
+    if (completed_combo_index != COMBO_NONE) {
+        longer_combo_possible = false;
+        for_each_combo_with_key(keycode, record, check_longer_combo_possible);
+        if (longer_combo_possible) {
+            /* the key is buffered below, the combo fires when it is resolved */
+            pending_combo_index = completed_combo_index;
+            pending_combo_size  = completed_combo_size;
+        } else { /* Combo was pressed */
+            pending_combo_index = COMBO_NONE;
+            fire_combo(completed_combo_index);
+            drop_buffer = true;
+        }
     }
 
     if (drop_buffer) {
@@ -164,7 +331,7 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
         dump_key_buffer(true);
 
         // reset state if there are no combo keys pressed at all
-        if (no_combo_keys_pressed) {
+        if (!combos_with_keys_down) {
             timer     = 0;
             is_active = true;
         }
@@ -186,6 +353,11 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
 
 void matrix_scan_combo(void) {
     if (b_combo_enable && is_active && timer && timer_elapsed(timer) > COMBO_TERM) {
+        if (pending_combo_index != COMBO_NONE) {
+            /* nothing longer was completed in time */
+            resolve_pending_combo();
+            return;
+        }
         /* This disables the combo, meaning key events for this
          * combo will be handled by the next processors in the chain
          */
@@ -199,6 +371,7 @@ void combo_enable(void) { b_combo_enable = true; }
 void combo_disable(void) {
     b_combo_enable = is_active = false;
     timer                      = 0;
+    pending_combo_index        = COMBO_NONE;
     dump_key_buffer(true);
 }
 
@@ -211,3 +384,5 @@ void combo_toggle(void) {
 }
 
 bool is_combo_enabled(void) { return b_combo_enable; }
+
+bool combo_pending(void) { return b_combo_enable && is_active && timer; }
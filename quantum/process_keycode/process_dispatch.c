@@ -0,0 +1,27 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "process_dispatch.h"
+#include "scan_profile.h"
+
+#ifdef SCAN_PROFILE_ENABLE
+bool process_dispatch_profile(bool (*handler)(uint16_t keycode, keyrecord_t *record), uint8_t index, uint16_t keycode, keyrecord_t *record) {
+    uint32_t start  = timer_read_us32();
+    bool     result = handler(keycode, record);
+    scan_profile_record(SCAN_PROFILE_PROCESS + index, timer_read_us32() - start);
+    return result;
+}
+#endif
@@ -0,0 +1,122 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "action.h"
+
+/** \brief A process_* stage and the keycodes it handles
+ *
+ * A stage is only called for keycodes in [first, last]. Stages that have to
+ * see every event (to record it, cancel a pending state, play a click, ...)
+ * use PROCESS_ALL. A stage that handles several disjoint ranges gets one entry
+ * per range, listed next to each other.
+ */
+typedef struct {
+    bool (*handler)(uint16_t keycode, keyrecord_t *record);
+    uint16_t first;
+    uint16_t last;
+#ifdef SCAN_PROFILE_ENABLE
+    const char *name;
+#endif
+} process_dispatch_entry_t;
+
+#ifdef SCAN_PROFILE_ENABLE
+#    define PROCESS_ALL(handler) {handler, 0x0000, 0xFFFF, #handler}
+#    define PROCESS_RANGE(handler, first, last) {handler, first, last, #handler}
+#    define PROCESS_KEYCODE(handler, keycode) {handler, keycode, keycode, #handler}
+#else
+#    define PROCESS_ALL(handler) {handler, 0x0000, 0xFFFF}
+#    define PROCESS_RANGE(handler, first, last) {handler, first, last}
+#    define PROCESS_KEYCODE(handler, keycode) {handler, keycode, keycode}
+#endif
+
+#define PROCESS_DISPATCH_MAX_ENTRIES 32
+#define PROCESS_DISPATCH_COUNT(table) (sizeof(table) / sizeof(table[0]))
+// The modulo keeps the index in bounds for the steps past the end of the table, which are dropped anyway
+#define PROCESS_DISPATCH_ENTRY(table, n) table[(n) % PROCESS_DISPATCH_COUNT(table)]
+
+#ifdef SCAN_PROFILE_ENABLE
+/** \brief Calls a handler, timed as scan profile stage SCAN_PROFILE_PROCESS + index */
+bool process_dispatch_profile(bool (*handler)(uint16_t keycode, keyrecord_t *record), uint8_t index, uint16_t keycode, keyrecord_t *record);
+#    define PROCESS_DISPATCH_CALL(handler, n, keycode, record) process_dispatch_profile(handler, n, keycode, record)
+#else
+#    define PROCESS_DISPATCH_CALL(handler, n, keycode, record) handler(keycode, record)
+#endif
+
+/* Calls entry n if the table has one and it covers keycode. With a constant
+ * table, this compiles down to comparisons against immediates and a direct
+ * call, and to nothing past the end of the table. */
+#define PROCESS_DISPATCH_STEP(table, n, keycode, record)                                                                                                    \
+    if ((n) < PROCESS_DISPATCH_COUNT(table) && PROCESS_DISPATCH_ENTRY(table, n).first <= (keycode) && (keycode) <= PROCESS_DISPATCH_ENTRY(table, n).last) { \
+        if (!PROCESS_DISPATCH_CALL(PROCESS_DISPATCH_ENTRY(table, n).handler, n, keycode, record)) {                                                         \
+            return false;                                                                                                                                   \
+        }                                                                                                                                                   \
+    }
+
+#ifdef __cplusplus
+#    define PROCESS_DISPATCH_ASSERT static_assert
+#else
+#    define PROCESS_DISPATCH_ASSERT _Static_assert
+#endif
+
+/** \brief Defines `bool name(uint16_t keycode, keyrecord_t *record)` running `table`
+ *
+ * The function runs the entries covering `keycode` in table order, with the
+ * same semantics as chaining the handlers with `&&`: it stops at, and returns
+ * false for, the first handler that returns false. `table` has to be a
+ * `static const` array, so that the ranges and handlers are folded in at
+ * compile time and nothing is built or kept in RAM.
+ */
+#define PROCESS_DISPATCH_DEFINE(name, table)                                                                               \
+    PROCESS_DISPATCH_ASSERT(PROCESS_DISPATCH_COUNT(table) <= PROCESS_DISPATCH_MAX_ENTRIES, "Too many entries in " #table); \
+    bool name(uint16_t keycode, keyrecord_t *record) {                                                                     \
+        PROCESS_DISPATCH_STEP(table, 0, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 1, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 2, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 3, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 4, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 5, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 6, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 7, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 8, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 9, keycode, record)                                                                   \
+        PROCESS_DISPATCH_STEP(table, 10, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 11, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 12, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 13, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 14, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 15, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 16, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 17, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 18, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 19, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 20, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 21, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 22, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 23, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 24, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 25, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 26, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 27, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 28, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 29, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 30, keycode, record)                                                                  \
+        PROCESS_DISPATCH_STEP(table, 31, keycode, record)                                                                  \
+        return true;                                                                                                       \
+    }
@@ -34,6 +34,8 @@ uint16_t leader_time = 0;
 uint16_t leader_sequence[5]   = {0, 0, 0, 0, 0};
 uint8_t  leader_sequence_size = 0;
 
+bool leader_pending(void) { return leading; }
+
 void qk_leader_start(void) {
     if (leading) {
         return;
@@ -180,6 +180,15 @@ void matrix_scan_tap_dance() {
     }
 }
 
+bool tap_dance_pending(void) {
+    for (int8_t i = 0; i <= highest_td; i++) {
+        if (tap_dance_actions[i].state.count) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void reset_tap_dance(qk_tap_dance_state_t *state) {
     qk_tap_dance_action_t *action;
 
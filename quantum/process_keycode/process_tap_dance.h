@@ -87,6 +87,8 @@ void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record);
 bool process_tap_dance(uint16_t keycode, keyrecord_t *record);
 void matrix_scan_tap_dance(void);
 void reset_tap_dance(qk_tap_dance_state_t *state);
+// Whether a tap dance is waiting for its tapping term to finish
+bool tap_dance_pending(void);
 
 void qk_tap_dance_pair_on_each_tap(qk_tap_dance_state_t *state, void *user_data);
 void qk_tap_dance_pair_finished(qk_tap_dance_state_t *state, void *user_data);
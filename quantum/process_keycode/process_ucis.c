@@ -51,10 +51,8 @@ static bool is_uni_seq(char *seq) {
 
 __attribute__((weak)) void qk_ucis_symbol_fallback(void) {
     for (uint8_t i = 0; i < qk_ucis_state.count - 1; i++) {
-        uint8_t code = qk_ucis_state.codes[i];
-        register_code(code);
-        unregister_code(code);
-        wait_ms(UNICODE_TYPE_DELAY);
+        send_string_queue_tap(qk_ucis_state.codes[i]);
+        send_string_queue_delay(UNICODE_TYPE_DELAY);
     }
 }
 
@@ -81,9 +79,8 @@ void register_ucis(const char *hex) {
         }
 
         if (kc) {
-            register_code(kc);
-            unregister_code(kc);
-            wait_ms(UNICODE_TYPE_DELAY);
+            send_string_queue_tap(kc);
+            send_string_queue_delay(UNICODE_TYPE_DELAY);
         }
     }
 }
@@ -116,9 +113,8 @@ bool process_ucis(uint16_t keycode, keyrecord_t *record) {
         bool symbol_found = false;
 
         for (i = qk_ucis_state.count; i > 0; i--) {
-            register_code(KC_BSPC);
-            unregister_code(KC_BSPC);
-            wait_ms(UNICODE_TYPE_DELAY);
+            send_string_queue_tap(KC_BSPC);
+            send_string_queue_delay(UNICODE_TYPE_DELAY);
         }
 
         if (keycode == KC_ESC) {
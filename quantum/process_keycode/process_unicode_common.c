@@ -77,63 +77,75 @@ void cycle_unicode_input_mode(int8_t offset) {
 void persist_unicode_input_mode(void) { eeprom_update_byte(EECONFIG_UNICODEMODE, unicode_config.input_mode); }
 
 __attribute__((weak)) void unicode_input_start(void) {
-    unicode_saved_mods = get_mods();  // Save current mods
-    clear_mods();                     // Unregister mods to start from a clean state
+    unicode_saved_mods = send_string_queue_get_mods();  // Save current mods
+#ifdef SEND_STRING_QUEUE_ENABLE
+    send_string_queue_clear_mods();  // Unregister mods once the queue gets here
+#else
+    clear_mods();  // Unregister mods to start from a clean state
+#endif
 
     switch (unicode_config.input_mode) {
         case UC_MAC:
-            register_code(UNICODE_KEY_MAC);
+            send_string_queue_register(UNICODE_KEY_MAC);
             break;
         case UC_LNX:
-            tap_code16(UNICODE_KEY_LNX);
+            send_string_queue_tap16(UNICODE_KEY_LNX);
             break;
         case UC_WIN:
-            register_code(KC_LALT);
-            tap_code(KC_PPLS);
+            send_string_queue_register(KC_LALT);
+            send_string_queue_tap(KC_PPLS);
             break;
         case UC_WINC:
-            tap_code(UNICODE_KEY_WINC);
-            tap_code(KC_U);
+            send_string_queue_tap(UNICODE_KEY_WINC);
+            send_string_queue_tap(KC_U);
             break;
     }
 
-    wait_ms(UNICODE_TYPE_DELAY);
+    send_string_queue_delay(UNICODE_TYPE_DELAY);
 }
 
 __attribute__((weak)) void unicode_input_finish(void) {
     switch (unicode_config.input_mode) {
         case UC_MAC:
-            unregister_code(UNICODE_KEY_MAC);
+            send_string_queue_unregister(UNICODE_KEY_MAC);
             break;
         case UC_LNX:
-            tap_code(KC_SPC);
+            send_string_queue_tap(KC_SPC);
             break;
         case UC_WIN:
-            unregister_code(KC_LALT);
+            send_string_queue_unregister(KC_LALT);
             break;
         case UC_WINC:
-            tap_code(KC_ENTER);
+            send_string_queue_tap(KC_ENTER);
             break;
     }
 
+#ifdef SEND_STRING_QUEUE_ENABLE
+    send_string_queue_restore_mods();
+#else
     set_mods(unicode_saved_mods);  // Reregister previously set mods
+#endif
 }
 
 __attribute__((weak)) void unicode_input_cancel(void) {
     switch (unicode_config.input_mode) {
         case UC_MAC:
-            unregister_code(UNICODE_KEY_MAC);
+            send_string_queue_unregister(UNICODE_KEY_MAC);
             break;
         case UC_LNX:
         case UC_WINC:
-            tap_code(KC_ESC);
+            send_string_queue_tap(KC_ESC);
             break;
         case UC_WIN:
-            unregister_code(KC_LALT);
+            send_string_queue_unregister(KC_LALT);
             break;
     }
 
+#ifdef SEND_STRING_QUEUE_ENABLE
+    send_string_queue_restore_mods();
+#else
     set_mods(unicode_saved_mods);  // Reregister previously set mods
+#endif
 }
 
 __attribute__((weak)) uint16_t hex_to_keycode(uint8_t hex) {
@@ -149,7 +161,7 @@ __attribute__((weak)) uint16_t hex_to_keycode(uint8_t hex) {
 void register_hex(uint16_t hex) {
     for (int i = 3; i >= 0; i--) {
         uint8_t digit = ((hex >> (i * 4)) & 0xF);
-        tap_code(hex_to_keycode(digit));
+        send_string_queue_tap(hex_to_keycode(digit));
     }
 }
 
@@ -162,10 +174,10 @@ void register_hex32(uint32_t hex) {
         uint8_t digit = ((hex >> (i * 4)) & 0xF);
         if (digit == 0) {
             if (!onzerostart) {
-                tap_code(hex_to_keycode(digit));
+                send_string_queue_tap(hex_to_keycode(digit));
             }
         } else {
-            tap_code(hex_to_keycode(digit));
+            send_string_queue_tap(hex_to_keycode(digit));
             onzerostart = false;
         }
     }
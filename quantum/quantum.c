@@ -50,6 +50,9 @@ extern backlight_config_t backlight_config;
 #    include "encoder.h"
 #endif
 
+#include "process_dispatch.h"
+#include "scan_profile.h"
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -144,6 +147,9 @@ void reset_keyboard(void) {
 #endif
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
+#endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_flush();
 #endif
     bootloader_jump();
 }
@@ -181,107 +187,141 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
-/* Core keycode function, hands off handling to other functions,
-    then processes internal quantum keycodes, and then processes
-    ACTIONs.                                                      */
-bool process_record_quantum(keyrecord_t *record) {
-    uint16_t keycode = get_record_keycode(record, true);
-
-    // This is how you use actions here
-    // if (keycode == KC_LEAD) {
-    //   action_t action;
-    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
-    //   process_action(record, action);
-    //   return false;
-    // }
-
-#ifdef VELOCIKEY_ENABLE
-    if (velocikey_enabled() && record->event.pressed) {
-        velocikey_accelerate();
-    }
-#endif
-
-#ifdef WPM_ENABLE
-    if (record->event.pressed) {
-        update_wpm(keycode);
-    }
-#endif
-
-#ifdef TAP_DANCE_ENABLE
-    preprocess_tap_dance(keycode, record);
+#if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
+static bool process_rgb_keycodes(uint16_t keycode, keyrecord_t *record) { return process_rgb(keycode, record); }
 #endif
 
-    if (!(
-#if defined(KEY_LOCK_ENABLE)
-            // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
-#endif
+/* The process_* stages, in the order they run. Each one is only called for the
+ * keycodes it handles, so a plain alpha key skips the stages that would just
+ * range check it and return true. Stages that must see every event use
+ * PROCESS_ALL; keep the ranges in step with the keycodes each stage handles.
+ */
+static const process_dispatch_entry_t process_record_handlers[] = {
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
-            // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+    // Must run asap to ensure all keypresses are recorded.
+    PROCESS_ALL(process_dynamic_macro),
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+    PROCESS_ALL(process_clicky),
 #endif  // AUDIO_CLICKY
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+    PROCESS_ALL(process_haptic),
 #endif  // HAPTIC_ENABLE
 #if defined(RGB_MATRIX_ENABLE)
-            process_rgb_matrix(keycode, record) &&
+    PROCESS_ALL(process_rgb_matrix),
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+    PROCESS_ALL(process_record_via),
 #endif
-            process_record_kb(keycode, record) &&
+    PROCESS_ALL(process_record_kb),
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+    PROCESS_RANGE(process_midi, MIDI_TONE_MIN, MI_BENDU),
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+    PROCESS_RANGE(process_audio, AU_ON, AU_TOG),
+    PROCESS_RANGE(process_audio, MUV_IN, MUV_DE),
 #endif
 #ifdef BACKLIGHT_ENABLE
-            process_backlight(keycode, record) &&
+    PROCESS_RANGE(process_backlight, BL_ON, BL_BRTG),
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+    PROCESS_RANGE(process_steno, QK_STENO, QK_STENO_MAX),
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+    PROCESS_ALL(process_music),
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+    PROCESS_ALL(process_tap_dance),
 #endif
-#if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
-            process_unicode_common(keycode, record) &&
+#if defined(UCIS_ENABLE)
+    PROCESS_ALL(process_unicode_common),
+#elif defined(UNICODE_ENABLE)
+    PROCESS_RANGE(process_unicode_common, UNICODE_MODE_FORWARD, UNICODE_MODE_WINC),
+    PROCESS_RANGE(process_unicode_common, QK_UNICODE, QK_UNICODE_MAX),
+#elif defined(UNICODEMAP_ENABLE)
+    PROCESS_RANGE(process_unicode_common, UNICODE_MODE_FORWARD, UNICODE_MODE_WINC),
+    PROCESS_RANGE(process_unicode_common, QK_UNICODEMAP, QK_UNICODEMAP_PAIR_MAX),
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+    PROCESS_ALL(process_leader),
 #endif
 #ifdef COMBO_ENABLE
-            process_combo(keycode, record) &&
+    PROCESS_ALL(process_combo),
 #endif
 #ifdef PRINTING_ENABLE
-            process_printer(keycode, record) &&
+    PROCESS_ALL(process_printer),
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+    PROCESS_ALL(process_auto_shift),
 #endif
 #ifdef TERMINAL_ENABLE
-            process_terminal(keycode, record) &&
+    PROCESS_ALL(process_terminal),
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+    PROCESS_ALL(process_space_cadet),
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+    PROCESS_RANGE(process_magic, MAGIC_SWAP_CONTROL_CAPSLOCK, MAGIC_TOGGLE_ALT_GUI),
+    PROCESS_RANGE(process_magic, MAGIC_SWAP_LCTL_LGUI, MAGIC_EE_HANDS_RIGHT),
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+    PROCESS_KEYCODE(process_grave_esc, GRAVE_ESC),
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+    PROCESS_RANGE(process_rgb_keycodes, RGB_TOG, RGB_MODE_RGBTEST),
+#endif
+};
+
+PROCESS_DISPATCH_DEFINE(process_record_dispatch, process_record_handlers);
+
+#ifdef SCAN_PROFILE_ENABLE
+scan_profile_stats_t process_record_stage_stats[sizeof(process_record_handlers) / sizeof(process_record_handlers[0])];
+const uint8_t        process_record_stage_count = sizeof(process_record_handlers) / sizeof(process_record_handlers[0]);
+
+const char *process_record_stage_name(uint8_t index) { return index < process_record_stage_count ? process_record_handlers[index].name : NULL; }
+#endif
+
+/* Core keycode function, hands off handling to other functions,
+    then processes internal quantum keycodes, and then processes
+    ACTIONs.                                                      */
+bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, true);
+
+    // This is how you use actions here
+    // if (keycode == KC_LEAD) {
+    //   action_t action;
+    //   action.code = ACTION_DEFAULT_LAYER_SET(0);
+    //   process_action(record, action);
+    //   return false;
+    // }
+
+#ifdef VELOCIKEY_ENABLE
+    if (velocikey_enabled() && record->event.pressed) {
+        velocikey_accelerate();
+    }
+#endif
+
+#ifdef WPM_ENABLE
+    if (record->event.pressed) {
+        update_wpm(keycode);
+    }
 #endif
-            true)) {
+
+#ifdef TAP_DANCE_ENABLE
+    preprocess_tap_dance(keycode, record);
+#endif
+
+#if defined(KEY_LOCK_ENABLE)
+    // Must run first to be able to mask key_up events.
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_KEY_LOCK);
+    bool key_lock_result = process_key_lock(&keycode, record);
+    SCAN_PROFILE_END(SCAN_PROFILE_KEY_LOCK);
+    if (!key_lock_result) {
+        return false;
+    }
+#endif
+
+    if (!process_record_dispatch(keycode, record)) {
         return false;
     }
 
@@ -433,6 +473,11 @@ void send_string(const char *str) { send_string_with_delay(str, 0); }
 
 void send_string_P(const char *str) { send_string_with_delay_P(str, 0); }
 
+#ifdef SEND_STRING_QUEUE_ENABLE
+void send_string_with_delay(const char *str, uint8_t interval) { send_string_queue_string(str, interval); }
+
+void send_string_with_delay_P(const char *str, uint8_t interval) { send_string_queue_string_P(str, interval); }
+#else
 void send_string_with_delay(const char *str, uint8_t interval) {
     while (1) {
         char ascii_code = *str;
@@ -516,6 +561,7 @@ void send_string_with_delay_P(const char *str, uint8_t interval) {
         }
     }
 }
+#endif
 
 void send_char(char ascii_code) {
 #if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
@@ -530,17 +576,17 @@ void send_char(char ascii_code) {
     bool    is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
 
     if (is_shifted) {
-        register_code(KC_LSFT);
+        send_string_queue_register(KC_LSFT);
     }
     if (is_altgred) {
-        register_code(KC_RALT);
+        send_string_queue_register(KC_RALT);
     }
-    tap_code(keycode);
+    send_string_queue_tap(keycode);
     if (is_altgred) {
-        unregister_code(KC_RALT);
+        send_string_queue_unregister(KC_RALT);
     }
     if (is_shifted) {
-        unregister_code(KC_LSFT);
+        send_string_queue_unregister(KC_LSFT);
     }
 }
 
@@ -621,6 +667,9 @@ void matrix_init_quantum() {
 #ifdef ENCODER_ENABLE
     encoder_init();
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_init();
+#endif
 #if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
     unicode_input_mode_init();
 #endif
@@ -639,7 +688,15 @@ void matrix_init_quantum() {
 
 void matrix_scan_quantum() {
 #if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_MUSIC);
     matrix_scan_music();
+    SCAN_PROFILE_END(SCAN_PROFILE_MUSIC);
+#endif
+
+#ifdef AUDIO_ENABLE
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_AUDIO);
+    audio_task();
+    SCAN_PROFILE_END(SCAN_PROFILE_AUDIO);
 #endif
 
 #ifdef TAP_DANCE_ENABLE
@@ -655,7 +712,9 @@ void matrix_scan_quantum() {
 #endif
 
 #ifdef RGB_MATRIX_ENABLE
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_RGB_MATRIX);
     rgb_matrix_task();
+    SCAN_PROFILE_END(SCAN_PROFILE_RGB_MATRIX);
 #endif
 
 #ifdef ENCODER_ENABLE
@@ -674,6 +733,12 @@ void matrix_scan_quantum() {
     dip_switch_read(false);
 #endif
 
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_task();
+#endif
+
+    send_string_queue_task();
+
     matrix_scan_kb();
 }
 
@@ -705,16 +770,16 @@ void send_byte(uint8_t number) {
 void send_nibble(uint8_t number) {
     switch (number) {
         case 0:
-            register_code(KC_0);
-            unregister_code(KC_0);
+            send_string_queue_register(KC_0);
+            send_string_queue_unregister(KC_0);
             break;
         case 1 ... 9:
-            register_code(KC_1 + (number - 1));
-            unregister_code(KC_1 + (number - 1));
+            send_string_queue_register(KC_1 + (number - 1));
+            send_string_queue_unregister(KC_1 + (number - 1));
             break;
         case 0xA ... 0xF:
-            register_code(KC_A + (number - 0xA));
-            unregister_code(KC_A + (number - 0xA));
+            send_string_queue_register(KC_A + (number - 0xA));
+            send_string_queue_unregister(KC_A + (number - 0xA));
             break;
     }
 }
@@ -58,6 +58,7 @@
 #include "action_util.h"
 #include "print.h"
 #include "send_string_keycodes.h"
+#include "send_string_queue.h"
 #include "suspend.h"
 #include <stddef.h>
 #include <stdlib.h>
@@ -199,6 +200,12 @@ typedef uint8_t pin_t;
 
 #    define togglePin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin)&0xF))
 
+typedef uint8_t port_data_t;
+
+#    define readPinPort(pin) ((port_data_t)PINx_ADDRESS(pin))
+#    define samePinPort(a, b) (((a) >> PORT_SHIFTER) == ((b) >> PORT_SHIFTER))
+#    define getPinPad(pin) ((pin)&0xF)
+
 #elif defined(PROTOCOL_CHIBIOS)
 typedef ioline_t pin_t;
 
@@ -214,6 +221,12 @@ typedef ioline_t pin_t;
 #    define readPin(pin) palReadLine(pin)
 
 #    define togglePin(pin) palToggleLine(pin)
+
+typedef ioportmask_t port_data_t;
+
+#    define readPinPort(pin) ((port_data_t)palReadPort(PAL_PORT(pin)))
+#    define samePinPort(a, b) (PAL_PORT(a) == PAL_PORT(b))
+#    define getPinPad(pin) PAL_PAD(pin)
 #endif
 
 #define SEND_STRING(string) send_string_P(PSTR(string))
@@ -261,6 +274,7 @@ uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache);
 bool     process_action_kb(keyrecord_t *record);
 bool     process_record_kb(uint16_t keycode, keyrecord_t *record);
 bool     process_record_user(uint16_t keycode, keyrecord_t *record);
+bool     process_record_dispatch(uint16_t keycode, keyrecord_t *record);
 void     post_process_record_kb(uint16_t keycode, keyrecord_t *record);
 void     post_process_record_user(uint16_t keycode, keyrecord_t *record);
 
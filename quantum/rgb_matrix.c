@@ -32,6 +32,7 @@ const point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
 // Generic effect runners
+#include "rgb_matrix_runners/effect_runner_batch.h"
 #include "rgb_matrix_runners/effect_runner_dx_dy_dist.h"
 #include "rgb_matrix_runners/effect_runner_dx_dy.h"
 #include "rgb_matrix_runners/effect_runner_i.h"
@@ -253,6 +254,53 @@ static uint8_t         rgb_last_effect   = UINT8_MAX;
 static effect_params_t rgb_effect_params = {0, 0xFF};
 static rgb_task_states rgb_task_state    = SYNCING;
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+// Measured cost of rendering one LED of each effect in 1/16 us, 0 until measured
+static uint16_t rgb_effect_cost[RGB_MATRIX_EFFECT_MAX];
+
+// Number of LEDs of the effect that can be rendered within the budget
+static uint8_t rgb_task_chunk_size(uint8_t effect) {
+    uint16_t cost = rgb_effect_cost[effect];
+    if (cost == 0) {
+        // start small until the effect has been measured
+        return 1;
+    }
+    uint32_t count = ((uint32_t)RGB_MATRIX_RENDER_BUDGET_US << 4) / cost;
+    if (count < 1) return 1;
+    if (count > UINT8_MAX) return UINT8_MAX;
+    return count;
+}
+
+static void rgb_task_account(uint8_t effect, uint32_t elapsed_us, uint8_t count) {
+    if (count == 0) {
+        // nothing was left to render, the call only finished the frame
+        return;
+    }
+    uint32_t sample = (elapsed_us << 4) / count;
+    if (sample > UINT16_MAX) sample = UINT16_MAX;
+
+    // average over the last few chunks, so changes like the number of hits in the splash effects are followed quickly
+    uint32_t cost = rgb_effect_cost[effect];
+    cost          = cost == 0 ? sample : (cost * 3 + sample) / 4;
+
+    rgb_effect_cost[effect] = cost > 0 ? cost : 1;
+}
+
+uint16_t rgb_matrix_get_effect_cost(uint8_t mode) { return mode < RGB_MATRIX_EFFECT_MAX ? rgb_effect_cost[mode] : 0; }
+
+static void rgb_matrix_debug_effect_cost(uint8_t mode) {
+    dprintf("rgb_matrix effect %u: %u.%02u us per LED\n", mode, rgb_effect_cost[mode] >> 4, (rgb_effect_cost[mode] & 0xF) * 100 / 16);
+}
+
+void rgb_matrix_debug_effect_costs(void) {
+    for (uint8_t mode = 0; mode < RGB_MATRIX_EFFECT_MAX; mode++) {
+        if (rgb_effect_cost[mode] != 0) {
+            rgb_matrix_debug_effect_cost(mode);
+        }
+    }
+}
+#endif
+
 static void rgb_task_timers(void) {
     // Update double buffer timers
     uint16_t deltaTime  = timer_elapsed32(rgb_counters_buffer);
@@ -286,6 +334,9 @@ static void rgb_task_sync(void) {
 static void rgb_task_start(void) {
     // reset iter
     rgb_effect_params.iter = 0;
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_effect_params.led_min = 0;
+#endif
 
     // update double buffers
     g_rgb_counters.tick = rgb_counters_buffer;
@@ -300,6 +351,11 @@ static void rgb_task_start(void) {
 static void rgb_task_render(uint8_t effect) {
     bool rendering         = false;
     rgb_effect_params.init = (effect != rgb_last_effect) || (rgb_matrix_config.enable != rgb_last_enable);
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    // effects using RGB_MATRIX_USE_LIMITS cut this down to the number of LEDs they rendered
+    rgb_effect_params.led_count = effect < RGB_MATRIX_EFFECT_MAX ? rgb_task_chunk_size(effect) : UINT8_MAX;
+    uint32_t render_start       = timer_read_us32();
+#endif
 
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
@@ -341,6 +397,10 @@ static void rgb_task_render(uint8_t effect) {
             return;
     }
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_task_account(effect, timer_elapsed_us32(render_start), rgb_effect_params.led_count);
+    rgb_effect_params.led_min += rgb_effect_params.led_count;
+#endif
     rgb_effect_params.iter++;
 
     // next task
@@ -354,6 +414,13 @@ static void rgb_task_render(uint8_t effect) {
 }
 
 static void rgb_task_flush(uint8_t effect) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    // report what the previous effect cost when switching away from it
+    if (effect != rgb_last_effect && rgb_last_effect < RGB_MATRIX_EFFECT_MAX) {
+        rgb_matrix_debug_effect_cost(rgb_last_effect);
+    }
+#endif
+
     // update last trackers after the first full render so we can init over several frames
     rgb_last_effect = effect;
     rgb_last_enable = rgb_matrix_config.enable;
@@ -44,17 +44,27 @@
 #    define RGB_MATRIX_LED_PROCESS_LIMIT (DRIVER_LED_TOTAL + 4) / 5
 #endif
 
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
-#    define RGB_MATRIX_USE_LIMITS(min, max)                        \
+// Range of the items (usually LEDs) out of total to process in this render call
+#if defined(RGB_MATRIX_RENDER_BUDGET_US)
+// led_count is handed back with the number actually rendered, which the scheduler accounts the time to
+#    define RGB_MATRIX_USE_LIMITS_TOTAL(min, max, total)                                       \
+        uint8_t min = params->led_min;                                                         \
+        uint8_t max = ((total) > min + params->led_count) ? min + params->led_count : (total); \
+        if (max < min) max = min;                                                              \
+        params->led_count = max - min;
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#    define RGB_MATRIX_USE_LIMITS_TOTAL(min, max, total)           \
         uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter; \
         uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;          \
-        if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
+        if (max > (total)) max = (total);
 #else
-#    define RGB_MATRIX_USE_LIMITS(min, max) \
-        uint8_t min = 0;                    \
-        uint8_t max = DRIVER_LED_TOTAL;
+#    define RGB_MATRIX_USE_LIMITS_TOTAL(min, max, total) \
+        uint8_t min = 0;                                 \
+        uint8_t max = (total);
 #endif
 
+#define RGB_MATRIX_USE_LIMITS(min, max) RGB_MATRIX_USE_LIMITS_TOTAL(min, max, DRIVER_LED_TOTAL)
+
 #define RGB_MATRIX_TEST_LED_FLAGS() \
     if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
 
@@ -124,6 +134,10 @@ void        rgb_matrix_set_flags(led_flags_t flags);
 void        rgb_matrix_mode(uint8_t mode);
 void        rgb_matrix_mode_noeeprom(uint8_t mode);
 uint8_t     rgb_matrix_get_mode(void);
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+uint16_t rgb_matrix_get_effect_cost(uint8_t mode);
+void     rgb_matrix_debug_effect_costs(void);
+#endif
 void        rgb_matrix_sethsv(uint16_t hue, uint8_t sat, uint8_t val);
 void        rgb_matrix_sethsv_noeeprom(uint16_t hue, uint8_t sat, uint8_t val);
 
@@ -22,7 +22,14 @@ bool DIGITAL_RAIN(effect_params_t* params) {
         drop = 0;
     }
 
-    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+#        ifdef RGB_MATRIX_RENDER_BUDGET_US
+    // Work off of the columns, the drops only fall once all of them are rendered
+    RGB_MATRIX_USE_LIMITS_TOTAL(col_min, col_max, MATRIX_COLS);
+#        else
+    const uint8_t col_min = 0;
+    const uint8_t col_max = MATRIX_COLS;
+#        endif
+    for (uint8_t col = col_min; col < col_max; col++) {
         for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
             if (row == 0 && drop == 0 && rand() < RAND_MAX / RGB_DIGITAL_RAIN_DROPS) {
                 // top row, pixels have just fallen and we're
@@ -49,6 +56,10 @@ bool DIGITAL_RAIN(effect_params_t* params) {
         }
     }
 
+    if (col_max < MATRIX_COLS) {
+        return true;
+    }
+
     if (++drop > drop_ticks) {
         // reset drop timer
         drop = 0;
@@ -99,22 +99,39 @@ const rgb_matrix_driver_t rgb_matrix_driver = {
 
 // LED color buffer
 LED_TYPE led[DRIVER_LED_TOTAL];
+// The chain can only be written as a whole, so only track whether any LED changed
+static bool led_dirty = true;
 
 static void init(void) {}
 
 static void flush(void) {
+    if (!led_dirty) {
+        return;
+    }
     // Assumes use of RGB_DI_PIN
     ws2812_setleds(led, DRIVER_LED_TOTAL);
+    led_dirty = false;
 }
 
 // Set an led in the buffer to a color
 static inline void setled(int i, uint8_t r, uint8_t g, uint8_t b) {
+#    ifdef RGBW
+    // the white channel was taken out of the stored color
+    if (led[i].r + led[i].w == r && led[i].g + led[i].w == g && led[i].b + led[i].w == b) {
+        return;
+    }
+#    else
+    if (led[i].r == r && led[i].g == g && led[i].b == b) {
+        return;
+    }
+#    endif
     led[i].r = r;
     led[i].g = g;
     led[i].b = b;
 #    ifdef RGBW
     convert_rgb_to_rgbw(led[i]);
 #    endif
+    led_dirty = true;
 }
 
 static void setled_all(uint8_t r, uint8_t g, uint8_t b) {
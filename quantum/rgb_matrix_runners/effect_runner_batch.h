@@ -0,0 +1,27 @@
+#pragma once
+
+// Runners queue the colors they compute and convert them to RGB four at a time with hsv_to_rgb_array.
+#define RGB_MATRIX_HSV_BATCH_SIZE 4
+
+typedef struct {
+    uint8_t count;
+    uint8_t led[RGB_MATRIX_HSV_BATCH_SIZE];
+    HSV     hsv[RGB_MATRIX_HSV_BATCH_SIZE];
+} hsv_batch_t;
+
+static void hsv_batch_flush(hsv_batch_t* batch) {
+    RGB rgb[RGB_MATRIX_HSV_BATCH_SIZE];
+    hsv_to_rgb_array(batch->hsv, rgb, batch->count);
+    for (uint8_t i = 0; i < batch->count; i++) {
+        rgb_matrix_set_color(batch->led[i], rgb[i].r, rgb[i].g, rgb[i].b);
+    }
+    batch->count = 0;
+}
+
+static inline void hsv_batch_set_color(hsv_batch_t* batch, uint8_t led, HSV hsv) {
+    batch->led[batch->count] = led;
+    batch->hsv[batch->count] = hsv;
+    if (++batch->count == RGB_MATRIX_HSV_BATCH_SIZE) {
+        hsv_batch_flush(batch);
+    }
+}
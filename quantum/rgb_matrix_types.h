@@ -41,6 +41,11 @@ typedef struct PACKED {
     uint8_t     iter;
     led_flags_t flags;
     bool        init;
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    // range of the current chunk, picked by the render scheduler; the effect sets led_count to what it rendered
+    uint8_t led_min;
+    uint8_t led_count;
+#endif
 } effect_params_t;
 
 typedef struct PACKED {
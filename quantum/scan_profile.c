@@ -0,0 +1,214 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include "scan_profile.h"
+#include "print.h"
+
+static scan_profile_stats_t       stats[SCAN_PROFILE_PROCESS];
+static const scan_profile_stats_t no_stats;
+
+static uint32_t key_event_start;
+static bool     key_event_pending = false;
+
+static const char *const stage_names[SCAN_PROFILE_PROCESS] = {
+    [SCAN_PROFILE_SCAN_LOOP]          = "scan loop",
+    [SCAN_PROFILE_MATRIX_SCAN]        = "matrix_scan",
+    [SCAN_PROFILE_DEBOUNCE]           = "debounce",
+    [SCAN_PROFILE_ACTION_EXEC]        = "action_exec",
+    [SCAN_PROFILE_HOST_KEYBOARD_SEND] = "host_keyboard_send",
+    [SCAN_PROFILE_KEY_TO_REPORT]      = "key to report",
+#ifdef RGBLIGHT_ENABLE
+    [SCAN_PROFILE_RGBLIGHT] = "rgblight_task",
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    [SCAN_PROFILE_RGB_MATRIX] = "rgb_matrix_task",
+#endif
+#ifdef OLED_DRIVER_ENABLE
+    [SCAN_PROFILE_OLED] = "oled_task",
+#endif
+#if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
+    [SCAN_PROFILE_MUSIC] = "matrix_scan_music",
+#endif
+#ifdef AUDIO_ENABLE
+    [SCAN_PROFILE_AUDIO] = "audio_task",
+#endif
+#ifdef KEY_LOCK_ENABLE
+    [SCAN_PROFILE_KEY_LOCK] = "process_key_lock",
+#endif
+};
+
+// The stages up to SCAN_PROFILE_PROCESS live here, the process_* ones next to their table
+static scan_profile_stats_t *stage_stats(uint8_t stage) {
+    if (stage < SCAN_PROFILE_PROCESS) {
+        return &stats[stage];
+    }
+    if (stage - SCAN_PROFILE_PROCESS < process_record_stage_count) {
+        return &process_record_stage_stats[stage - SCAN_PROFILE_PROCESS];
+    }
+    return NULL;
+}
+
+uint8_t scan_profile_stage_count(void) { return SCAN_PROFILE_PROCESS + process_record_stage_count; }
+
+void scan_profile_record(uint8_t stage, uint32_t elapsed_us) {
+    scan_profile_stats_t *s = stage_stats(stage);
+    if (!s) {
+        return;
+    }
+
+    uint16_t us = elapsed_us > UINT16_MAX ? UINT16_MAX : elapsed_us;
+
+    if (s->count == UINT16_MAX) {
+        // Halve everything rather than wrap, which keeps the average and the
+        // shape of the histogram
+        s->sum >>= 1;
+        s->count >>= 1;
+        for (uint8_t i = 0; i < SCAN_PROFILE_BUCKETS; i++) {
+            s->buckets[i] >>= 1;
+        }
+    }
+
+    if (s->count == 0 || us < s->min) {
+        s->min = us;
+    }
+    if (us > s->max) {
+        s->max = us;
+    }
+    s->sum += us;
+    s->count++;
+
+    uint8_t bucket = 0;
+    for (uint16_t limit = 16; bucket < SCAN_PROFILE_BUCKETS - 1 && us >= limit; limit <<= 1) {
+        bucket++;
+    }
+    s->buckets[bucket]++;
+}
+
+void scan_profile_key_event(uint32_t scan_start_us) {
+    // Latency is counted from the oldest change still waiting on a report
+    if (!key_event_pending) {
+        key_event_start   = scan_start_us;
+        key_event_pending = true;
+    }
+}
+
+void scan_profile_report_sent(void) {
+    if (key_event_pending) {
+        scan_profile_record(SCAN_PROFILE_KEY_TO_REPORT, timer_read_us32() - key_event_start);
+        key_event_pending = false;
+    }
+}
+
+void scan_profile_reset(void) {
+    memset(stats, 0, sizeof(stats));
+    memset(process_record_stage_stats, 0, process_record_stage_count * sizeof(scan_profile_stats_t));
+}
+
+const scan_profile_stats_t *scan_profile_get(uint8_t stage) { return stage_stats(stage); }
+
+const char *scan_profile_stage_name(uint8_t stage) {
+    if (stage < SCAN_PROFILE_PROCESS) {
+        return stage_names[stage];
+    }
+    return process_record_stage_name(stage - SCAN_PROFILE_PROCESS);
+}
+
+uint16_t scan_profile_average(const scan_profile_stats_t *s) { return s->count ? s->sum / s->count : 0; }
+
+void scan_profile_print(void) {
+    xprintf("scan profile, us: min/avg/max count [<16 <32 <64 <128 <256 <512 <1024 >=1024]\n");
+    for (uint8_t stage = 0; stage < scan_profile_stage_count(); stage++) {
+        const scan_profile_stats_t *s    = stage_stats(stage);
+        const char *                name = scan_profile_stage_name(stage);
+        if (!s->count || !name) {
+            continue;
+        }
+        xprintf("%s: %u/%u/%u %u [", name, s->min, scan_profile_average(s), s->max, s->count);
+        for (uint8_t i = 0; i < SCAN_PROFILE_BUCKETS; i++) {
+            xprintf(i ? " %u" : "%u", s->buckets[i]);
+        }
+        xprintf("]\n");
+    }
+}
+
+void scan_profile_task(void) {
+    // Don't let a key that never produced a report (a layer key, say) blame
+    // the next report for all the time in between
+    if (key_event_pending && timer_elapsed_us32(key_event_start) > SCAN_PROFILE_LATENCY_LIMIT * 1000UL) {
+        key_event_pending = false;
+    }
+
+#if SCAN_PROFILE_PRINT_INTERVAL > 0
+    static uint32_t print_timer = 0;
+    if (timer_elapsed32(print_timer) > SCAN_PROFILE_PRINT_INTERVAL) {
+        print_timer = timer_read32();
+        scan_profile_print();
+        scan_profile_reset();
+    }
+#endif
+}
+
+static uint8_t *put_u16(uint8_t *out, uint16_t value) {
+    out[0] = value >> 8;
+    out[1] = value & 0xFF;
+    return out + 2;
+}
+
+bool scan_profile_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 4 || data[0] != SCAN_PROFILE_RAW_HID_ID) {
+        return false;
+    }
+
+    uint8_t  stage = data[2];
+    uint8_t *out   = &data[4];
+    uint8_t *end   = &data[length];
+
+    data[3] = scan_profile_stage_count();
+    memset(out, 0, end - out);
+
+    switch (data[1]) {
+        case scan_profile_raw_hid_get: {
+            const scan_profile_stats_t *s = scan_profile_get(stage);
+            if (!s) {
+                s = &no_stats;
+            }
+            uint16_t values[4 + SCAN_PROFILE_BUCKETS] = {s->min, scan_profile_average(s), s->max, s->count};
+            memcpy(&values[4], s->buckets, sizeof(s->buckets));
+            for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]) && out + 2 <= end; i++) {
+                out = put_u16(out, values[i]);
+            }
+            break;
+        }
+        case scan_profile_raw_hid_name: {
+            const char *name  = scan_profile_stage_name(stage);
+            int16_t     space = end - out;
+            // a short report has no room for the name and its terminator
+            if (name && space > 1) {
+                strncpy((char *)out, name, space - 1);
+                out[space - 1] = 0;
+            }
+            break;
+        }
+        case scan_profile_raw_hid_reset:
+            scan_profile_reset();
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
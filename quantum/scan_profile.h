@@ -0,0 +1,137 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "timer.h"
+
+/* Scan loop profiling.
+ *
+ * Timestamp probes around the parts of the scan loop that can eat into its
+ * budget. Each stage keeps min/avg/max and a log2 histogram of its run times in
+ * microseconds, plus the time from the scan that saw a key change to the
+ * keyboard report it produced. The numbers are printed on the console every
+ * SCAN_PROFILE_PRINT_INTERVAL ms and can be read over raw HID.
+ *
+ * Every entry of the process_record_quantum dispatch table gets a stage of its
+ * own after SCAN_PROFILE_PROCESS, so the stage count depends on the features
+ * built in.
+ */
+
+#ifndef SCAN_PROFILE_PRINT_INTERVAL
+#    define SCAN_PROFILE_PRINT_INTERVAL 5000
+#endif
+
+// A key change that has not produced a report after this many ms is dropped
+#ifndef SCAN_PROFILE_LATENCY_LIMIT
+#    define SCAN_PROFILE_LATENCY_LIMIT 500
+#endif
+
+#ifndef SCAN_PROFILE_RAW_HID_ID
+#    define SCAN_PROFILE_RAW_HID_ID 0xF0
+#endif
+
+// Bucket n counts samples under 2^(n+4) us; the last one takes everything above
+#define SCAN_PROFILE_BUCKETS 8
+
+enum scan_profile_stage {
+    SCAN_PROFILE_SCAN_LOOP,
+    SCAN_PROFILE_MATRIX_SCAN,
+    SCAN_PROFILE_DEBOUNCE,
+    SCAN_PROFILE_ACTION_EXEC,
+    SCAN_PROFILE_HOST_KEYBOARD_SEND,
+    SCAN_PROFILE_KEY_TO_REPORT,
+#ifdef RGBLIGHT_ENABLE
+    SCAN_PROFILE_RGBLIGHT,
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    SCAN_PROFILE_RGB_MATRIX,
+#endif
+#ifdef OLED_DRIVER_ENABLE
+    SCAN_PROFILE_OLED,
+#endif
+#if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
+    SCAN_PROFILE_MUSIC,
+#endif
+#ifdef AUDIO_ENABLE
+    SCAN_PROFILE_AUDIO,
+#endif
+#ifdef KEY_LOCK_ENABLE
+    SCAN_PROFILE_KEY_LOCK,
+#endif
+    SCAN_PROFILE_PROCESS,
+};
+
+typedef struct {
+    uint32_t sum;
+    uint16_t count;
+    uint16_t min;
+    uint16_t max;
+    uint16_t buckets[SCAN_PROFILE_BUCKETS];
+} scan_profile_stats_t;
+
+/* Raw HID requests are [SCAN_PROFILE_RAW_HID_ID, command, stage]. Replies start
+ * with the same three bytes, followed by the stage count and then:
+ *   get:   min, avg, max and count as big endian uint16, then the buckets
+ *   name:  the stage name, NUL terminated and truncated to fit
+ *   reset: nothing, all stages are cleared
+ */
+enum scan_profile_raw_hid_command {
+    scan_profile_raw_hid_get   = 0x01,
+    scan_profile_raw_hid_name  = 0x02,
+    scan_profile_raw_hid_reset = 0x03,
+};
+
+#ifdef SCAN_PROFILE_ENABLE
+#    define SCAN_PROFILE_BEGIN(stage) const uint32_t stage##_start = timer_read_us32()
+#    define SCAN_PROFILE_END(stage) scan_profile_record(stage, timer_read_us32() - stage##_start)
+// Marks a key change seen by the matrix scan profiled as `stage`
+#    define SCAN_PROFILE_KEY_EVENT(stage) scan_profile_key_event(stage##_start)
+#else
+#    define SCAN_PROFILE_BEGIN(stage)
+#    define SCAN_PROFILE_END(stage)
+#    define SCAN_PROFILE_KEY_EVENT(stage)
+#endif
+
+void scan_profile_record(uint8_t stage, uint32_t elapsed_us);
+void scan_profile_key_event(uint32_t scan_start_us);
+void scan_profile_report_sent(void);
+void scan_profile_reset(void);
+void scan_profile_print(void);
+void scan_profile_task(void);
+
+uint8_t                     scan_profile_stage_count(void);
+const scan_profile_stats_t *scan_profile_get(uint8_t stage);
+const char *                scan_profile_stage_name(uint8_t stage);
+uint16_t                    scan_profile_average(const scan_profile_stats_t *s);
+
+/** \brief Answers a scan profile request in place
+ *
+ * Returns false if `data` is not a scan profile request. Call this from
+ * raw_hid_receive() and send `data` back when it returns true; VIA does this
+ * for command IDs it does not know.
+ */
+bool scan_profile_raw_hid_receive(uint8_t *data, uint8_t length);
+
+/** \brief Name of entry `index` of the process_record_quantum dispatch table, or NULL */
+const char *process_record_stage_name(uint8_t index);
+
+/** \brief Stats of the process_record_quantum dispatch table entries, one per entry */
+extern scan_profile_stats_t process_record_stage_stats[];
+extern const uint8_t        process_record_stage_count;
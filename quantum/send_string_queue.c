@@ -0,0 +1,320 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ctype.h>
+#include <string.h>
+#include "quantum.h"
+#include "send_string_queue.h"
+#include "tmk_core/common/eeprom.h"
+
+#if SEND_STRING_QUEUE_SIZE > 128 || (SEND_STRING_QUEUE_SIZE & (SEND_STRING_QUEUE_SIZE - 1)) != 0
+#    error "SEND_STRING_QUEUE_SIZE must be a power of two no larger than 128"
+#endif
+
+#ifndef TAP_CODE_DELAY
+#    define TAP_CODE_DELAY 0
+#endif
+#ifndef TAP_HOLD_CAPS_DELAY
+#    define TAP_HOLD_CAPS_DELAY 80
+#endif
+
+// Most events a single character of a string can turn into: shift, altgr,
+// key, tap delay, release, altgr, shift and the interval
+#define SEND_STRING_QUEUE_CHAR_EVENTS 8
+
+// Each event packs its operation above a 13 bit keycode or delay
+#define SEND_STRING_QUEUE_OP_SHIFT 13
+#define SEND_STRING_QUEUE_ARG_MASK ((1 << SEND_STRING_QUEUE_OP_SHIFT) - 1)
+#define SEND_STRING_QUEUE_AT(i) (send_string_queue[(i) & (SEND_STRING_QUEUE_SIZE - 1)])
+
+enum send_string_queue_op {
+    SEND_STRING_QUEUE_DOWN,
+    SEND_STRING_QUEUE_UP,
+    SEND_STRING_QUEUE_DELAY,
+    SEND_STRING_QUEUE_CLEAR_MODS,
+    SEND_STRING_QUEUE_RESTORE_MODS,
+};
+
+// A string that is parsed a character at a time as the ring drains
+typedef struct {
+    const char *ptr;  // NULL when there is nothing left to read
+    uint8_t (*read)(const char *ptr);
+    uint8_t interval;
+    bool    prefixed;  // SEND_STRING() encoding rather than the dynamic keymap one
+} send_string_source_t;
+
+static uint16_t             send_string_queue[SEND_STRING_QUEUE_SIZE];
+static uint8_t              send_string_queue_head = 0;
+static uint8_t              send_string_queue_tail = 0;
+static send_string_source_t send_string_source     = {0};
+static bool                 send_string_expanding  = false;
+static uint16_t             send_string_delay_start;
+static uint16_t             send_string_delay      = 0;
+static uint16_t             send_string_last_report;
+static uint8_t              send_string_saved_mods;
+static bool                 send_string_mods_saved = false;
+// Keycodes the queue has pressed and not released yet, released on cancel
+static uint8_t              send_string_held[32];
+
+static uint8_t send_string_read_ram(const char *ptr) { return *ptr; }
+
+static uint8_t send_string_read_P(const char *ptr) { return pgm_read_byte(ptr); }
+
+static uint8_t send_string_read_eeprom(const char *ptr) { return eeprom_read_byte((const uint8_t *)ptr); }
+
+static uint8_t send_string_queue_depth(void) { return send_string_queue_head - send_string_queue_tail; }
+
+/** \brief Plays back queued events until one of them has to wait
+ *
+ * Produces at most one report, as does a delay that has not expired yet.
+ */
+static void send_string_queue_play(void) {
+    if (send_string_delay) {
+        if (timer_elapsed(send_string_delay_start) < send_string_delay) {
+            return;
+        }
+        send_string_delay = 0;
+    }
+
+    while (send_string_queue_head != send_string_queue_tail) {
+        uint16_t event   = SEND_STRING_QUEUE_AT(send_string_queue_tail);
+        uint8_t  op      = event >> SEND_STRING_QUEUE_OP_SHIFT;
+        uint16_t arg     = event & SEND_STRING_QUEUE_ARG_MASK;
+        uint8_t  keycode = arg;
+
+        switch (op) {
+            case SEND_STRING_QUEUE_DOWN:
+            case SEND_STRING_QUEUE_UP:
+                if (timer_elapsed(send_string_last_report) < SEND_STRING_QUEUE_REPORT_INTERVAL) {
+                    return;
+                }
+                send_string_queue_tail++;
+                if (op == SEND_STRING_QUEUE_DOWN) {
+                    send_string_held[keycode / 8] |= 1 << (keycode % 8);
+                    register_code(keycode);
+                } else {
+                    send_string_held[keycode / 8] &= ~(1 << (keycode % 8));
+                    unregister_code(keycode);
+                }
+                send_string_last_report = timer_read();
+                return;
+            case SEND_STRING_QUEUE_DELAY:
+                send_string_queue_tail++;
+                send_string_delay_start = timer_read();
+                send_string_delay       = arg;
+                return;
+            case SEND_STRING_QUEUE_CLEAR_MODS:
+                send_string_queue_tail++;
+                send_string_saved_mods = get_mods();
+                send_string_mods_saved = true;
+                clear_mods();
+                break;
+            case SEND_STRING_QUEUE_RESTORE_MODS:
+                send_string_queue_tail++;
+                if (send_string_mods_saved) {
+                    set_mods(send_string_saved_mods);
+                    send_string_mods_saved = false;
+                }
+                break;
+        }
+    }
+}
+
+// Runs the playback in place of the scan loop until something has been played
+static void send_string_queue_wait(void) {
+    wait_ms(1);
+    send_string_queue_play();
+}
+
+static bool send_string_source_step(void);
+
+static void send_string_source_expand(void) {
+    send_string_expanding = true;
+    while (send_string_source_step()) {
+    }
+    send_string_expanding = false;
+}
+
+static void send_string_queue_push(uint8_t op, uint16_t arg) {
+    // anything queued from outside has to come after the rest of the string being typed
+    if (send_string_source.ptr && !send_string_expanding) {
+        send_string_source_expand();
+    }
+    while (send_string_queue_depth() == SEND_STRING_QUEUE_SIZE) {
+        send_string_queue_wait();
+    }
+    SEND_STRING_QUEUE_AT(send_string_queue_head) = (op << SEND_STRING_QUEUE_OP_SHIFT) | arg;
+    send_string_queue_head++;
+}
+
+void send_string_queue_register(uint8_t keycode) { send_string_queue_push(SEND_STRING_QUEUE_DOWN, keycode); }
+
+void send_string_queue_unregister(uint8_t keycode) { send_string_queue_push(SEND_STRING_QUEUE_UP, keycode); }
+
+void send_string_queue_tap(uint8_t keycode) {
+    send_string_queue_register(keycode);
+    send_string_queue_delay(keycode == KC_CAPS ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+    send_string_queue_unregister(keycode);
+}
+
+// Holds the modifiers of a QK_MODS keycode around the tap, like tap_code16() does
+void send_string_queue_tap16(uint16_t keycode) {
+    uint8_t mods = 0;
+    if (keycode >= QK_MODS && keycode <= QK_MODS_MAX) {
+        mods = (keycode >> 8) & 0x1F;
+    }
+    // bit 4 picks the right hand mods, the low nibble which of them are held
+    uint8_t first = (mods & 0x10) ? KC_RCTL : KC_LCTL;
+    for (uint8_t i = 0; i < 4; i++) {
+        if (mods & (1 << i)) {
+            send_string_queue_register(first + i);
+        }
+    }
+    send_string_queue_tap(keycode & 0xFF);
+    for (uint8_t i = 0; i < 4; i++) {
+        if (mods & (1 << i)) {
+            send_string_queue_unregister(first + i);
+        }
+    }
+}
+
+void send_string_queue_delay(uint16_t ms) {
+    while (ms > SEND_STRING_QUEUE_ARG_MASK) {
+        send_string_queue_push(SEND_STRING_QUEUE_DELAY, SEND_STRING_QUEUE_ARG_MASK);
+        ms -= SEND_STRING_QUEUE_ARG_MASK;
+    }
+    if (ms) {
+        send_string_queue_push(SEND_STRING_QUEUE_DELAY, ms);
+    }
+}
+
+void send_string_queue_clear_mods(void) { send_string_queue_push(SEND_STRING_QUEUE_CLEAR_MODS, 0); }
+
+void send_string_queue_restore_mods(void) { send_string_queue_push(SEND_STRING_QUEUE_RESTORE_MODS, 0); }
+
+uint8_t send_string_queue_get_mods(void) { return send_string_mods_saved ? send_string_saved_mods : get_mods(); }
+
+/** \brief Queues the events for the next character or code of the current source
+ *
+ * \return false once the end of the string has been reached
+ */
+static bool send_string_source_step(void) {
+    send_string_source_t *source = &send_string_source;
+    if (!source->ptr) {
+        return false;
+    }
+
+    uint8_t ascii_code = source->read(source->ptr);
+    uint8_t code       = 0;
+    if (!ascii_code) {
+        source->ptr = NULL;
+        return false;
+    }
+    if (source->prefixed) {
+        if (ascii_code == SS_QMK_PREFIX) {
+            code = source->read(++source->ptr);
+        }
+    } else if (ascii_code == SS_TAP_CODE || ascii_code == SS_DOWN_CODE || ascii_code == SS_UP_CODE) {
+        code = ascii_code;
+    }
+
+    if (code == SS_TAP_CODE || code == SS_DOWN_CODE || code == SS_UP_CODE) {
+        uint8_t keycode = source->read(++source->ptr);
+        if (!keycode) {
+            source->ptr = NULL;
+            return false;
+        }
+        if (code != SS_UP_CODE) {
+            send_string_queue_register(keycode);
+        }
+        if (code != SS_DOWN_CODE) {
+            send_string_queue_unregister(keycode);
+        }
+    } else if (code == SS_DELAY_CODE) {
+        uint16_t ms      = 0;
+        uint8_t  keycode = source->read(++source->ptr);
+        while (isdigit(keycode)) {
+            ms *= 10;
+            ms += keycode - '0';
+            keycode = source->read(++source->ptr);
+        }
+        send_string_queue_delay(ms);
+    } else if (!code) {
+        send_char(ascii_code);
+    }
+    ++source->ptr;
+    send_string_queue_delay(source->interval);
+    return true;
+}
+
+static void send_string_source_start(const char *str, uint8_t (*read)(const char *), uint8_t interval, bool prefixed) {
+    // finish off the previous string first so that the two do not interleave
+    if (send_string_source.ptr) {
+        send_string_source_expand();
+    }
+    send_string_source = (send_string_source_t){.ptr = str, .read = read, .interval = interval, .prefixed = prefixed};
+}
+
+void send_string_queue_string(const char *str, uint8_t interval) {
+    // the caller's buffer may be gone by the time the ring gets to it
+    send_string_source_start(str, send_string_read_ram, interval, true);
+    send_string_source_expand();
+}
+
+void send_string_queue_string_P(const char *str, uint8_t interval) { send_string_source_start(str, send_string_read_P, interval, true); }
+
+void send_string_queue_macro_eeprom(const void *addr) { send_string_source_start((const char *)addr, send_string_read_eeprom, 0, false); }
+
+bool send_string_queue_busy(void) { return send_string_queue_head != send_string_queue_tail || send_string_source.ptr || send_string_delay; }
+
+uint8_t send_string_queue_free(void) { return SEND_STRING_QUEUE_SIZE - send_string_queue_depth(); }
+
+void send_string_queue_cancel(void) {
+    send_string_source.ptr = NULL;
+    send_string_queue_tail = send_string_queue_head;
+    send_string_delay      = 0;
+    for (uint16_t keycode = 0; keycode < 256; keycode++) {
+        if (send_string_held[keycode / 8] & (1 << (keycode % 8))) {
+            unregister_code(keycode);
+        }
+    }
+    memset(send_string_held, 0, sizeof(send_string_held));
+    if (send_string_mods_saved) {
+        set_mods(send_string_saved_mods);
+        send_string_mods_saved = false;
+        send_keyboard_report();
+    }
+}
+
+void send_string_queue_flush(void) {
+    if (send_string_source.ptr) {
+        send_string_source_expand();
+    }
+    while (send_string_queue_busy()) {
+        send_string_queue_wait();
+    }
+}
+
+void send_string_queue_task(void) {
+    // keep the ring topped up from the string being typed without ever waiting on it
+    if (send_string_source.ptr && !send_string_expanding) {
+        send_string_expanding = true;
+        while (send_string_queue_free() >= SEND_STRING_QUEUE_CHAR_EVENTS && send_string_source_step()) {
+        }
+        send_string_expanding = false;
+    }
+    send_string_queue_play();
+}
@@ -0,0 +1,86 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Background typing queue.
+ *
+ * send_string(), send_char(), dynamic keymap macros and Unicode input push
+ * key presses, releases and delays onto a ring instead of blocking in
+ * wait_ms(). send_string_queue_task() plays them back from the scan loop, at
+ * most one keyboard report every SEND_STRING_QUEUE_REPORT_INTERVAL ms, so the
+ * matrix keeps being scanned while a macro types.
+ *
+ * Strings in PROGMEM and dynamic keymap macros in EEPROM are read lazily as
+ * the ring empties, so their length is not limited by its size. Strings in
+ * RAM may not outlive the call and are copied onto the ring straight away;
+ * when it is full the caller waits for playback to make room.
+ */
+
+#ifdef SEND_STRING_QUEUE_ENABLE
+
+// Number of queued key events, must be a power of two
+#    ifndef SEND_STRING_QUEUE_SIZE
+#        define SEND_STRING_QUEUE_SIZE 64
+#    endif
+
+// Minimum time between two reports produced by the queue
+#    ifndef SEND_STRING_QUEUE_REPORT_INTERVAL
+#        define SEND_STRING_QUEUE_REPORT_INTERVAL 1
+#    endif
+
+void send_string_queue_register(uint8_t keycode);
+void send_string_queue_unregister(uint8_t keycode);
+void send_string_queue_tap(uint8_t keycode);
+void send_string_queue_tap16(uint16_t keycode);
+void send_string_queue_delay(uint16_t ms);
+// Save and clear the modifiers when played back, send_string_queue_restore_mods() puts them back
+void send_string_queue_clear_mods(void);
+void send_string_queue_restore_mods(void);
+// The modifiers as they are held, even while the queue has them cleared
+uint8_t send_string_queue_get_mods(void);
+
+// Type a string in the SEND_STRING() format
+void send_string_queue_string(const char *str, uint8_t interval);
+void send_string_queue_string_P(const char *str, uint8_t interval);
+// Type a dynamic keymap macro straight from EEPROM
+void send_string_queue_macro_eeprom(const void *addr);
+
+bool    send_string_queue_busy(void);
+uint8_t send_string_queue_free(void);
+// Drop everything still pending and release whatever the queue is holding down
+void send_string_queue_cancel(void);
+// Block until everything queued has been typed
+void send_string_queue_flush(void);
+void send_string_queue_task(void);
+
+#else
+
+#    define send_string_queue_register(keycode) register_code(keycode)
+#    define send_string_queue_unregister(keycode) unregister_code(keycode)
+#    define send_string_queue_tap(keycode) tap_code(keycode)
+#    define send_string_queue_tap16(keycode) tap_code16(keycode)
+#    define send_string_queue_delay(ms) wait_ms(ms)
+#    define send_string_queue_get_mods() get_mods()
+#    define send_string_queue_busy() false
+#    define send_string_queue_cancel()
+#    define send_string_queue_flush()
+#    define send_string_queue_task()
+
+#endif
@@ -97,39 +97,63 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
     }
 }
 
-static void send_block(uint8_t link, uint8_t* start, uint8_t* end, uint8_t num_non_zero) {
-    send_data(link, &num_non_zero, 1);
+// Sends the bytes from the start offset of the first segment up to the end offset of the last one
+static void send_span(uint8_t link, const frame_buffer_t* frame, uint8_t first, uint16_t start, uint8_t last, uint16_t end) {
+    for (; first < last; first++, start = 0) {
+        const frame_segment_t* segment = &frame->segments[first];
+        if (segment->size > start) {
+            send_data(link, segment->data + start, segment->size - start);
+        }
+    }
     if (end > start) {
-        send_data(link, start, end - start);
+        send_data(link, frame->segments[last].data + start, end - start);
     }
 }
 
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
+    frame_buffer_t frame;
+    frame_buffer_init(&frame, data, size);
+    byte_stuffer_send_frame_buffer(link, &frame);
+}
+
+// The blocks are sent straight out of the segments, so one can span several of them
+void byte_stuffer_send_frame_buffer(uint8_t link, const frame_buffer_t* frame) {
     const uint8_t zero = 0;
-    if (size > 0) {
-        uint16_t num_non_zero = 1;
-        uint8_t* end          = data + size;
-        uint8_t* start        = data;
-        while (data < end) {
-            if (num_non_zero == 0xFF) {
-                // There's more data after big non-zero block
-                // So send it, and start a new block
-                send_block(link, start, data, num_non_zero);
-                start        = data;
-                num_non_zero = 1;
-            } else {
-                if (*data == 0) {
-                    // A zero encountered, so send the block
-                    send_block(link, start, data, num_non_zero);
-                    start        = data + 1;
-                    num_non_zero = 1;
+    if (frame->size > 0) {
+        uint8_t  num_non_zero  = 1;
+        uint8_t  start_segment = 0;
+        uint16_t start         = 0;
+        uint8_t  segment;
+        for (segment = 0; segment < frame->num_segments; segment++) {
+            const uint8_t* data = frame->segments[segment].data;
+            uint16_t       size = frame->segments[segment].size;
+            uint16_t       pos  = 0;
+            while (pos < size) {
+                if (num_non_zero == 0xFF) {
+                    // There's more data after big non-zero block
+                    // So send it, and start a new block
+                    send_data(link, &num_non_zero, 1);
+                    send_span(link, frame, start_segment, start, segment, pos);
+                    start_segment = segment;
+                    start         = pos;
+                    num_non_zero  = 1;
                 } else {
-                    num_non_zero++;
+                    if (data[pos] == 0) {
+                        // A zero encountered, so send the block
+                        send_data(link, &num_non_zero, 1);
+                        send_span(link, frame, start_segment, start, segment, pos);
+                        start_segment = segment;
+                        start         = pos + 1;
+                        num_non_zero  = 1;
+                    } else {
+                        num_non_zero++;
+                    }
+                    ++pos;
                 }
-                ++data;
             }
         }
-        send_block(link, start, data, num_non_zero);
+        send_data(link, &num_non_zero, 1);
+        send_span(link, frame, start_segment, start, frame->num_segments - 1, frame->segments[frame->num_segments - 1].size);
         send_data(link, &zero, 1);
     }
 }
@@ -26,6 +26,7 @@ SOFTWARE.
 #define SERIAL_LINK_BYTE_STUFFER_H
 
 #include <stdint.h>
+#include "serial_link/protocol/frame_buffer.h"
 
 #define MAX_FRAME_SIZE 1024
 #define NUM_LINKS 2
@@ -33,5 +34,6 @@ SOFTWARE.
 void init_byte_stuffer(void);
 void byte_stuffer_recv_byte(uint8_t link, uint8_t data);
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size);
+void byte_stuffer_send_frame_buffer(uint8_t link, const frame_buffer_t* frame);
 
 #endif
@@ -0,0 +1,69 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 QMK
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SERIAL_LINK_FRAME_BUFFER_H
+#define SERIAL_LINK_FRAME_BUFFER_H
+
+#include <stdint.h>
+
+// Each layer adds its own segments on the way down:
+//   transport: the object and its id, after a header for full delta frames
+//   router:    the route
+//   validator: the CRC
+#define MAX_FRAME_SEGMENTS 5
+
+typedef struct frame_segment {
+    const uint8_t* data;
+    uint16_t       size;
+} frame_segment_t;
+
+// A frame that is sent as the concatenation of its segments, so that each
+// layer can add its bytes to it without copying or writing past the payload
+typedef struct frame_buffer {
+    uint8_t         num_segments;
+    uint16_t        size;
+    frame_segment_t segments[MAX_FRAME_SEGMENTS];
+} frame_buffer_t;
+
+static inline void frame_buffer_init(frame_buffer_t* frame, const uint8_t* data, uint16_t size) {
+    frame->num_segments     = 1;
+    frame->size             = size;
+    frame->segments[0].data = data;
+    frame->segments[0].size = size;
+}
+
+// The data has to stay around until the frame has been sent. A frame that runs
+// out of segments is emptied, so that it is dropped rather than sent cut short.
+static inline void frame_buffer_append(frame_buffer_t* frame, const uint8_t* data, uint16_t size) {
+    if (frame->num_segments >= MAX_FRAME_SEGMENTS) {
+        frame->size = 0;
+        return;
+    }
+    frame_segment_t* segment = &frame->segments[frame->num_segments++];
+    segment->data            = data;
+    segment->size            = size;
+    frame->size += size;
+}
+
+#endif
@@ -50,15 +50,22 @@ void route_incoming_frame(uint8_t link, uint8_t* data, uint16_t size) {
 }
 
 void router_send_frame(uint8_t destination, uint8_t* data, uint16_t size) {
+    frame_buffer_t frame;
+    frame_buffer_init(&frame, data, size);
+    router_send_frame_buffer(destination, &frame);
+}
+
+void router_send_frame_buffer(uint8_t destination, frame_buffer_t* frame) {
     if (destination == 0) {
         if (!is_master) {
-            data[size] = 1;
-            validator_send_frame(UP_LINK, data, size + 1);
+            const uint8_t up = 1;
+            frame_buffer_append(frame, &up, 1);
+            validator_send_frame_buffer(UP_LINK, frame);
         }
     } else {
         if (is_master) {
-            data[size] = destination;
-            validator_send_frame(DOWN_LINK, data, size + 1);
+            frame_buffer_append(frame, &destination, 1);
+            validator_send_frame_buffer(DOWN_LINK, frame);
         }
     }
 }
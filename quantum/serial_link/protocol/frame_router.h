@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "serial_link/protocol/frame_buffer.h"
 
 #define UP_LINK 0
 #define DOWN_LINK 1
@@ -34,5 +35,6 @@ SOFTWARE.
 void router_set_master(bool master);
 void route_incoming_frame(uint8_t link, uint8_t* data, uint16_t size);
 void router_send_frame(uint8_t destination, uint8_t* data, uint16_t size);
+void router_send_frame_buffer(uint8_t destination, frame_buffer_t* frame);
 
 #endif
@@ -26,9 +26,11 @@ SOFTWARE.
 #define SERIAL_LINK_FRAME_VALIDATOR_H
 
 #include <stdint.h>
+#include "serial_link/protocol/frame_buffer.h"
 
 void validator_recv_frame(uint8_t link, uint8_t* data, uint16_t size);
-// The buffer pointed to by the data needs 4 additional bytes
 void validator_send_frame(uint8_t link, uint8_t* data, uint16_t size);
+// Appends the CRC of all the segments to the frame and sends it
+void validator_send_frame_buffer(uint8_t link, frame_buffer_t* frame);
 
 #endif
@@ -31,6 +31,33 @@ SOFTWARE.
 static remote_object_t* remote_objects[MAX_REMOTE_OBJECTS];
 static uint32_t         num_remote_objects = 0;
 
+// Every frame of a delta object starts with its type and a sequence number
+enum delta_frame_type {
+    DELTA_FRAME_FULL,  // The whole object
+    DELTA_FRAME_DIFF,  // The sequence number of the version it changes, then the runs from delta_encode()
+    DELTA_FRAME_ACK,
+    DELTA_FRAME_NACK,
+};
+
+#define DELTA_HEADER_SIZE 3
+
+#define DELTA_PENDING 1  // Sent and not answered yet
+#define DELTA_RESEND 2   // A receiver has lost track, so send the whole object again
+#define DELTA_ACKED 4    // The data holds a version that has been acknowledged
+
+static uint8_t num_local_copies(remote_object_t* obj) { return obj->object_type == MASTER_TO_SINGLE_SLAVE ? NUM_SLAVES : 1; }
+
+static uint8_t num_remote_copies(remote_object_t* obj) { return obj->object_type == SLAVE_TO_MASTER ? NUM_SLAVES : 1; }
+
+static uint8_t* get_delta_start(remote_object_t* obj) { return obj->buffer + num_local_copies(obj) * LOCAL_OBJECT_SIZE(obj->object_size) + num_remote_copies(obj) * REMOTE_OBJECT_SIZE(obj->object_size); }
+
+static delta_local_t* get_delta_local(remote_object_t* obj, uint8_t index) { return (delta_local_t*)(get_delta_start(obj) + index * DELTA_LOCAL_SIZE(obj->object_size)); }
+
+static delta_remote_t* get_delta_remote(remote_object_t* obj, uint8_t index) {
+    uint8_t* start = get_delta_start(obj) + num_local_copies(obj) * DELTA_LOCAL_SIZE(obj->object_size);
+    return (delta_remote_t*)(start + index * DELTA_REMOTE_SIZE(obj->object_size));
+}
+
 void reinitialize_serial_link_transport(void) { num_remote_objects = 0; }
 
 void add_remote_objects(remote_object_t** _remote_objects, uint32_t _num_remote_objects) {
@@ -66,55 +93,258 @@ void add_remote_objects(remote_object_t** _remote_objects, uint32_t _num_remote_
                 start += REMOTE_OBJECT_SIZE(obj->object_size);
             }
         }
+        if (obj->delta) {
+            memset(get_delta_start(obj), 0, DELTA_OBJECT_SIZE(obj->object_size, num_local_copies(obj), num_remote_copies(obj)));
+        }
+    }
+}
+
+static triple_buffer_object_t* get_local_triple_buffer(remote_object_t* obj, uint8_t index) { return (triple_buffer_object_t*)(obj->buffer + index * LOCAL_OBJECT_SIZE(obj->object_size)); }
+
+static triple_buffer_object_t* get_remote_triple_buffer(remote_object_t* obj, uint8_t from) {
+    uint8_t* start;
+    if (obj->object_type == MASTER_TO_ALL_SLAVES) {
+        start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
+    } else if (obj->object_type == SLAVE_TO_MASTER) {
+        start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
+        start += (from - 1) * REMOTE_OBJECT_SIZE(obj->object_size);
+    } else {
+        start = obj->buffer + NUM_SLAVES * LOCAL_OBJECT_SIZE(obj->object_size);
     }
+    return (triple_buffer_object_t*)start;
+}
+
+static void write_remote(remote_object_t* obj, uint8_t from, const uint8_t* data) {
+    triple_buffer_object_t* tb  = get_remote_triple_buffer(obj, from);
+    void*                   ptr = triple_buffer_begin_write_internal(obj->object_size, tb);
+    memcpy(ptr, data, obj->object_size);
+    triple_buffer_end_write_internal(tb);
+}
+
+/** \brief Encodes the difference between base and data
+ *
+ * As runs of a count of unchanged bytes followed by a count of changed ones
+ * and their XOR with base. Unchanged bytes at the end are left out.
+ *
+ * \return false if it doesn't fit in limit bytes
+ */
+static bool delta_encode(uint8_t* out, uint16_t limit, const uint8_t* data, const uint8_t* base, uint16_t size, uint16_t* length) {
+    uint16_t pos = 0;
+    uint16_t len = 0;
+    while (pos < size) {
+        uint16_t start = pos;
+        while (pos < size && pos - start < 255 && data[pos] == base[pos]) {
+            pos++;
+        }
+        if (pos == size) {
+            break;
+        }
+        uint8_t unchanged = pos - start;
+        start             = pos;
+        uint16_t end      = pos;
+        while (end < size && end - start < 255) {
+            if (data[end] != base[end]) {
+                end++;
+                continue;
+            }
+            // Carry on over a gap of one or two unchanged bytes, it's cheaper than starting a new run
+            uint16_t gap = end;
+            while (gap < size && gap - end < 3 && data[gap] == base[gap]) {
+                gap++;
+            }
+            if (gap - end == 3 || gap == size || gap - start >= 255) {
+                break;
+            }
+            end = gap;
+        }
+        uint8_t changed = end - start;
+        if (len + 2 + changed > limit) {
+            return false;
+        }
+        out[len++] = unchanged;
+        out[len++] = changed;
+        for (; pos < end; pos++) {
+            out[len++] = data[pos] ^ base[pos];
+        }
+    }
+    *length = len;
+    return true;
+}
+
+// Applies the runs from delta_encode(), the data is left alone if they don't fit it
+static bool delta_apply(uint8_t* data, uint16_t size, const uint8_t* runs, uint16_t length) {
+    uint32_t pos = 0;
+    uint16_t i   = 0;
+    while (i < length) {
+        if (length - i < 2 || length - i - 2 < runs[i + 1]) {
+            return false;
+        }
+        pos += runs[i] + runs[i + 1];
+        if (pos > size) {
+            return false;
+        }
+        i += 2 + runs[i + 1];
+    }
+    pos = 0;
+    i   = 0;
+    while (i < length) {
+        pos += runs[i];
+        uint8_t changed = runs[i + 1];
+        i += 2;
+        for (; changed > 0; changed--) {
+            data[pos++] ^= runs[i++];
+        }
+    }
+    return true;
+}
+
+static void send_delta_answer(uint8_t type, uint8_t seq, uint8_t id, uint8_t destination) {
+    const uint8_t  header[] = {type, seq};
+    frame_buffer_t frame;
+    frame_buffer_init(&frame, header, sizeof(header));
+    frame_buffer_append(&frame, &id, 1);
+    router_send_frame_buffer(destination, &frame);
+}
+
+static void recv_delta_frame(remote_object_t* obj, uint8_t id, uint8_t from, uint8_t* data, uint16_t size) {
+    if (size < 2) {
+        return;
+    }
+    uint8_t type = data[0];
+    uint8_t seq  = data[1];
+    if (type == DELTA_FRAME_ACK || type == DELTA_FRAME_NACK) {
+        uint8_t index = obj->object_type == MASTER_TO_SINGLE_SLAVE ? from - 1 : 0;
+        if (index >= num_local_copies(obj)) {
+            return;
+        }
+        delta_local_t* local = get_delta_local(obj, index);
+        if (seq != local->seq || !(local->flags & (DELTA_PENDING | DELTA_ACKED))) {
+            return;
+        }
+        if (type == DELTA_FRAME_NACK) {
+            local->flags = (local->flags & ~DELTA_ACKED) | DELTA_RESEND;
+        } else if (local->flags & DELTA_PENDING) {
+            // The sent version is still the last one read from the triple buffer
+            memcpy(local->data, triple_buffer_last_read_internal(obj->object_size, get_local_triple_buffer(obj, index)), obj->object_size);
+            local->base  = seq;
+            local->flags = (local->flags & DELTA_RESEND) | DELTA_ACKED;
+        }
+        return;
+    }
+
+    uint8_t index = obj->object_type == SLAVE_TO_MASTER ? from - 1 : 0;
+    if (index >= num_remote_copies(obj)) {
+        return;
+    }
+    delta_remote_t* remote = get_delta_remote(obj, index);
+    bool            ok;
+    if (type == DELTA_FRAME_FULL) {
+        if (size - 2 != obj->object_size) {
+            return;
+        }
+        memcpy(remote->data, data + 2, obj->object_size);
+        ok = true;
+    } else if (type == DELTA_FRAME_DIFF && size >= DELTA_HEADER_SIZE) {
+        ok = remote->valid && remote->seq == data[2] && delta_apply(remote->data, obj->object_size, data + DELTA_HEADER_SIZE, size - DELTA_HEADER_SIZE);
+    } else {
+        return;
+    }
+    if (ok) {
+        remote->seq   = seq;
+        remote->valid = true;
+        write_remote(obj, from, remote->data);
+    }
+    // The master answers the slave that sent it, the slaves answer the master
+    uint8_t destination = obj->object_type == SLAVE_TO_MASTER ? 1 << (from - 1) : 0;
+    send_delta_answer(ok ? DELTA_FRAME_ACK : DELTA_FRAME_NACK, seq, id, destination);
 }
 
 void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size) {
     uint8_t id = data[size - 1];
     if (id < num_remote_objects) {
         remote_object_t* obj = remote_objects[id];
-        if (obj->object_size == size - 1) {
-            uint8_t* start;
-            if (obj->object_type == MASTER_TO_ALL_SLAVES) {
-                start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
-            } else if (obj->object_type == SLAVE_TO_MASTER) {
-                start = obj->buffer + LOCAL_OBJECT_SIZE(obj->object_size);
-                start += (from - 1) * REMOTE_OBJECT_SIZE(obj->object_size);
-            } else {
-                start = obj->buffer + NUM_SLAVES * LOCAL_OBJECT_SIZE(obj->object_size);
-            }
-            triple_buffer_object_t* tb  = (triple_buffer_object_t*)start;
-            void*                   ptr = triple_buffer_begin_write_internal(obj->object_size, tb);
-            memcpy(ptr, data, size - 1);
-            triple_buffer_end_write_internal(tb);
+        if (obj->delta) {
+            recv_delta_frame(obj, id, from, data, size - 1);
+        } else if (obj->object_size == size - 1) {
+            write_remote(obj, from, data);
         }
     }
 }
 
+/** \brief Sends the newest version of a delta object
+ *
+ * Only one version is in flight at a time, until it has been answered or
+ * SERIAL_LINK_DELTA_TIMEOUT calls have passed. Writes in the meantime are
+ * collected by the triple buffer.
+ */
+static void send_delta_object(remote_object_t* obj, uint8_t id, uint8_t index, uint8_t destination) {
+    triple_buffer_object_t* tb    = get_local_triple_buffer(obj, index);
+    delta_local_t*          local = get_delta_local(obj, index);
+    uint16_t                size  = obj->object_size;
+    bool                    retry = local->flags & (DELTA_PENDING | DELTA_RESEND);
+    if ((local->flags & (DELTA_PENDING | DELTA_RESEND)) == DELTA_PENDING && ++local->timeout < SERIAL_LINK_DELTA_TIMEOUT) {
+        return;
+    }
+    uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(size, tb);
+    if (!ptr) {
+        if (!retry) {
+            return;
+        }
+        ptr = (uint8_t*)triple_buffer_last_read_internal(size, tb);
+    }
+
+    local->seq++;
+    local->timeout = 0;
+    // Anything that isn't a plain update goes in full, as the receiver may not have the base
+    uint8_t* diff        = local->data + size;
+    uint16_t diff_length = 0;
+    bool     full        = retry || !(local->flags & DELTA_ACKED) || size <= DELTA_HEADER_SIZE;
+    if (!full) {
+        full = !delta_encode(diff + DELTA_HEADER_SIZE, size - DELTA_HEADER_SIZE, ptr, local->data, size, &diff_length);
+    }
+    local->flags = (local->flags & DELTA_ACKED) | DELTA_PENDING;
+
+    const uint8_t  header[] = {DELTA_FRAME_FULL, local->seq};
+    frame_buffer_t frame;
+    if (full) {
+        frame_buffer_init(&frame, header, sizeof(header));
+        frame_buffer_append(&frame, ptr, size);
+    } else {
+        diff[0] = DELTA_FRAME_DIFF;
+        diff[1] = local->seq;
+        diff[2] = local->base;
+        frame_buffer_init(&frame, diff, DELTA_HEADER_SIZE + diff_length);
+    }
+    frame_buffer_append(&frame, &id, 1);
+    router_send_frame_buffer(destination, &frame);
+}
+
+static void send_local_object(remote_object_t* obj, uint8_t id, uint8_t index, uint8_t destination) {
+    if (obj->delta) {
+        send_delta_object(obj, id, index, destination);
+        return;
+    }
+    uint8_t* ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size, get_local_triple_buffer(obj, index));
+    if (ptr) {
+        frame_buffer_t frame;
+        frame_buffer_init(&frame, ptr, obj->object_size);
+        frame_buffer_append(&frame, &id, 1);
+        router_send_frame_buffer(destination, &frame);
+    }
+}
+
 void update_transport(void) {
     unsigned int i;
     for (i = 0; i < num_remote_objects; i++) {
         remote_object_t* obj = remote_objects[i];
         if (obj->object_type == MASTER_TO_ALL_SLAVES || obj->object_type == SLAVE_TO_MASTER) {
-            triple_buffer_object_t* tb  = (triple_buffer_object_t*)obj->buffer;
-            uint8_t*                ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
-            if (ptr) {
-                ptr[obj->object_size] = i;
-                uint8_t dest          = obj->object_type == MASTER_TO_ALL_SLAVES ? 0xFF : 0;
-                router_send_frame(dest, ptr, obj->object_size + 1);
-            }
+            uint8_t dest = obj->object_type == MASTER_TO_ALL_SLAVES ? 0xFF : 0;
+            send_local_object(obj, i, 0, dest);
         } else {
-            uint8_t*     start = obj->buffer;
             unsigned int j;
             for (j = 0; j < NUM_SLAVES; j++) {
-                triple_buffer_object_t* tb  = (triple_buffer_object_t*)start;
-                uint8_t*                ptr = (uint8_t*)triple_buffer_read_internal(obj->object_size + LOCAL_OBJECT_EXTRA, tb);
-                if (ptr) {
-                    ptr[obj->object_size] = i;
-                    uint8_t dest          = j + 1;
-                    router_send_frame(dest, ptr, obj->object_size + 1);
-                }
-                start += LOCAL_OBJECT_SIZE(obj->object_size);
+                // The destination has a bit for each slave
+                send_local_object(obj, i, j, 1 << j);
             }
         }
     }
@@ -29,7 +29,11 @@ SOFTWARE.
 #include "serial_link/system/serial_link.h"
 
 #define NUM_SLAVES 8
-#define LOCAL_OBJECT_EXTRA 16
+
+// update_transport() calls without an answer before a delta object is sent again in full
+#ifndef SERIAL_LINK_DELTA_TIMEOUT
+#    define SERIAL_LINK_DELTA_TIMEOUT 16
+#endif
 
 // master -> slave = 1 local(target all), 1 remote object
 // slave -> master = 1 local(target 0), multiple remote objects
@@ -43,28 +47,50 @@ typedef enum {
 typedef struct {
     remote_object_type object_type;
     uint16_t           object_size;
-    uint8_t            buffer[] __attribute__((aligned(4)));
+    bool               delta;
+    uint8_t            buffer[0] __attribute__((aligned(4)));  // Zero sized rather than flexible, so that C++ lets it be embedded
 } remote_object_t;
 
-#define REMOTE_OBJECT_SIZE(objectsize) (sizeof(triple_buffer_object_t) + objectsize * 3)
-#define LOCAL_OBJECT_SIZE(objectsize) (sizeof(triple_buffer_object_t) + (objectsize + LOCAL_OBJECT_EXTRA) * 3)
+// What the sender of a delta object keeps for each destination
+typedef struct {
+    uint8_t seq;   // Of the last version sent
+    uint8_t base;  // Of the version in data
+    uint8_t flags;
+    uint8_t timeout;
+    // The version last acknowledged, followed by room for encoding a delta against it
+    uint8_t data[];
+} delta_local_t;
+
+// What the receiver of a delta object keeps for each source
+typedef struct {
+    uint8_t seq;  // Of the version in data
+    bool    valid;
+    uint8_t data[];
+} delta_remote_t;
 
-#define REMOTE_OBJECT_HELPER(name, type, num_local, num_remote)                                                              \
-    typedef struct {                                                                                                         \
-        remote_object_t object;                                                                                              \
-        uint8_t         buffer[num_remote * REMOTE_OBJECT_SIZE(sizeof(type)) + num_local * LOCAL_OBJECT_SIZE(sizeof(type))]; \
+#define REMOTE_OBJECT_SIZE(objectsize) (sizeof(triple_buffer_object_t) + objectsize * 3)
+#define LOCAL_OBJECT_SIZE(objectsize) (sizeof(triple_buffer_object_t) + objectsize * 3)
+#define DELTA_LOCAL_SIZE(objectsize) (sizeof(delta_local_t) + objectsize * 2)
+#define DELTA_REMOTE_SIZE(objectsize) (sizeof(delta_remote_t) + objectsize)
+#define DELTA_OBJECT_SIZE(objectsize, num_local, num_remote) (num_local * DELTA_LOCAL_SIZE(objectsize) + num_remote * DELTA_REMOTE_SIZE(objectsize))
+
+#define REMOTE_OBJECT_HELPER(name, type, num_local, num_remote, is_delta)                                                                                                                              \
+    typedef struct {                                                                                                                                                                                   \
+        remote_object_t object;                                                                                                                                                                        \
+        uint8_t         buffer[num_remote * REMOTE_OBJECT_SIZE(sizeof(type)) + num_local * LOCAL_OBJECT_SIZE(sizeof(type)) + (is_delta ? DELTA_OBJECT_SIZE(sizeof(type), num_local, num_remote) : 0)]; \
     } remote_object_##name##_t;
 
-#define MASTER_TO_ALL_SLAVES_OBJECT(name, type)                                                                     \
-    REMOTE_OBJECT_HELPER(name, type, 1, 1)                                                                          \
+#define MASTER_TO_ALL_SLAVES_OBJECT_HELPER(name, type, is_delta)                                                    \
+    REMOTE_OBJECT_HELPER(name, type, 1, 1, is_delta)                                                                \
     remote_object_##name##_t remote_object_##name = {.object = {                                                    \
                                                          .object_type = MASTER_TO_ALL_SLAVES,                       \
                                                          .object_size = sizeof(type),                               \
+                                                         .delta       = is_delta,                                   \
                                                      }};                                                            \
     type*                    begin_write_##name(void) {                                                             \
         remote_object_t*        obj = (remote_object_t*)&remote_object_##name;                   \
         triple_buffer_object_t* tb  = (triple_buffer_object_t*)obj->buffer;                      \
-        return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        return (type*)triple_buffer_begin_write_internal(sizeof(type), tb);                      \
     }                                                                                                               \
     void end_write_##name(void) {                                                                                   \
         remote_object_t*        obj = (remote_object_t*)&remote_object_##name;                                      \
@@ -79,18 +105,19 @@ typedef struct {
         return (type*)triple_buffer_read_internal(obj->object_size, tb);                                            \
     }
 
-#define MASTER_TO_SINGLE_SLAVE_OBJECT(name, type)                                                                   \
-    REMOTE_OBJECT_HELPER(name, type, NUM_SLAVES, 1)                                                                 \
+#define MASTER_TO_SINGLE_SLAVE_OBJECT_HELPER(name, type, is_delta)                                                  \
+    REMOTE_OBJECT_HELPER(name, type, NUM_SLAVES, 1, is_delta)                                                       \
     remote_object_##name##_t remote_object_##name = {.object = {                                                    \
                                                          .object_type = MASTER_TO_SINGLE_SLAVE,                     \
                                                          .object_size = sizeof(type),                               \
+                                                         .delta       = is_delta,                                   \
                                                      }};                                                            \
     type*                    begin_write_##name(uint8_t slave) {                                                    \
         remote_object_t* obj   = (remote_object_t*)&remote_object_##name;                        \
         uint8_t*         start = obj->buffer;                                                    \
         start += slave * LOCAL_OBJECT_SIZE(obj->object_size);                                    \
         triple_buffer_object_t* tb = (triple_buffer_object_t*)start;                             \
-        return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        return (type*)triple_buffer_begin_write_internal(sizeof(type), tb);                      \
     }                                                                                                               \
     void end_write_##name(uint8_t slave) {                                                                          \
         remote_object_t* obj   = (remote_object_t*)&remote_object_##name;                                           \
@@ -107,16 +134,17 @@ typedef struct {
         return (type*)triple_buffer_read_internal(obj->object_size, tb);                                            \
     }
 
-#define SLAVE_TO_MASTER_OBJECT(name, type)                                                                          \
-    REMOTE_OBJECT_HELPER(name, type, 1, NUM_SLAVES)                                                                 \
+#define SLAVE_TO_MASTER_OBJECT_HELPER(name, type, is_delta)                                                         \
+    REMOTE_OBJECT_HELPER(name, type, 1, NUM_SLAVES, is_delta)                                                       \
     remote_object_##name##_t remote_object_##name = {.object = {                                                    \
                                                          .object_type = SLAVE_TO_MASTER,                            \
                                                          .object_size = sizeof(type),                               \
+                                                         .delta       = is_delta,                                   \
                                                      }};                                                            \
     type*                    begin_write_##name(void) {                                                             \
         remote_object_t*        obj = (remote_object_t*)&remote_object_##name;                   \
         triple_buffer_object_t* tb  = (triple_buffer_object_t*)obj->buffer;                      \
-        return (type*)triple_buffer_begin_write_internal(sizeof(type) + LOCAL_OBJECT_EXTRA, tb); \
+        return (type*)triple_buffer_begin_write_internal(sizeof(type), tb);                      \
     }                                                                                                               \
     void end_write_##name(void) {                                                                                   \
         remote_object_t*        obj = (remote_object_t*)&remote_object_##name;                                      \
@@ -132,6 +160,17 @@ typedef struct {
         return (type*)triple_buffer_read_internal(obj->object_size, tb);                                            \
     }
 
+#define MASTER_TO_ALL_SLAVES_OBJECT(name, type) MASTER_TO_ALL_SLAVES_OBJECT_HELPER(name, type, false)
+#define MASTER_TO_SINGLE_SLAVE_OBJECT(name, type) MASTER_TO_SINGLE_SLAVE_OBJECT_HELPER(name, type, false)
+#define SLAVE_TO_MASTER_OBJECT(name, type) SLAVE_TO_MASTER_OBJECT_HELPER(name, type, false)
+
+// Delta objects are sent as the bytes that changed since the version the
+// receiver last acknowledged, and in full when it has lost track. They cost
+// two copies of the object on the sending side and one on the receiving side.
+#define MASTER_TO_ALL_SLAVES_DELTA_OBJECT(name, type) MASTER_TO_ALL_SLAVES_OBJECT_HELPER(name, type, true)
+#define MASTER_TO_SINGLE_SLAVE_DELTA_OBJECT(name, type) MASTER_TO_SINGLE_SLAVE_OBJECT_HELPER(name, type, true)
+#define SLAVE_TO_MASTER_DELTA_OBJECT(name, type) SLAVE_TO_MASTER_OBJECT_HELPER(name, type, true)
+
 #define REMOTE_OBJECT(name) (remote_object_t*)&remote_object_##name
 
 void add_remote_objects(remote_object_t** remote_objects, uint32_t num_remote_objects);
@@ -43,5 +43,7 @@ void triple_buffer_init(triple_buffer_object_t* object);
 void* triple_buffer_begin_write_internal(uint16_t object_size, triple_buffer_object_t* object);
 void  triple_buffer_end_write_internal(triple_buffer_object_t* object);
 void* triple_buffer_read_internal(uint16_t object_size, triple_buffer_object_t* object);
+// The data returned by the last successful read, it stays the same until the next one
+void* triple_buffer_last_read_internal(uint16_t object_size, triple_buffer_object_t* object);
 
 #endif
@@ -26,6 +26,9 @@ SOFTWARE.
 #include "gmock/gmock.h"
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
 extern "C" {
 #include "serial_link/protocol/byte_stuffer.h"
 #include "serial_link/protocol/frame_validator.h"
@@ -50,13 +53,23 @@ class ByteStuffer : public ::testing::Test {
     void                 send_data(uint8_t link, const uint8_t* data, uint16_t size) { std::copy(data, data + size, std::back_inserter(sent_data)); }
     std::vector<uint8_t> sent_data;
 
+    // Set by the benchmarks to count the frames instead of going through the mock
+    bool     count_frames = false;
+    uint32_t num_frames   = 0;
+
     static ByteStuffer* Instance;
 };
 
 ByteStuffer* ByteStuffer::Instance = nullptr;
 
 extern "C" {
-void validator_recv_frame(uint8_t link, uint8_t* data, uint16_t size) { ByteStuffer::Instance->validator_recv_frame(link, data, size); }
+void validator_recv_frame(uint8_t link, uint8_t* data, uint16_t size) {
+    if (ByteStuffer::Instance->count_frames) {
+        ByteStuffer::Instance->num_frames++;
+    } else {
+        ByteStuffer::Instance->validator_recv_frame(link, data, size);
+    }
+}
 
 void send_data(uint8_t link, const uint8_t* data, uint16_t size) { ByteStuffer::Instance->send_data(link, data, size); }
 }
@@ -448,3 +461,61 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_254_bytes_and_then_zero) {
         byte_stuffer_recv_byte(1, d);
     }
 }
+
+TEST_F(ByteStuffer, sends_segments_the_same_as_a_single_frame) {
+    std::mt19937         rng(42);
+    std::vector<uint8_t> data(700);
+    for (int round = 0; round < 200; round++) {
+        // Mostly long non-zero runs, so that blocks are split at 254 bytes as well as at zeroes
+        for (auto& byte : data) {
+            byte = rng() % 64 == 0 ? 0 : rng() % 255 + 1;
+        }
+        uint16_t size = rng() % data.size() + 1;
+        byte_stuffer_send_frame(0, data.data(), size);
+        std::vector<uint8_t> expected = sent_data;
+        sent_data.clear();
+
+        frame_buffer_t frame;
+        uint16_t       first  = rng() % (size + 1);
+        uint16_t       second = first + rng() % (size - first + 1);
+        uint16_t       third  = second + rng() % (size - second + 1);
+        frame_buffer_init(&frame, data.data(), first);
+        frame_buffer_append(&frame, data.data() + first, second - first);
+        frame_buffer_append(&frame, data.data() + second, third - second);
+        frame_buffer_append(&frame, data.data() + third, size - third);
+        byte_stuffer_send_frame_buffer(0, &frame);
+        ASSERT_EQ(sent_data, expected) << "round " << round;
+        sent_data.clear();
+    }
+}
+
+TEST_F(ByteStuffer, Throughput) {
+    for (uint16_t size : {16, 64, 256, 1000}) {
+        std::vector<uint8_t> data(size);
+        for (uint16_t i = 0; i < size; i++) {
+            data[i] = i * 13;
+        }
+        const uint32_t frames = 4000000 / size;
+        sent_data.reserve(size * 2);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < frames; i++) {
+            sent_data.clear();
+            byte_stuffer_send_frame(0, data.data(), size);
+        }
+        std::chrono::duration<double> sending = std::chrono::steady_clock::now() - start;
+
+        std::vector<uint8_t> encoded = sent_data;
+        count_frames                 = true;
+        num_frames                   = 0;
+        start                        = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < frames; i++) {
+            for (auto& d : encoded) {
+                byte_stuffer_recv_byte(1, d);
+            }
+        }
+        std::chrono::duration<double> receiving = std::chrono::steady_clock::now() - start;
+        count_frames                            = false;
+        std::cout << "[ BENCH    ] " << size << " byte frames: sent " << (uint64_t)(frames / sending.count()) << " frames/s, received " << (uint64_t)(frames / receiving.count()) << " frames/s" << std::endl;
+        EXPECT_EQ(num_frames, frames);
+    }
+}
@@ -88,8 +88,7 @@ FrameRouter* FrameRouter::Instance = nullptr;
 
 typedef struct {
     std::array<uint8_t, 4> data;
-    uint8_t                extra[16];
-} frame_buffer_t;
+} test_frame_t;
 
 extern "C" {
 void send_data(uint8_t link, const uint8_t* data, uint16_t size) { FrameRouter::Instance->send_data(link, data, size); }
@@ -98,7 +97,7 @@ void transport_recv_frame(uint8_t from, uint8_t* data, uint16_t size) { FrameRou
 }
 
 TEST_F(FrameRouter, master_broadcast_is_received_by_everyone) {
-    frame_buffer_t data;
+    test_frame_t data;
     data.data = {0xAB, 0x70, 0x55, 0xBB};
     activate_router(0);
     router_send_frame(0xFF, (uint8_t*)&data, 4);
@@ -116,7 +115,7 @@ TEST_F(FrameRouter, master_broadcast_is_received_by_everyone) {
 }
 
 TEST_F(FrameRouter, master_send_is_received_by_targets) {
-    frame_buffer_t data;
+    test_frame_t data;
     data.data = {0xAB, 0x70, 0x55, 0xBB};
     activate_router(0);
     router_send_frame((1 << 1) | (1 << 2), (uint8_t*)&data, 4);
@@ -139,7 +138,7 @@ TEST_F(FrameRouter, master_send_is_received_by_targets) {
 }
 
 TEST_F(FrameRouter, first_link_sends_to_master) {
-    frame_buffer_t data;
+    test_frame_t data;
     data.data = {0xAB, 0x70, 0x55, 0xBB};
     activate_router(1);
     router_send_frame(0, (uint8_t*)&data, 4);
@@ -153,7 +152,7 @@ TEST_F(FrameRouter, first_link_sends_to_master) {
 }
 
 TEST_F(FrameRouter, second_link_sends_to_master) {
-    frame_buffer_t data;
+    test_frame_t data;
     data.data = {0xAB, 0x70, 0x55, 0xBB};
     activate_router(2);
     router_send_frame(0, (uint8_t*)&data, 4);
@@ -171,7 +170,7 @@ TEST_F(FrameRouter, second_link_sends_to_master) {
 }
 
 TEST_F(FrameRouter, master_sends_to_master_does_nothing) {
-    frame_buffer_t data;
+    test_frame_t data;
     data.data = {0xAB, 0x70, 0x55, 0xBB};
     activate_router(0);
     router_send_frame(0, (uint8_t*)&data, 4);
@@ -180,7 +179,7 @@ TEST_F(FrameRouter, master_sends_to_master_does_nothing) {
 }
 
 TEST_F(FrameRouter, link_sends_to_other_link_does_nothing) {
-    frame_buffer_t data;
+    test_frame_t data;
     data.data = {0xAB, 0x70, 0x55, 0xBB};
     activate_router(1);
     router_send_frame(2, (uint8_t*)&data, 4);
@@ -189,7 +188,7 @@ TEST_F(FrameRouter, link_sends_to_other_link_does_nothing) {
 }
 
 TEST_F(FrameRouter, master_receives_on_uplink_does_nothing) {
-    frame_buffer_t data;
+    test_frame_t data;
     data.data = {0xAB, 0x70, 0x55, 0xBB};
     activate_router(1);
     router_send_frame(0, (uint8_t*)&data, 4);
@@ -202,3 +201,17 @@ TEST_F(FrameRouter, master_receives_on_uplink_does_nothing) {
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
 }
+
+TEST_F(FrameRouter, segmented_frame_is_received_as_one) {
+    uint8_t        payload[]  = {0x11, 0x00, 0x33};
+    uint8_t        id         = 5;
+    uint8_t        expected[] = {0x11, 0x00, 0x33, 5};
+    frame_buffer_t frame;
+    frame_buffer_init(&frame, payload, sizeof(payload));
+    frame_buffer_append(&frame, &id, 1);
+    activate_router(1);
+    router_send_frame_buffer(0, &frame);
+    EXPECT_GT(router_buffers[1].send_buffers[UP_LINK].size(), 0);
+    EXPECT_CALL(*this, transport_recv_frame(1, _, _)).With(Args<1, 2>(ElementsAreArray(expected)));
+    simulate_transport(1, 0);
+}
@@ -24,6 +24,11 @@ SOFTWARE.
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
 extern "C" {
 #include "serial_link/protocol/frame_validator.h"
 }
@@ -41,15 +46,45 @@ class FrameValidator : public testing::Test {
     MOCK_METHOD3(route_incoming_frame, void(uint8_t link, uint8_t* data, uint16_t size));
     MOCK_METHOD3(byte_stuffer_send_frame, void(uint8_t link, uint8_t* data, uint16_t size));
 
+    // Set by the benchmarks to count the frames instead of going through the mock
+    bool     count_frames = false;
+    uint32_t num_frames   = 0;
+
+    std::vector<uint8_t> sent_data;
+
     static FrameValidator* Instance;
 };
 
 FrameValidator* FrameValidator::Instance = nullptr;
 
 extern "C" {
-void route_incoming_frame(uint8_t link, uint8_t* data, uint16_t size) { FrameValidator::Instance->route_incoming_frame(link, data, size); }
+void route_incoming_frame(uint8_t link, uint8_t* data, uint16_t size) {
+    if (FrameValidator::Instance->count_frames) {
+        FrameValidator::Instance->num_frames++;
+    } else {
+        FrameValidator::Instance->route_incoming_frame(link, data, size);
+    }
+}
+
+void byte_stuffer_send_frame_buffer(uint8_t link, const frame_buffer_t* frame) {
+    auto& sent = FrameValidator::Instance->sent_data;
+    sent.clear();
+    for (uint8_t i = 0; i < frame->num_segments; i++) {
+        sent.insert(sent.end(), frame->segments[i].data, frame->segments[i].data + frame->segments[i].size);
+    }
+    FrameValidator::Instance->byte_stuffer_send_frame(link, sent.data(), sent.size());
+}
+}
 
-void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) { FrameValidator::Instance->byte_stuffer_send_frame(link, data, size); }
+static uint32_t reference_crc32(const uint8_t* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
 }
 
 TEST_F(FrameValidator, doesnt_validate_frames_under_5_bytes) {
@@ -98,3 +133,70 @@ TEST_F(FrameValidator, sends_five_bytes_with_correct_crc) {
     EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).With(Args<1, 2>(ElementsAreArray(expected)));
     validator_send_frame(0, original, 5);
 }
+
+TEST_F(FrameValidator, sends_the_crc_of_all_segments) {
+    uint8_t        first[]    = {1, 2};
+    uint8_t        second[]   = {3};
+    uint8_t        third[]    = {4, 5};
+    uint8_t        expected[] = {1, 2, 3, 4, 5, 0xF4, 0x99, 0x0B, 0x47};
+    frame_buffer_t frame;
+    frame_buffer_init(&frame, first, sizeof(first));
+    frame_buffer_append(&frame, second, sizeof(second));
+    frame_buffer_append(&frame, third, sizeof(third));
+    EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).With(Args<1, 2>(ElementsAreArray(expected)));
+    validator_send_frame_buffer(0, &frame);
+}
+
+TEST_F(FrameValidator, empties_a_frame_with_too_many_segments) {
+    uint8_t        data[MAX_FRAME_SEGMENTS + 1] = {};
+    frame_buffer_t frame;
+    frame_buffer_init(&frame, &data[0], 1);
+    for (int i = 1; i < MAX_FRAME_SEGMENTS; i++) {
+        frame_buffer_append(&frame, &data[i], 1);
+    }
+    EXPECT_EQ(frame.size, MAX_FRAME_SEGMENTS);
+    frame_buffer_append(&frame, &data[MAX_FRAME_SEGMENTS], 1);
+    EXPECT_EQ(frame.num_segments, MAX_FRAME_SEGMENTS);
+    EXPECT_EQ(frame.size, 0);
+}
+
+TEST_F(FrameValidator, crc_matches_the_bitwise_one_for_any_length_and_alignment) {
+    std::mt19937         rng(1234);
+    std::vector<uint8_t> buffer(300);
+    for (auto& byte : buffer) {
+        byte = rng();
+    }
+    EXPECT_CALL(*this, byte_stuffer_send_frame(_, _, _)).Times(testing::AnyNumber());
+    for (uint16_t size = 1; size < 260; size++) {
+        uint8_t* data = buffer.data() + size % 8;
+        validator_send_frame(0, data, size);
+        uint32_t crc = reference_crc32(data, size);
+        ASSERT_EQ(sent_data.size(), size + 4u);
+        ASSERT_EQ(memcmp(&sent_data[size], &crc, 4), 0) << "size " << size;
+        count_frames = true;
+        validator_recv_frame(0, sent_data.data(), sent_data.size());
+        count_frames = false;
+        ASSERT_EQ(num_frames, size);
+    }
+}
+
+TEST_F(FrameValidator, ValidateThroughput) {
+    count_frames = true;
+    for (uint16_t size : {16, 64, 256, 1020}) {
+        std::vector<uint8_t> frame(size + 4);
+        for (uint16_t i = 0; i < size; i++) {
+            frame[i] = i * 7;
+        }
+        uint32_t crc = reference_crc32(frame.data(), size);
+        memcpy(&frame[size], &crc, 4);
+        const uint32_t frames = 20000000 / size;
+        num_frames            = 0;
+        auto start            = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < frames; i++) {
+            validator_recv_frame(0, frame.data(), frame.size());
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "[ BENCH    ] " << size << " byte frames: " << (uint64_t)(frames / elapsed.count()) << " frames/s, " << (uint64_t)(frames * size / elapsed.count() / 1000000) << " MB/s" << std::endl;
+        EXPECT_EQ(num_frames, frames);
+    }
+}
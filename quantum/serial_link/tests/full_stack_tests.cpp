@@ -0,0 +1,152 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2016 Fred Sundvik
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+
+extern "C" {
+#include "serial_link/protocol/transport.h"
+#include "serial_link/protocol/byte_stuffer.h"
+#include "serial_link/protocol/frame_router.h"
+}
+
+// Sends objects through the real transport, router, validator and byte stuffer.
+// Both ends of the link live in the same process, with the router switched
+// between master and slave, just like the router tests do.
+
+struct test_blob {
+    uint8_t data[64];
+};
+
+MASTER_TO_ALL_SLAVES_DELTA_OBJECT(full_stack_master_to_slave, test_blob);
+SLAVE_TO_MASTER_DELTA_OBJECT(full_stack_slave_to_master, test_blob);
+
+static remote_object_t* full_stack_remote_objects[] = {
+    REMOTE_OBJECT(full_stack_master_to_slave),
+    REMOTE_OBJECT(full_stack_slave_to_master),
+};
+
+class FullStack : public testing::Test {
+   public:
+    FullStack() {
+        Instance = this;
+        init_byte_stuffer();
+        add_remote_objects(full_stack_remote_objects, sizeof(full_stack_remote_objects) / sizeof(remote_object_t*));
+    }
+
+    ~FullStack() {
+        Instance = nullptr;
+        reinitialize_serial_link_transport();
+    }
+
+    void send_data(uint8_t link, const uint8_t* data, uint16_t size) { std::copy(data, data + size, std::back_inserter(send_buffers[current][link])); }
+
+    // Runs the transport on one side and hands what it sent to the other
+    void update(uint8_t side) {
+        current = side;
+        router_set_master(side == 0);
+        update_transport();
+    }
+
+    std::vector<uint8_t> deliver(uint8_t from) {
+        uint8_t to       = from == 0 ? 1 : 0;
+        uint8_t out_link = from == 0 ? DOWN_LINK : UP_LINK;
+        uint8_t in_link  = from == 0 ? UP_LINK : DOWN_LINK;
+        auto    data     = std::move(send_buffers[from][out_link]);
+        send_buffers[from][out_link].clear();
+        current = to;
+        router_set_master(to == 0);
+        for (uint8_t byte : data) {
+            byte_stuffer_recv_byte(in_link, byte);
+        }
+        return data;
+    }
+
+    test_blob write_master(uint8_t seed) {
+        test_blob* obj = begin_write_full_stack_master_to_slave();
+        for (size_t i = 0; i < sizeof(obj->data); i++) {
+            obj->data[i] = seed + i;
+        }
+        test_blob written = *obj;
+        end_write_full_stack_master_to_slave();
+        return written;
+    }
+
+    static FullStack* Instance;
+
+    uint8_t              current = 0;
+    std::vector<uint8_t> send_buffers[2][NUM_LINKS];
+};
+
+FullStack* FullStack::Instance = nullptr;
+
+extern "C" {
+void send_data(uint8_t link, const uint8_t* data, uint16_t size) { FullStack::Instance->send_data(link, data, size); }
+
+void signal_data_written(void) {}
+}
+
+TEST_F(FullStack, full_delta_frame_reaches_the_slave) {
+    test_blob written = write_master(1);
+    update(0);
+    deliver(0);
+    test_blob* read = read_full_stack_master_to_slave();
+    ASSERT_NE(read, nullptr);
+    EXPECT_TRUE(std::equal(written.data, written.data + sizeof(written.data), read->data));
+}
+
+TEST_F(FullStack, full_delta_frame_reaches_the_master) {
+    test_blob* obj = begin_write_full_stack_slave_to_master();
+    std::fill(obj->data, obj->data + sizeof(obj->data), 0x5A);
+    end_write_full_stack_slave_to_master();
+    update(1);
+    deliver(1);
+    test_blob* read = read_full_stack_slave_to_master(0);
+    ASSERT_NE(read, nullptr);
+    EXPECT_TRUE(std::all_of(read->data, read->data + sizeof(read->data), [](uint8_t b) { return b == 0x5A; }));
+}
+
+TEST_F(FullStack, acknowledged_object_is_sent_as_a_smaller_diff) {
+    write_master(1);
+    update(0);
+    size_t full_size = deliver(0).size();
+    ASSERT_NE(read_full_stack_master_to_slave(), nullptr);
+    // The slave answers with an ack
+    deliver(1);
+
+    test_blob* obj = begin_write_full_stack_master_to_slave();
+    for (size_t i = 0; i < sizeof(obj->data); i++) {
+        obj->data[i] = 1 + i;
+    }
+    obj->data[10] = 0xEE;
+    test_blob written = *obj;
+    end_write_full_stack_master_to_slave();
+    update(0);
+    size_t diff_size = deliver(0).size();
+    EXPECT_LT(diff_size, full_size);
+    test_blob* read = read_full_stack_master_to_slave();
+    ASSERT_NE(read, nullptr);
+    EXPECT_TRUE(std::equal(written.data, written.data + sizeof(written.data), read->data));
+}
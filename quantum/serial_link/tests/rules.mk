@@ -6,6 +6,9 @@ serial_link_frame_validator_SRC := \
 	$(SERIAL_PATH)/tests/frame_validator_tests.cpp \
 	$(SERIAL_PATH)/protocol/frame_validator.c 
 
+serial_link_frame_validator_slicing_SRC := $(serial_link_frame_validator_SRC)
+serial_link_frame_validator_slicing_DEFS := -DSERIAL_LINK_CRC_SLICING
+
 serial_link_frame_router_SRC := \
 	$(SERIAL_PATH)/tests/frame_router_tests.cpp \
 	$(SERIAL_PATH)/protocol/byte_stuffer.c \
@@ -20,3 +23,16 @@ serial_link_transport_SRC := \
 	$(SERIAL_PATH)/tests/transport_tests.cpp \
 	$(SERIAL_PATH)/protocol/transport.c \
 	$(SERIAL_PATH)/protocol/triple_buffered_object.c 
+
+serial_link_full_stack_SRC := \
+	$(SERIAL_PATH)/tests/full_stack_tests.cpp \
+	$(SERIAL_PATH)/protocol/byte_stuffer.c \
+	$(SERIAL_PATH)/protocol/frame_validator.c \
+	$(SERIAL_PATH)/protocol/frame_router.c \
+	$(SERIAL_PATH)/protocol/transport.c \
+	$(SERIAL_PATH)/protocol/triple_buffered_object.c
+# Runs under AddressSanitizer, to catch the layers writing past each other's buffers
+serial_link_full_stack_DEFS := -fsanitize=address -fno-omit-frame-pointer
+ifeq ($(TEST),serial_link_full_stack)
+LDFLAGS += -fsanitize=address
+endif
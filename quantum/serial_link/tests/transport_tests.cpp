@@ -24,6 +24,10 @@ SOFTWARE.
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
 
 using testing::_;
 using testing::Args;
@@ -31,6 +35,7 @@ using testing::ElementsAreArray;
 
 extern "C" {
 #include "serial_link/protocol/transport.h"
+#include "serial_link/protocol/frame_router.h"
 }
 
 struct test_object1 {
@@ -42,16 +47,26 @@ struct test_object2 {
     uint32_t test2;
 };
 
+template <size_t size>
+struct test_blob {
+    uint8_t data[size];
+};
+
 MASTER_TO_ALL_SLAVES_OBJECT(master_to_slave, test_object1);
 MASTER_TO_SINGLE_SLAVE_OBJECT(master_to_single_slave, test_object1);
 SLAVE_TO_MASTER_OBJECT(slave_to_master, test_object1);
+MASTER_TO_ALL_SLAVES_DELTA_OBJECT(delta_master_to_slave, test_blob<64>);
+SLAVE_TO_MASTER_DELTA_OBJECT(delta_slave_to_master, test_blob<64>);
+MASTER_TO_ALL_SLAVES_DELTA_OBJECT(delta_256, test_blob<256>);
+MASTER_TO_ALL_SLAVES_DELTA_OBJECT(delta_1024, test_blob<1024>);
+MASTER_TO_ALL_SLAVES_DELTA_OBJECT(delta_4096, test_blob<4096>);
 
 static remote_object_t* test_remote_objects[] = {
-    REMOTE_OBJECT(master_to_slave),
-    REMOTE_OBJECT(master_to_single_slave),
-    REMOTE_OBJECT(slave_to_master),
+    REMOTE_OBJECT(master_to_slave), REMOTE_OBJECT(master_to_single_slave), REMOTE_OBJECT(slave_to_master), REMOTE_OBJECT(delta_master_to_slave), REMOTE_OBJECT(delta_slave_to_master), REMOTE_OBJECT(delta_256), REMOTE_OBJECT(delta_1024), REMOTE_OBJECT(delta_4096),
 };
 
+enum { FULL, DIFF, ACK, NACK };
+
 class Transport : public testing::Test {
    public:
     Transport() {
@@ -67,22 +82,50 @@ class Transport : public testing::Test {
     MOCK_METHOD0(signal_data_written, void());
     MOCK_METHOD1(router_send_frame, void(uint8_t destination));
 
-    void router_send_frame(uint8_t destination, uint8_t* data, uint16_t size) {
-        router_send_frame(destination);
-        std::copy(data, data + size, std::back_inserter(sent_data));
+    void router_send_frame_buffer(uint8_t destination, frame_buffer_t* frame) {
+        if (!quiet) {
+            router_send_frame(destination);
+        }
+        sent_frames.emplace_back();
+        sent_destinations.push_back(destination);
+        for (uint8_t i = 0; i < frame->num_segments; i++) {
+            const frame_segment_t& segment = frame->segments[i];
+            std::copy(segment.data, segment.data + segment.size, std::back_inserter(sent_data));
+            std::copy(segment.data, segment.data + segment.size, std::back_inserter(sent_frames.back()));
+        }
+    }
+
+    // Hands the frames sent so far to the other side of the link and forgets them
+    void deliver(uint8_t from) {
+        auto frames = std::move(sent_frames);
+        sent_frames.clear();
+        sent_destinations.clear();
+        sent_data.clear();
+        for (auto& frame : frames) {
+            transport_recv_frame(from, frame.data(), frame.size());
+        }
     }
 
     static Transport* Instance;
 
-    std::vector<uint8_t> sent_data;
+    // Set to leave the mocks out, when their calls are of no interest
+    bool quiet = false;
+
+    std::vector<uint8_t>              sent_data;
+    std::vector<std::vector<uint8_t>> sent_frames;
+    std::vector<uint8_t>              sent_destinations;
 };
 
 Transport* Transport::Instance = nullptr;
 
 extern "C" {
-void signal_data_written(void) { Transport::Instance->signal_data_written(); }
+void signal_data_written(void) {
+    if (!Transport::Instance->quiet) {
+        Transport::Instance->signal_data_written();
+    }
+}
 
-void router_send_frame(uint8_t destination, uint8_t* data, uint16_t size) { Transport::Instance->router_send_frame(destination, data, size); }
+void router_send_frame_buffer(uint8_t destination, frame_buffer_t* frame) { Transport::Instance->router_send_frame_buffer(destination, frame); }
 }
 
 TEST_F(Transport, write_to_local_signals_an_event) {
@@ -132,7 +175,7 @@ TEST_F(Transport, writes_from_master_to_single_slave) {
     obj->test         = 7;
     EXPECT_CALL(*this, signal_data_written());
     end_write_master_to_single_slave(3);
-    EXPECT_CALL(*this, router_send_frame(4));
+    EXPECT_CALL(*this, router_send_frame(1 << 3));
     update_transport();
     transport_recv_frame(0, sent_data.data(), sent_data.size());
     test_object1* obj2 = read_master_to_single_slave();
@@ -146,7 +189,7 @@ TEST_F(Transport, ignores_object_with_invalid_id) {
     obj->test         = 7;
     EXPECT_CALL(*this, signal_data_written());
     end_write_master_to_single_slave(3);
-    EXPECT_CALL(*this, router_send_frame(4));
+    EXPECT_CALL(*this, router_send_frame(1 << 3));
     update_transport();
     sent_data[sent_data.size() - 1] = 44;
     transport_recv_frame(0, sent_data.data(), sent_data.size());
@@ -182,3 +225,172 @@ TEST_F(Transport, ignores_object_with_size_too_big) {
     test_object1* obj2 = read_master_to_slave();
     EXPECT_EQ(obj2, nullptr);
 }
+
+template <size_t size>
+static void write_blob(test_blob<size>* (*begin_write)(void), void (*end_write)(void), const std::vector<uint8_t>& value) {
+    memcpy(begin_write()->data, value.data(), size);
+    end_write();
+}
+
+TEST_F(Transport, delta_object_is_sent_in_full_and_then_as_changes) {
+    quiet = true;
+    std::vector<uint8_t> value(64);
+    for (int i = 0; i < 64; i++) {
+        value[i] = i;
+    }
+    write_blob(begin_write_delta_master_to_slave, end_write_delta_master_to_slave, value);
+    update_transport();
+    ASSERT_EQ(sent_frames.size(), 1);
+    EXPECT_EQ(sent_destinations[0], 0xFF);
+    EXPECT_EQ(sent_frames[0][0], FULL);
+    EXPECT_EQ(sent_frames[0].size(), 2 + 64 + 1);
+    deliver(0);
+    test_blob<64>* received = read_delta_master_to_slave();
+    ASSERT_NE(received, nullptr);
+    EXPECT_THAT(received->data, ElementsAreArray(value));
+    ASSERT_EQ(sent_frames.size(), 1);
+    EXPECT_EQ(sent_destinations[0], 0);
+    EXPECT_EQ(sent_frames[0][0], ACK);
+    deliver(1);
+
+    value[10] = 0xAA;
+    value[11] = 0xBB;
+    write_blob(begin_write_delta_master_to_slave, end_write_delta_master_to_slave, value);
+    update_transport();
+    ASSERT_EQ(sent_frames.size(), 1);
+    uint8_t expected[] = {DIFF, 2, 1, 10, 2, 0xAA ^ 10, 0xBB ^ 11, 3};
+    EXPECT_THAT(sent_frames[0], ElementsAreArray(expected));
+    deliver(0);
+    received = read_delta_master_to_slave();
+    ASSERT_NE(received, nullptr);
+    EXPECT_THAT(received->data, ElementsAreArray(value));
+}
+
+TEST_F(Transport, delta_object_waits_for_an_answer_before_sending_again) {
+    quiet = true;
+    std::vector<uint8_t> value(64, 1);
+    write_blob(begin_write_delta_master_to_slave, end_write_delta_master_to_slave, value);
+    update_transport();
+    EXPECT_EQ(sent_frames.size(), 1);
+    sent_frames.clear();
+
+    value[0] = 2;
+    write_blob(begin_write_delta_master_to_slave, end_write_delta_master_to_slave, value);
+    for (int i = 1; i < SERIAL_LINK_DELTA_TIMEOUT; i++) {
+        update_transport();
+    }
+    EXPECT_EQ(sent_frames.size(), 0);
+    update_transport();
+    ASSERT_EQ(sent_frames.size(), 1);
+    EXPECT_EQ(sent_frames[0][0], FULL);
+    deliver(0);
+    test_blob<64>* received = read_delta_master_to_slave();
+    ASSERT_NE(received, nullptr);
+    EXPECT_THAT(received->data, ElementsAreArray(value));
+}
+
+TEST_F(Transport, delta_object_is_sent_in_full_after_a_nack) {
+    quiet = true;
+    std::vector<uint8_t> value(64, 1);
+    write_blob(begin_write_delta_master_to_slave, end_write_delta_master_to_slave, value);
+    update_transport();
+    deliver(0);
+    read_delta_master_to_slave();
+    deliver(1);
+
+    value[5] = 7;
+    write_blob(begin_write_delta_master_to_slave, end_write_delta_master_to_slave, value);
+    update_transport();
+    ASSERT_EQ(sent_frames.size(), 1);
+    EXPECT_EQ(sent_frames[0][0], DIFF);
+    // A delta against a version the receiver doesn't have
+    sent_frames[0][2]++;
+    deliver(0);
+    EXPECT_EQ(read_delta_master_to_slave(), nullptr);
+    ASSERT_EQ(sent_frames.size(), 1);
+    EXPECT_EQ(sent_frames[0][0], NACK);
+    deliver(1);
+
+    update_transport();
+    ASSERT_EQ(sent_frames.size(), 1);
+    EXPECT_EQ(sent_frames[0][0], FULL);
+    deliver(0);
+    test_blob<64>* received = read_delta_master_to_slave();
+    ASSERT_NE(received, nullptr);
+    EXPECT_THAT(received->data, ElementsAreArray(value));
+}
+
+TEST_F(Transport, delta_object_from_slave_is_answered_to_that_slave) {
+    quiet = true;
+    std::vector<uint8_t> value(64, 3);
+    write_blob(begin_write_delta_slave_to_master, end_write_delta_slave_to_master, value);
+    update_transport();
+    ASSERT_EQ(sent_frames.size(), 1);
+    EXPECT_EQ(sent_destinations[0], 0);
+    deliver(3);
+    test_blob<64>* received = read_delta_slave_to_master(2);
+    ASSERT_NE(received, nullptr);
+    EXPECT_THAT(received->data, ElementsAreArray(value));
+    ASSERT_EQ(sent_frames.size(), 1);
+    EXPECT_EQ(sent_destinations[0], 1 << 2);
+    EXPECT_EQ(sent_frames[0][0], ACK);
+}
+
+TEST_F(Transport, delta_object_follows_random_changes) {
+    quiet = true;
+    std::mt19937         rng(7);
+    std::vector<uint8_t> value(1024);
+    for (int round = 0; round < 500; round++) {
+        // From a byte or two up to long runs and everything at once
+        int changes = rng() % 8;
+        for (int i = 0; i < changes; i++) {
+            int start  = rng() % value.size();
+            int length = rng() % 2 ? rng() % 4 + 1 : rng() % 600;
+            for (int j = start; j < start + length && j < (int)value.size(); j++) {
+                value[j] = rng() % 3 ? rng() : 0;
+            }
+        }
+        write_blob(begin_write_delta_1024, end_write_delta_1024, value);
+        update_transport();
+        ASSERT_EQ(sent_frames.size(), 1);
+        deliver(0);
+        test_blob<1024>* received = read_delta_1024();
+        ASSERT_NE(received, nullptr);
+        ASSERT_EQ(memcmp(received->data, value.data(), value.size()), 0) << "round " << round;
+        deliver(1);
+    }
+}
+
+template <size_t size>
+static void benchmark_delta_sync(Transport* transport, test_blob<size>* (*begin_write)(void), void (*end_write)(void), test_blob<size>* (*read)(void)) {
+    const uint32_t       updates = 4000000 / size;
+    std::vector<uint8_t> value(size);
+    uint64_t             sent     = 0;
+    test_blob<size>*     received = nullptr;
+    auto                 start    = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < updates; i++) {
+        // Something like a few LEDs changing colour
+        for (uint32_t j = 0; j < 4; j++) {
+            value[(i * 37 + j * 3) % size]++;
+        }
+        write_blob(begin_write, end_write, value);
+        update_transport();
+        sent += transport->sent_frames.at(0).size();
+        transport->deliver(0);
+        received = read();
+        transport->deliver(1);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "[ BENCH    ] " << size << " byte object: " << (uint64_t)(updates / elapsed.count()) << " updates/s, " << (double)sent / updates << " bytes per update instead of " << size + 1 << std::endl;
+    ASSERT_NE(received, nullptr);
+    EXPECT_EQ(memcmp(received->data, value.data(), size), 0);
+    EXPECT_LT(sent, (uint64_t)updates * (size + 1) / 2);
+}
+
+TEST_F(Transport, DeltaSyncThroughput) {
+    quiet = true;
+    benchmark_delta_sync(this, begin_write_delta_master_to_slave, end_write_delta_master_to_slave, read_delta_master_to_slave);
+    benchmark_delta_sync(this, begin_write_delta_256, end_write_delta_256, read_delta_256);
+    benchmark_delta_sync(this, begin_write_delta_1024, end_write_delta_1024, read_delta_1024);
+    benchmark_delta_sync(this, begin_write_delta_4096, end_write_delta_4096, read_delta_4096);
+}
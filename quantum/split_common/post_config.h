@@ -16,4 +16,8 @@
 // When using serial and RGBLIGHT_SPLIT need separate transaction
 #        define SERIAL_USE_MULTI_TRANSACTION
 #    endif
+// The delta protocol polls a small status transaction, and only fetches the matrix when it changed
+#    if defined(SPLIT_TRANSPORT_DELTA) && !defined(SERIAL_USE_MULTI_TRANSACTION)
+#        define SERIAL_USE_MULTI_TRANSACTION
+#    endif
 #endif
@@ -0,0 +1,164 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stddef.h>
+#include <string.h>
+#include "serial_duplex.h"
+
+// sync, index, largest payload and checksum
+#define SERIAL_DUPLEX_BUFFER_SIZE (2 + 255 + 1)
+
+static SSTD_t *initiator_table      = NULL;
+static int     initiator_table_size = 0;
+static SSTD_t *target_table         = NULL;
+static int     target_table_size    = 0;
+static uint8_t request_size         = 0;
+
+// Written and read by the physical layer, the transaction buffers are only touched once a frame is complete
+static uint8_t serial_buffer[SERIAL_DUPLEX_BUFFER_SIZE];
+
+static uint8_t serial_checksum(uint8_t sstd_index, const uint8_t *data, uint8_t size) {
+    uint8_t sum = sstd_index;
+    for (uint8_t i = 0; i < size; i++) {
+        sum += data[i];
+    }
+    return ~sum;
+}
+
+static uint8_t serial_request_size(SSTD_t *sstd_table, int sstd_table_size) {
+    uint8_t size = 0;
+    for (int i = 0; i < sstd_table_size; i++) {
+        if (sstd_table[i].initiator2target_buffer_size > size) {
+            size = sstd_table[i].initiator2target_buffer_size;
+        }
+    }
+    return size;
+}
+
+void soft_serial_initiator_init(SSTD_t *sstd_table, int sstd_table_size) {
+    initiator_table      = sstd_table;
+    initiator_table_size = sstd_table_size;
+    request_size         = serial_request_size(sstd_table, sstd_table_size);
+    serial_duplex_phy_init(true);
+}
+
+void soft_serial_target_init(SSTD_t *sstd_table, int sstd_table_size) {
+    target_table      = sstd_table;
+    target_table_size = sstd_table_size;
+    request_size      = serial_request_size(sstd_table, sstd_table_size);
+    serial_duplex_phy_init(false);
+}
+
+bool serial_duplex_target_task(void) {
+    if (!serial_duplex_phy_receive(serial_buffer, 2 + request_size + 1, true)) {
+        return false;
+    }
+
+    uint8_t sstd_index = serial_buffer[1];
+    if (serial_buffer[0] != SERIAL_DUPLEX_SYNC || sstd_index >= target_table_size) {
+        // we're out of step with the initiator, wait for the line to be idle before the next request
+        serial_duplex_phy_clear();
+        return false;
+    }
+
+    SSTD_t *trans = &target_table[sstd_index];
+    if (serial_buffer[2 + request_size] != serial_checksum(sstd_index, &serial_buffer[2], request_size)) {
+        soft_serial_target_lock();
+        *trans->status = TRANSACTION_DATA_ERROR;
+        soft_serial_target_unlock();
+        serial_duplex_phy_clear();
+        return false;
+    }
+
+    // the scan loop reads and writes the transaction buffers from another thread,
+    // so they are only touched under the lock, and never while waiting on the line
+    uint8_t size = trans->target2initiator_buffer_size;
+    soft_serial_target_lock();
+    if (trans->initiator2target_buffer_size > 0) {
+        memcpy(trans->initiator2target_buffer, &serial_buffer[2], trans->initiator2target_buffer_size);
+    }
+    // the response is sent even without payload, so the initiator knows the request arrived
+    if (size > 0) {
+        memcpy(serial_buffer, trans->target2initiator_buffer, size);
+    }
+    *trans->status = TRANSACTION_ACCEPTED;
+    soft_serial_target_unlock();
+
+    serial_buffer[size] = serial_checksum(sstd_index, serial_buffer, size);
+    serial_duplex_phy_send(serial_buffer, size + 1);
+    return true;
+}
+
+/////////
+//  start transaction by initiator
+//
+// int  soft_serial_transaction(int sstd_index)
+//
+// Returns:
+//    TRANSACTION_END
+//    TRANSACTION_NO_RESPONSE
+//    TRANSACTION_DATA_ERROR
+//    TRANSACTION_TYPE_ERROR
+#ifndef SERIAL_USE_MULTI_TRANSACTION
+int soft_serial_transaction(void) {
+    int sstd_index = 0;
+#else
+int soft_serial_transaction(int sstd_index) {
+#endif
+    if (sstd_index < 0 || sstd_index >= initiator_table_size) return TRANSACTION_TYPE_ERROR;
+    SSTD_t *trans = &initiator_table[sstd_index];
+
+    // send the request, padded to the size the target expects
+    serial_buffer[0] = SERIAL_DUPLEX_SYNC;
+    serial_buffer[1] = sstd_index;
+    memset(&serial_buffer[2], 0, request_size);
+    if (trans->initiator2target_buffer_size > 0) {
+        memcpy(&serial_buffer[2], trans->initiator2target_buffer, trans->initiator2target_buffer_size);
+    }
+    serial_buffer[2 + request_size] = serial_checksum(sstd_index, &serial_buffer[2], request_size);
+
+    uint8_t size = trans->target2initiator_buffer_size;
+    if (!serial_duplex_phy_send(serial_buffer, 2 + request_size + 1) || !serial_duplex_phy_receive(serial_buffer, size + 1, false)) {
+        // drop the rest of a late response, so it isn't mistaken for the next one
+        serial_duplex_phy_clear();
+        *trans->status = TRANSACTION_NO_RESPONSE;
+        return TRANSACTION_NO_RESPONSE;
+    }
+
+    if (serial_buffer[size] != serial_checksum(sstd_index, serial_buffer, size)) {
+        serial_duplex_phy_clear();
+        *trans->status = TRANSACTION_DATA_ERROR;
+        return TRANSACTION_DATA_ERROR;
+    }
+    if (size > 0) {
+        memcpy(trans->target2initiator_buffer, serial_buffer, size);
+    }
+
+    *trans->status = TRANSACTION_END;
+    return TRANSACTION_END;
+}
+
+#ifdef SERIAL_USE_MULTI_TRANSACTION
+int soft_serial_get_and_clean_status(int sstd_index) {
+    SSTD_t *trans = target_table ? &target_table[sstd_index] : &initiator_table[sstd_index];
+    soft_serial_target_lock();
+    int retval     = *trans->status;
+    *trans->status = 0;
+    soft_serial_target_unlock();
+    return retval;
+}
+#endif
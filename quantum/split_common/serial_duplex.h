@@ -0,0 +1,52 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "serial.h"
+
+// /////////////////////////////////////////////////////////////////
+// Full duplex transport of the soft serial transactions over a UART
+// /////////////////////////////////////////////////////////////////
+//
+// The initiator sends a request of a fixed size, padded to the largest
+// initiator2target_buffer of the transaction table:
+//     SERIAL_DUPLEX_SYNC, transaction index, initiator2target_buffer, checksum
+// and the target answers with:
+//     target2initiator_buffer, checksum
+//
+// Both sides receive into a private buffer, and only copy the payload into
+// the transaction buffers once its checksum is verified. The target copies
+// under soft_serial_target_lock(), as it answers from its own thread. The
+// physical layer and the lock are provided by the platform driver (e.g.
+// drivers/chibios/serial_usart_duplex.c).
+
+#define SERIAL_DUPLEX_SYNC 0x7E
+
+// Handles one request of the initiator, returns false if none was accepted.
+// Called in a loop by the platform driver on the target side.
+bool serial_duplex_target_task(void);
+
+// Physical layer
+void serial_duplex_phy_init(bool initiator);
+// Discards any input until the line is idle
+void serial_duplex_phy_clear(void);
+bool serial_duplex_phy_send(const uint8_t *data, uint16_t size);
+// Blocks until the first byte arrives when wait is set, otherwise times out
+bool serial_duplex_phy_receive(uint8_t *data, uint16_t size, bool wait);
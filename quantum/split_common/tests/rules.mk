@@ -0,0 +1,39 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+split_common_serial_duplex_SRC :=\
+	$(QUANTUM_PATH)/split_common/tests/serial_duplex_tests.cpp \
+	$(QUANTUM_PATH)/split_common/serial_duplex.c
+
+split_common_serial_duplex_INC := $(DRIVER_PATH)/chibios
+
+split_common_serial_duplex_DEFS := -DSERIAL_USE_MULTI_TRANSACTION
+
+split_common_transport_delta_i2c_SRC :=\
+	$(QUANTUM_PATH)/split_common/tests/transport_delta_i2c_tests.cpp \
+	$(QUANTUM_PATH)/split_common/transport.c
+
+split_common_transport_delta_i2c_INC := $(QUANTUM_PATH)/split_common $(QUANTUM_PATH)/split_common/tests $(DRIVER_PATH)/avr
+
+split_common_transport_delta_i2c_DEFS := -DSPLIT_TRANSPORT_DELTA -DUSE_I2C
+
+split_common_transport_delta_serial_SRC :=\
+	$(QUANTUM_PATH)/split_common/tests/transport_delta_serial_tests.cpp \
+	$(QUANTUM_PATH)/split_common/transport.c
+
+split_common_transport_delta_serial_INC := $(QUANTUM_PATH)/split_common $(QUANTUM_PATH)/split_common/tests $(DRIVER_PATH)/chibios
+
+split_common_transport_delta_serial_DEFS := -DSPLIT_TRANSPORT_DELTA -DSERIAL_USE_MULTI_TRANSACTION
@@ -0,0 +1,206 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <deque>
+#include "gtest/gtest.h"
+extern "C" {
+#include "split_common/serial_duplex.h"
+}
+
+// Loopback stand-in for the physical layer: every request sent by the
+// initiator is handled right away by the target, which answers through a
+// second queue.
+namespace {
+std::deque<uint8_t> to_target;
+std::deque<uint8_t> to_initiator;
+bool                in_target        = false;
+bool                target_connected = true;
+int                 corrupt_request  = -1;  // byte of the next request to flip, if any
+int                 corrupt_response = -1;  // byte of the next response to flip, if any
+bool                target_locked    = false;
+int                 target_locks     = 0;
+
+void corrupt(std::deque<uint8_t>& queue, size_t start, int& index) {
+    if (index >= 0) {
+        queue[start + index] ^= 0x10;
+        index = -1;
+    }
+}
+}  // namespace
+
+extern "C" {
+void soft_serial_target_lock(void) {
+    EXPECT_FALSE(target_locked);
+    target_locked = true;
+    target_locks++;
+}
+
+void soft_serial_target_unlock(void) {
+    EXPECT_TRUE(target_locked);
+    target_locked = false;
+}
+
+void serial_duplex_phy_init(bool initiator) {}
+
+void serial_duplex_phy_clear(void) { (in_target ? to_target : to_initiator).clear(); }
+
+bool serial_duplex_phy_send(const uint8_t* data, uint16_t size) {
+    // the lock is never held while waiting on the line
+    EXPECT_FALSE(target_locked);
+    if (in_target) {
+        size_t start = to_initiator.size();
+        to_initiator.insert(to_initiator.end(), data, data + size);
+        corrupt(to_initiator, start, corrupt_response);
+        return true;
+    }
+    size_t start = to_target.size();
+    to_target.insert(to_target.end(), data, data + size);
+    corrupt(to_target, start, corrupt_request);
+    if (target_connected) {
+        in_target = true;
+        serial_duplex_target_task();
+        in_target = false;
+    }
+    return true;
+}
+
+bool serial_duplex_phy_receive(uint8_t* data, uint16_t size, bool wait) {
+    EXPECT_FALSE(target_locked);
+    std::deque<uint8_t>& queue = in_target ? to_target : to_initiator;
+    if (queue.size() < size) {
+        // times out, whatever arrived is still in the queue
+        return false;
+    }
+    std::copy(queue.begin(), queue.begin() + size, data);
+    queue.erase(queue.begin(), queue.begin() + size);
+    return true;
+}
+}
+
+// The transaction table of one half, as transport.c would declare it
+struct SplitHalf {
+    uint8_t status[3]    = {};
+    uint8_t m2s[4]       = {};
+    uint8_t s2m[6]       = {};
+    uint8_t rgblight[10] = {};
+    SSTD_t  transactions[3];
+
+    SplitHalf() {
+        transactions[0] = {&status[0], sizeof(m2s), m2s, sizeof(s2m), s2m};
+        transactions[1] = {&status[1], 0, NULL, sizeof(s2m), s2m};
+        transactions[2] = {&status[2], sizeof(rgblight), rgblight, 0, NULL};
+    }
+};
+
+class SerialDuplex : public testing::Test {
+   public:
+    SerialDuplex() {
+        to_target.clear();
+        to_initiator.clear();
+        target_connected = true;
+        corrupt_request  = -1;
+        corrupt_response = -1;
+        target_locks     = 0;
+        soft_serial_target_init(target.transactions, TID_LIMIT(target.transactions));
+        soft_serial_initiator_init(master.transactions, TID_LIMIT(master.transactions));
+    }
+
+    SplitHalf master;
+    SplitHalf target;
+};
+
+TEST_F(SerialDuplex, TransfersBothDirections) {
+    uint8_t m2s[] = {1, 2, 3, 4};
+    uint8_t s2m[] = {5, 6, 7, 8, 9, 10};
+    memcpy(master.m2s, m2s, sizeof(m2s));
+    memcpy(target.s2m, s2m, sizeof(s2m));
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_END);
+    EXPECT_EQ(memcmp(target.m2s, m2s, sizeof(m2s)), 0);
+    EXPECT_EQ(memcmp(master.s2m, s2m, sizeof(s2m)), 0);
+    EXPECT_EQ(master.status[0], TRANSACTION_END);
+    EXPECT_EQ(target.status[0], TRANSACTION_ACCEPTED);
+    EXPECT_TRUE(to_target.empty());
+    EXPECT_TRUE(to_initiator.empty());
+}
+
+TEST_F(SerialDuplex, TargetCopiesUnderTheLock) {
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_END);
+    EXPECT_EQ(target_locks, 1);
+    EXPECT_FALSE(target_locked);
+}
+
+TEST_F(SerialDuplex, TransfersOneDirection) {
+    target.s2m[0]      = 42;
+    master.rgblight[9] = 24;
+    EXPECT_EQ(soft_serial_transaction(1), TRANSACTION_END);
+    EXPECT_EQ(master.s2m[0], 42);
+    EXPECT_EQ(soft_serial_transaction(2), TRANSACTION_END);
+    EXPECT_EQ(target.rgblight[9], 24);
+    EXPECT_EQ(soft_serial_get_and_clean_status(2), TRANSACTION_ACCEPTED);
+    EXPECT_EQ(target.status[2], 0);
+}
+
+TEST_F(SerialDuplex, RejectsInvalidTransaction) {
+    EXPECT_EQ(soft_serial_transaction(3), TRANSACTION_TYPE_ERROR);
+    EXPECT_TRUE(to_target.empty());
+}
+
+TEST_F(SerialDuplex, NoResponseWithoutTarget) {
+    target_connected = false;
+    target.s2m[0]    = 42;
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_NO_RESPONSE);
+    EXPECT_EQ(master.s2m[0], 0);
+    EXPECT_EQ(master.status[0], TRANSACTION_NO_RESPONSE);
+}
+
+TEST_F(SerialDuplex, CorruptRequestIsNotApplied) {
+    master.m2s[0]   = 42;
+    corrupt_request = 2;
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_NO_RESPONSE);
+    EXPECT_EQ(target.m2s[0], 0);
+    EXPECT_EQ(target.status[0], TRANSACTION_DATA_ERROR);
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_END);
+    EXPECT_EQ(target.m2s[0], 42);
+}
+
+TEST_F(SerialDuplex, CorruptResponseIsNotApplied) {
+    target.s2m[5]    = 42;
+    corrupt_response = 5;
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_DATA_ERROR);
+    EXPECT_EQ(master.s2m[5], 0);
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_END);
+    EXPECT_EQ(master.s2m[5], 42);
+}
+
+TEST_F(SerialDuplex, ResynchronizesAfterLineNoise) {
+    to_target.push_back(0x55);
+    to_target.push_back(SERIAL_DUPLEX_SYNC);
+    master.m2s[0] = 42;
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_NO_RESPONSE);
+    EXPECT_TRUE(to_target.empty());
+    EXPECT_EQ(soft_serial_transaction(0), TRANSACTION_END);
+    EXPECT_EQ(target.m2s[0], 42);
+}
+
+TEST_F(SerialDuplex, StaleResponseIsDropped) {
+    to_initiator.push_back(0x55);
+    target.s2m[0] = 42;
+    EXPECT_EQ(soft_serial_transaction(1), TRANSACTION_DATA_ERROR);
+    EXPECT_TRUE(to_initiator.empty());
+    EXPECT_EQ(soft_serial_transaction(1), TRANSACTION_END);
+    EXPECT_EQ(master.s2m[0], 42);
+}
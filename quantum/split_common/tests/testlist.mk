@@ -0,0 +1,4 @@
+TEST_LIST +=\
+	split_common_serial_duplex\
+	split_common_transport_delta_i2c\
+	split_common_transport_delta_serial
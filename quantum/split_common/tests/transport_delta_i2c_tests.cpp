@@ -0,0 +1,201 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "config.h"
+#include "transport.h"
+#include "i2c_master.h"
+#include "i2c_slave.h"
+}
+
+// Both halves run in the same process and share the slave registers, the
+// master reads and writes them through the mocked I2C master.
+namespace {
+struct Access {
+    uint8_t  regaddr;
+    uint16_t length;
+};
+
+std::vector<Access> reads;
+std::vector<Access> writes;
+bool                connected = true;
+// Called after the header has been read, to change the slave in the middle of a read
+void (*after_header)(void) = nullptr;
+
+// The header is four bytes with 4 rows per hand, and the rows follow it
+const uint8_t kRowsStart = 4;
+}  // namespace
+
+extern "C" {
+volatile uint8_t i2c_slave_reg[I2C_SLAVE_REG_COUNT];
+
+void i2c_init(void) {}
+
+void i2c_slave_init(uint8_t address) {}
+
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (!connected) {
+        return I2C_STATUS_TIMEOUT;
+    }
+    reads.push_back({regaddr, length});
+    memcpy(data, (const uint8_t*)i2c_slave_reg + regaddr, length);
+    if (reads.size() == 1 && after_header) {
+        after_header();
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (!connected) {
+        return I2C_STATUS_TIMEOUT;
+    }
+    writes.push_back({regaddr, length});
+    memcpy((uint8_t*)i2c_slave_reg + regaddr, data, length);
+    return I2C_STATUS_SUCCESS;
+}
+}
+
+class TransportDeltaI2C : public testing::Test {
+   public:
+    TransportDeltaI2C() {
+        memset((void*)i2c_slave_reg, 0, sizeof(i2c_slave_reg));
+        connected    = true;
+        after_header = nullptr;
+        transport_master_init();
+        transport_slave_init();
+        // The first poll transfers everything
+        slave_scan();
+        master_scan();
+    }
+
+    void slave_scan(void) { transport_slave(slave); }
+
+    bool master_scan(void) {
+        reads.clear();
+        writes.clear();
+        return transport_master(master);
+    }
+
+    std::vector<Access> row_reads(void) {
+        std::vector<Access> rows;
+        for (auto& read : reads) {
+            if (read.regaddr >= kRowsStart) {
+                rows.push_back(read);
+            }
+        }
+        return rows;
+    }
+
+    matrix_row_t slave[MATRIX_ROWS / 2]  = {};
+    matrix_row_t master[MATRIX_ROWS / 2] = {};
+};
+
+TEST_F(TransportDeltaI2C, OnlyPollsTheHeaderWhileNothingChanges) {
+    EXPECT_TRUE(master_scan());
+    ASSERT_EQ(reads.size(), 1);
+    EXPECT_EQ(reads[0].regaddr, 0);
+    EXPECT_TRUE(writes.empty());
+}
+
+TEST_F(TransportDeltaI2C, ReadsOnlyTheChangedRows) {
+    slave[2] = 0x81;
+    slave_scan();
+    EXPECT_TRUE(master_scan());
+    auto rows = row_reads();
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_EQ(rows[0].regaddr, kRowsStart + 2 * sizeof(matrix_row_t));
+    EXPECT_EQ(rows[0].length, sizeof(matrix_row_t));
+    EXPECT_EQ(master[2], 0x81);
+}
+
+TEST_F(TransportDeltaI2C, ReadsTheSpanOfRowsChangedSinceTheLastAck) {
+    slave[0] = 1;
+    slave_scan();
+    // The master misses this one
+    slave[3] = 8;
+    slave_scan();
+    EXPECT_TRUE(master_scan());
+    auto rows = row_reads();
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_EQ(rows[0].regaddr, kRowsStart);
+    EXPECT_EQ(rows[0].length, 4 * sizeof(matrix_row_t));
+    EXPECT_EQ(master[0], 1);
+    EXPECT_EQ(master[3], 8);
+}
+
+TEST_F(TransportDeltaI2C, AckClearsTheDirtyRows) {
+    slave[0] = 1;
+    slave_scan();
+    EXPECT_TRUE(master_scan());
+    // The ack is written along with the rest of the master state
+    EXPECT_FALSE(writes.empty());
+    slave_scan();
+
+    slave[1] = 2;
+    slave_scan();
+    EXPECT_TRUE(master_scan());
+    auto rows = row_reads();
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_EQ(rows[0].regaddr, kRowsStart + 1 * sizeof(matrix_row_t));
+    EXPECT_EQ(master[0], 1);
+    EXPECT_EQ(master[1], 2);
+}
+
+TEST_F(TransportDeltaI2C, UnackedRowsStayDirty) {
+    slave[0] = 1;
+    slave_scan();
+    connected = false;
+    EXPECT_FALSE(master_scan());
+    connected = true;
+
+    slave[1] = 2;
+    slave_scan();
+    EXPECT_TRUE(master_scan());
+    EXPECT_EQ(master[0], 1);
+    EXPECT_EQ(master[1], 2);
+}
+
+TEST_F(TransportDeltaI2C, ChangeDuringTheReadIsCaughtByTheCrc) {
+    static matrix_row_t* slave_rows;
+    slave_rows = slave;
+    slave[0]   = 1;
+    slave_scan();
+    // The slave publishes another row between the header and the row read
+    after_header = []() {
+        slave_rows[3] = 8;
+        transport_slave(slave_rows);
+    };
+    EXPECT_TRUE(master_scan());
+    after_header = nullptr;
+
+    // The rows read don't match the header's CRC, so everything is read again
+    EXPECT_TRUE(master_scan());
+    auto rows = row_reads();
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_EQ(rows[0].regaddr, kRowsStart);
+    EXPECT_EQ(rows[0].length, 4 * sizeof(matrix_row_t));
+    EXPECT_EQ(master[0], 1);
+    EXPECT_EQ(master[3], 8);
+}
+
+TEST_F(TransportDeltaI2C, IgnoresASlaveOfAnotherVersion) {
+    i2c_slave_reg[0]++;
+    EXPECT_FALSE(master_scan());
+}
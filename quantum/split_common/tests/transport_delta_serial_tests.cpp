@@ -0,0 +1,138 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vector>
+#include "gtest/gtest.h"
+extern "C" {
+#include "config.h"
+#include "transport.h"
+#include "serial.h"
+}
+
+// Both halves run in the same process and share the transaction buffers, so
+// a transaction only has to report how it went.
+namespace {
+enum { GET_SLAVE_STATUS, GET_SLAVE_MATRIX };
+
+std::vector<int>     transactions;
+bool                 connected = true;
+// Called before the matrix is fetched, to change the slave in between
+void (*before_matrix)(void) = nullptr;
+SSTD_t*              table  = nullptr;
+// The status the slave publishes once the master polls it again
+std::vector<uint8_t> next_status;
+}  // namespace
+
+extern "C" {
+void soft_serial_initiator_init(SSTD_t* sstd_table, int sstd_table_size) { table = sstd_table; }
+
+void soft_serial_target_init(SSTD_t* sstd_table, int sstd_table_size) {}
+
+int soft_serial_transaction(int sstd_index) {
+    if (!connected) {
+        return TRANSACTION_NO_RESPONSE;
+    }
+    transactions.push_back(sstd_index);
+    if (sstd_index == GET_SLAVE_STATUS && !next_status.empty()) {
+        std::copy(next_status.begin(), next_status.end(), table[GET_SLAVE_STATUS].target2initiator_buffer);
+        next_status.clear();
+    }
+    if (sstd_index == GET_SLAVE_MATRIX && before_matrix) {
+        before_matrix();
+    }
+    return TRANSACTION_END;
+}
+}
+
+class TransportDeltaSerial : public testing::Test {
+   public:
+    TransportDeltaSerial() {
+        connected     = true;
+        before_matrix = nullptr;
+        next_status.clear();
+        transport_master_init();
+        transport_slave_init();
+        slave_scan();
+        master_scan();
+    }
+
+    void slave_scan(void) { transport_slave(slave); }
+
+    bool master_scan(void) {
+        transactions.clear();
+        return transport_master(master);
+    }
+
+    matrix_row_t slave[MATRIX_ROWS / 2]  = {};
+    matrix_row_t master[MATRIX_ROWS / 2] = {};
+};
+
+TEST_F(TransportDeltaSerial, OnlyPollsTheStatusWhileNothingChanges) {
+    EXPECT_TRUE(master_scan());
+    EXPECT_EQ(transactions, std::vector<int>({GET_SLAVE_STATUS}));
+}
+
+TEST_F(TransportDeltaSerial, FetchesTheMatrixWhenItChanged) {
+    slave[1] = 0x42;
+    slave_scan();
+    EXPECT_TRUE(master_scan());
+    EXPECT_EQ(transactions, std::vector<int>({GET_SLAVE_STATUS, GET_SLAVE_MATRIX}));
+    EXPECT_EQ(master[1], 0x42);
+
+    EXPECT_TRUE(master_scan());
+    EXPECT_EQ(transactions, std::vector<int>({GET_SLAVE_STATUS}));
+}
+
+TEST_F(TransportDeltaSerial, ChangeBeforeTheMatrixIsFetchedAgain) {
+    static matrix_row_t* slave_rows;
+    slave_rows = slave;
+    slave[0]   = 1;
+    slave_scan();
+    // The master still has the status it polled before the change
+    before_matrix = []() {
+        uint8_t*             status = table[GET_SLAVE_STATUS].target2initiator_buffer;
+        uint8_t              size   = table[GET_SLAVE_STATUS].target2initiator_buffer_size;
+        std::vector<uint8_t> polled(status, status + size);
+        slave_rows[2] = 4;
+        transport_slave(slave_rows);
+        next_status.assign(status, status + size);
+        std::copy(polled.begin(), polled.end(), status);
+    };
+    EXPECT_TRUE(master_scan());
+    before_matrix = nullptr;
+
+    EXPECT_TRUE(master_scan());
+    EXPECT_EQ(transactions, std::vector<int>({GET_SLAVE_STATUS, GET_SLAVE_MATRIX}));
+    EXPECT_EQ(master[0], 1);
+    EXPECT_EQ(master[2], 4);
+    EXPECT_TRUE(master_scan());
+    EXPECT_EQ(transactions, std::vector<int>({GET_SLAVE_STATUS}));
+}
+
+TEST_F(TransportDeltaSerial, FetchesTheMatrixAfterLosingTheSlave) {
+    connected = false;
+    EXPECT_FALSE(master_scan());
+    connected = true;
+    EXPECT_TRUE(master_scan());
+    EXPECT_EQ(transactions, std::vector<int>({GET_SLAVE_STATUS, GET_SLAVE_MATRIX}));
+}
+
+TEST_F(TransportDeltaSerial, IgnoresASlaveOfAnotherVersion) {
+    // The version is the first byte of the status
+    table[GET_SLAVE_STATUS].target2initiator_buffer[0]++;
+    EXPECT_FALSE(master_scan());
+}
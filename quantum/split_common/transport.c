@@ -21,7 +21,218 @@ static pin_t encoders_pad[] = ENCODERS_PAD_A;
 #    define NUMBER_OF_ENCODERS (sizeof(encoders_pad) / sizeof(pin_t))
 #endif
 
-#if defined(USE_I2C)
+#ifdef SPLIT_TRANSPORT_DELTA
+// Bump when the layout of the data exchanged between the halves changes
+#    define SPLIT_TRANSPORT_VERSION 1
+
+_Static_assert(ROWS_PER_HAND <= 16, "SPLIT_TRANSPORT_DELTA supports up to 16 rows per hand");
+
+#    if ROWS_PER_HAND > 8
+typedef uint16_t split_rows_t;
+#    else
+typedef uint8_t split_rows_t;
+#    endif
+
+#    define SPLIT_ALL_ROWS ((split_rows_t)((1UL << ROWS_PER_HAND) - 1))
+
+// Published by the slave, and polled by the master instead of the whole matrix
+typedef struct _split_matrix_header_t {
+    uint8_t      version;
+    uint8_t      seq;         // incremented whenever a row of the slave matrix changes
+    uint8_t      crc;         // CRC-8 of the slave matrix at seq
+    split_rows_t dirty_rows;  // rows changed since the master last acknowledged a seq
+} split_matrix_header_t;
+
+static uint8_t split_matrix_crc8(const matrix_row_t matrix[]) {
+    const uint8_t *data = (const uint8_t *)matrix;
+    uint8_t        crc  = 0;
+    for (uint8_t i = 0; i < ROWS_PER_HAND * sizeof(matrix_row_t); i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Copies the slave matrix into the shared rows, and publishes a new seq if any of them changed
+static void split_matrix_publish(split_matrix_header_t *header, matrix_row_t shared[], const matrix_row_t matrix[]) {
+    split_rows_t changed = 0;
+    for (uint8_t i = 0; i < ROWS_PER_HAND; i++) {
+        if (shared[i] != matrix[i]) {
+            shared[i] = matrix[i];
+            changed |= (split_rows_t)1 << i;
+        }
+    }
+    if (changed) {
+        header->dirty_rows |= changed;
+        header->crc = split_matrix_crc8(shared);
+        header->seq++;
+    }
+}
+#endif
+
+#ifndef USE_I2C
+void soft_serial_target_lock(void);
+void soft_serial_target_unlock(void);
+
+// Serial drivers that answer from a thread rather than an interrupt, such as
+// usart_duplex, replace these to keep it off the buffers while the slave uses them
+__attribute__((weak)) void soft_serial_target_lock(void) {}
+__attribute__((weak)) void soft_serial_target_unlock(void) {}
+#endif
+
+#if defined(USE_I2C) && defined(SPLIT_TRANSPORT_DELTA)
+
+#    include "i2c_master.h"
+#    include "i2c_slave.h"
+
+// Written by the master in a single transfer whenever one of its fields changes
+typedef struct _I2C_m2s_frame_t {
+    uint8_t matrix_ack;
+    uint8_t backlight_level;
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    rgblight_syncinfo_t rgblight_sync;
+#    endif
+#    ifdef WPM_ENABLE
+    uint8_t current_wpm;
+#    endif
+} I2C_m2s_frame_t;
+
+typedef struct _I2C_slave_buffer_t {
+    // The header and the encoder state are read together on every scan
+    split_matrix_header_t header;
+#    ifdef ENCODER_ENABLE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+#    endif
+    matrix_row_t    smatrix[ROWS_PER_HAND];
+    I2C_m2s_frame_t m2s;
+} I2C_slave_buffer_t;
+
+_Static_assert(sizeof(I2C_slave_buffer_t) <= I2C_SLAVE_REG_COUNT, "Split transport data does not fit in the I2C slave registers");
+
+static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_reg;
+
+#    define I2C_HEADER_START offsetof(I2C_slave_buffer_t, header)
+#    define I2C_KEYMAP_START offsetof(I2C_slave_buffer_t, smatrix)
+#    define I2C_M2S_START offsetof(I2C_slave_buffer_t, m2s)
+
+#    define TIMEOUT 100
+
+#    ifndef SLAVE_I2C_ADDRESS
+#        define SLAVE_I2C_ADDRESS 0x32
+#    endif
+
+typedef struct _I2C_s2m_status_t {
+    split_matrix_header_t header;
+#    ifdef ENCODER_ENABLE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+#    endif
+} I2C_s2m_status_t;
+
+static bool            matrix_synced = false;  // whether our copy of the slave rows matches matrix_seq
+static uint8_t         matrix_seq    = 0;
+static I2C_m2s_frame_t m2s_sent      = {};
+
+// Poll the header of the other half, and only read the rows that changed
+bool transport_master(matrix_row_t matrix[]) {
+    I2C_s2m_status_t status;
+    if (i2c_readReg(SLAVE_I2C_ADDRESS, I2C_HEADER_START, (void *)&status, sizeof(status), TIMEOUT) < 0 || status.header.version != SPLIT_TRANSPORT_VERSION) {
+        matrix_synced = false;
+        return false;
+    }
+
+    I2C_m2s_frame_t m2s = m2s_sent;
+
+    if (!matrix_synced || status.header.seq != matrix_seq) {
+        split_rows_t rows = matrix_synced ? status.header.dirty_rows : SPLIT_ALL_ROWS;
+        if (rows) {
+            uint8_t first = 0;
+            uint8_t last  = ROWS_PER_HAND - 1;
+            while (!(rows & ((split_rows_t)1 << first))) first++;
+            while (!(rows & ((split_rows_t)1 << last))) last--;
+            if (i2c_readReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_START + first * sizeof(matrix_row_t), (void *)&matrix[first], (last - first + 1) * sizeof(matrix_row_t), TIMEOUT) < 0) {
+                matrix_synced = false;
+                return false;
+            }
+        }
+        // A mismatch means the slave changed while we were reading, so read everything next time
+        matrix_synced = split_matrix_crc8(matrix) == status.header.crc;
+        if (matrix_synced) {
+            matrix_seq     = status.header.seq;
+            m2s.matrix_ack = matrix_seq;
+        }
+    }
+
+#    ifdef BACKLIGHT_ENABLE
+    m2s.backlight_level = is_backlight_enabled() ? get_backlight_level() : 0;
+#    endif
+
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    bool rgblight_changed = rgblight_get_change_flags();
+    if (rgblight_changed) {
+        rgblight_get_syncinfo(&m2s.rgblight_sync);
+    }
+#    endif
+
+#    ifdef WPM_ENABLE
+    m2s.current_wpm = get_current_wpm();
+#    endif
+
+    if (memcmp(&m2s, &m2s_sent, sizeof(m2s)) != 0) {
+        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_M2S_START, (void *)&m2s, sizeof(m2s), TIMEOUT) >= 0) {
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+            if (rgblight_changed) {
+                rgblight_clear_change_flags();
+            }
+            // the slave clears its copy of the flags once it has applied them
+            m2s.rgblight_sync.status.change_flags = 0;
+#    endif
+            m2s_sent = m2s;
+        }
+    }
+
+#    ifdef ENCODER_ENABLE
+    encoder_update_raw(status.encoder_state);
+#    endif
+    return true;
+}
+
+void transport_slave(matrix_row_t matrix[]) {
+    split_matrix_header_t *header = &i2c_buffer->header;
+
+    header->version = SPLIT_TRANSPORT_VERSION;
+    if (i2c_buffer->m2s.matrix_ack == header->seq) {
+        header->dirty_rows = 0;
+    }
+    split_matrix_publish(header, i2c_buffer->smatrix, matrix);
+
+#    ifdef BACKLIGHT_ENABLE
+    backlight_set(i2c_buffer->m2s.backlight_level);
+#    endif
+
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    // Update the RGB with the new data
+    if (i2c_buffer->m2s.rgblight_sync.status.change_flags != 0) {
+        rgblight_update_sync(&i2c_buffer->m2s.rgblight_sync, false);
+        i2c_buffer->m2s.rgblight_sync.status.change_flags = 0;
+    }
+#    endif
+
+#    ifdef ENCODER_ENABLE
+    encoder_state_raw(i2c_buffer->encoder_state);
+#    endif
+
+#    ifdef WPM_ENABLE
+    set_current_wpm(i2c_buffer->m2s.current_wpm);
+#    endif
+}
+
+void transport_master_init(void) { i2c_init(); }
+
+void transport_slave_init(void) { i2c_slave_init(SLAVE_I2C_ADDRESS); }
+
+#elif defined(USE_I2C)
 
 #    include "i2c_master.h"
 #    include "i2c_slave.h"
@@ -124,6 +335,172 @@ void transport_master_init(void) { i2c_init(); }
 
 void transport_slave_init(void) { i2c_slave_init(SLAVE_I2C_ADDRESS); }
 
+#elif defined(SPLIT_TRANSPORT_DELTA)  // USE_SERIAL
+
+#    include "serial.h"
+
+typedef struct _Serial_s2m_status_t {
+    split_matrix_header_t header;
+#    ifdef ENCODER_ENABLE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+#    endif
+} Serial_s2m_status_t;
+
+typedef struct _Serial_m2s_frame_t {
+    uint8_t version;
+#    ifdef BACKLIGHT_ENABLE
+    uint8_t backlight_level;
+#    endif
+#    ifdef WPM_ENABLE
+    uint8_t current_wpm;
+#    endif
+} Serial_m2s_frame_t;
+
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+typedef struct _Serial_rgblight_t {
+    rgblight_syncinfo_t rgblight_sync;
+} Serial_rgblight_t;
+
+volatile Serial_rgblight_t serial_rgblight = {};
+uint8_t volatile status_rgblight           = 0;
+#    endif
+
+volatile Serial_s2m_status_t serial_s2m_status             = {};
+volatile Serial_m2s_frame_t  serial_m2s_frame              = {};
+volatile matrix_row_t        serial_smatrix[ROWS_PER_HAND] = {};
+uint8_t volatile status0                                   = 0;
+uint8_t volatile status_matrix                             = 0;
+
+// The rgblight sync info stays in a transaction of its own, sent only when it
+// changed, rather than adding its size to the status polled on every scan
+enum serial_transaction_id {
+    GET_SLAVE_STATUS = 0,
+    GET_SLAVE_MATRIX,
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    PUT_RGBLIGHT,
+#    endif
+};
+
+SSTD_t transactions[] = {
+    [GET_SLAVE_STATUS] =
+        {
+            (uint8_t *)&status0,
+            sizeof(serial_m2s_frame),
+            (uint8_t *)&serial_m2s_frame,
+            sizeof(serial_s2m_status),
+            (uint8_t *)&serial_s2m_status,
+        },
+    [GET_SLAVE_MATRIX] =
+        {
+            (uint8_t *)&status_matrix, 0, NULL, sizeof(serial_smatrix), (uint8_t *)serial_smatrix  // no master to slave transfer
+        },
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    [PUT_RGBLIGHT] =
+        {
+            (uint8_t *)&status_rgblight, sizeof(serial_rgblight), (uint8_t *)&serial_rgblight, 0, NULL  // no slave to master transfer
+        },
+#    endif
+};
+
+void transport_master_init(void) { soft_serial_initiator_init(transactions, TID_LIMIT(transactions)); }
+
+void transport_slave_init(void) { soft_serial_target_init(transactions, TID_LIMIT(transactions)); }
+
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+
+// rgblight synchronization information communication.
+
+void transport_rgblight_master(void) {
+    if (rgblight_get_change_flags()) {
+        rgblight_get_syncinfo((rgblight_syncinfo_t *)&serial_rgblight.rgblight_sync);
+        if (soft_serial_transaction(PUT_RGBLIGHT) == TRANSACTION_END) {
+            rgblight_clear_change_flags();
+        }
+    }
+}
+
+void transport_rgblight_slave(void) {
+    if (status_rgblight == TRANSACTION_ACCEPTED) {
+        soft_serial_target_lock();
+        rgblight_syncinfo_t rgblight_sync = *(rgblight_syncinfo_t *)&serial_rgblight.rgblight_sync;
+        status_rgblight                   = TRANSACTION_END;
+        soft_serial_target_unlock();
+        rgblight_update_sync(&rgblight_sync, false);
+    }
+}
+
+#    else
+#        define transport_rgblight_master()
+#        define transport_rgblight_slave()
+#    endif
+
+static bool    matrix_synced = false;  // whether our copy of the slave rows matches matrix_seq
+static uint8_t matrix_seq    = 0;
+
+// Poll the status of the other half, and only transfer the matrix when it changed
+bool transport_master(matrix_row_t matrix[]) {
+    transport_rgblight_master();
+
+    serial_m2s_frame.version = SPLIT_TRANSPORT_VERSION;
+#    ifdef BACKLIGHT_ENABLE
+    serial_m2s_frame.backlight_level = is_backlight_enabled() ? get_backlight_level() : 0;
+#    endif
+#    ifdef WPM_ENABLE
+    serial_m2s_frame.current_wpm = get_current_wpm();
+#    endif
+
+    if (soft_serial_transaction(GET_SLAVE_STATUS) != TRANSACTION_END || serial_s2m_status.header.version != SPLIT_TRANSPORT_VERSION) {
+        matrix_synced = false;
+        return false;
+    }
+
+    if (!matrix_synced || serial_s2m_status.header.seq != matrix_seq) {
+        if (soft_serial_transaction(GET_SLAVE_MATRIX) != TRANSACTION_END) {
+            matrix_synced = false;
+            return false;
+        }
+        for (int i = 0; i < ROWS_PER_HAND; ++i) {
+            matrix[i] = serial_smatrix[i];
+        }
+        // A mismatch means the slave changed between the two transactions, so read again next time
+        matrix_synced = split_matrix_crc8(matrix) == serial_s2m_status.header.crc;
+        if (matrix_synced) {
+            matrix_seq = serial_s2m_status.header.seq;
+        }
+    }
+
+#    ifdef ENCODER_ENABLE
+    encoder_update_raw((uint8_t *)serial_s2m_status.encoder_state);
+#    endif
+    return true;
+}
+
+void transport_slave(matrix_row_t matrix[]) {
+    transport_rgblight_slave();
+
+    soft_serial_target_lock();
+    split_matrix_header_t *header = (split_matrix_header_t *)&serial_s2m_status.header;
+    header->version               = SPLIT_TRANSPORT_VERSION;
+    // the whole matrix is transferred on a change, so there's nothing to acknowledge
+    header->dirty_rows = 0;
+    split_matrix_publish(header, (matrix_row_t *)serial_smatrix, matrix);
+#    ifdef ENCODER_ENABLE
+    encoder_state_raw((uint8_t *)serial_s2m_status.encoder_state);
+#    endif
+    Serial_m2s_frame_t m2s_frame = *(Serial_m2s_frame_t *)&serial_m2s_frame;
+    soft_serial_target_unlock();
+
+    // ignore anything sent by a master that speaks a different version
+    if (m2s_frame.version == SPLIT_TRANSPORT_VERSION) {
+#    ifdef BACKLIGHT_ENABLE
+        backlight_set(m2s_frame.backlight_level);
+#    endif
+#    ifdef WPM_ENABLE
+        set_current_wpm(m2s_frame.current_wpm);
+#    endif
+    }
+}
+
 #else  // USE_SERIAL
 
 #    include "serial.h"
@@ -211,8 +588,11 @@ void transport_rgblight_master(void) {
 
 void transport_rgblight_slave(void) {
     if (status_rgblight == TRANSACTION_ACCEPTED) {
-        rgblight_update_sync((rgblight_syncinfo_t *)&serial_rgblight.rgblight_sync, false);
-        status_rgblight = TRANSACTION_END;
+        soft_serial_target_lock();
+        rgblight_syncinfo_t rgblight_sync = *(rgblight_syncinfo_t *)&serial_rgblight.rgblight_sync;
+        status_rgblight                   = TRANSACTION_END;
+        soft_serial_target_unlock();
+        rgblight_update_sync(&rgblight_sync, false);
     }
 }
 
@@ -256,6 +636,7 @@ bool transport_master(matrix_row_t matrix[]) {
 
 void transport_slave(matrix_row_t matrix[]) {
     transport_rgblight_slave();
+    soft_serial_target_lock();
     // TODO: if MATRIX_COLS > 8 change to pack()
     for (int i = 0; i < ROWS_PER_HAND; ++i) {
         serial_s2m_buffer.smatrix[i] = matrix[i];
@@ -271,6 +652,7 @@ void transport_slave(matrix_row_t matrix[]) {
 #    ifdef WPM_ENABLE
     set_current_wpm(serial_m2s_buffer.current_wpm);
 #    endif
+    soft_serial_target_unlock();
 }
 
 #endif
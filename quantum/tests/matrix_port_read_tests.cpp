@@ -0,0 +1,134 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+// A GPIO with 16 pads on each of three ports, A0 is 0x00, B0 is 0x10 and C0 is 0x20
+extern "C" {
+typedef uint8_t  pin_t;
+typedef uint16_t port_data_t;
+
+static port_data_t ports[3];
+
+#define readPinPort(pin) (ports[(pin) >> 4])
+#define samePinPort(a, b) (((a) >> 4) == ((b) >> 4))
+#define getPinPad(pin) ((pin)&0xF)
+#define readPin(pin) ((readPinPort(pin) >> getPinPad(pin)) & 1)
+
+#include "matrix_port_read.h"
+}
+
+#define A(n) (0x00 | (n))
+#define B(n) (0x10 | (n))
+#define C(n) (0x20 | (n))
+
+class MatrixPortRead : public ::testing::Test {
+   protected:
+    matrix_port_run_t runs[32];
+    uint8_t           run_count;
+
+    void init(const pin_t pins[], uint8_t count) {
+        run_count = matrix_port_runs_init(runs, pins, count);
+        // each port is read once, by the first of its runs
+        for (uint8_t run = 0; run < run_count; run++) {
+            for (uint8_t later = run + 1; later < run_count; later++) {
+                if (samePinPort(runs[run].pin, runs[later].pin)) {
+                    EXPECT_FALSE(runs[later].new_port) << "run " << (int)later;
+                    EXPECT_EQ(later, run + 1) << "runs of a port are not together";
+                    break;
+                }
+            }
+        }
+    }
+
+    // Checks the runs give the same result as reading each pin with readPin
+    void expect_same_as_read_pin(const pin_t pins[], uint8_t count) {
+        for (uint32_t state = 0; state < 1u << count; state++) {
+            ports[0] = ports[1] = ports[2] = 0xFFFF;
+            for (uint8_t i = 0; i < count; i++) {
+                if (state & (1u << i)) {
+                    ports[pins[i] >> 4] &= ~(1 << getPinPad(pins[i]));
+                }
+            }
+            uint32_t expected = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                if (!readPin(pins[i])) {
+                    expected |= 1u << i;
+                }
+            }
+            ASSERT_EQ(matrix_port_runs_read_low(runs, run_count), expected) << "state " << state;
+        }
+    }
+};
+
+TEST_F(MatrixPortRead, ContiguousPinsAreOneRun) {
+    const pin_t pins[] = {B(2), B(3), B(4), B(5), B(6)};
+    init(pins, 5);
+    ASSERT_EQ(run_count, 1);
+    EXPECT_EQ(runs[0].mask, 0x7C);
+    EXPECT_EQ(runs[0].shift, -2);
+    EXPECT_TRUE(runs[0].new_port);
+    expect_same_as_read_pin(pins, 5);
+}
+
+TEST_F(MatrixPortRead, AGapInThePadsStartsANewRun) {
+    const pin_t pins[] = {B(0), B(1), B(4), B(5)};
+    init(pins, 4);
+    ASSERT_EQ(run_count, 2);
+    EXPECT_EQ(runs[0].mask, 0x03);
+    EXPECT_EQ(runs[0].shift, 0);
+    EXPECT_EQ(runs[1].mask, 0x30);
+    EXPECT_EQ(runs[1].shift, -2);
+    EXPECT_FALSE(runs[1].new_port);
+    expect_same_as_read_pin(pins, 4);
+}
+
+TEST_F(MatrixPortRead, ReversedPinsAreOneRunEach) {
+    const pin_t pins[] = {C(7), C(6), C(5), C(4)};
+    init(pins, 4);
+    ASSERT_EQ(run_count, 4);
+    for (uint8_t i = 0; i < 4; i++) {
+        EXPECT_EQ(runs[i].mask, 1 << getPinPad(pins[i]));
+    }
+    EXPECT_TRUE(runs[0].new_port);
+    expect_same_as_read_pin(pins, 4);
+}
+
+TEST_F(MatrixPortRead, PinsSplitAcrossPorts) {
+    // runs on B and A broken by pins on the other ports, A8 and A12 share a shift
+    const pin_t pins[] = {B(0), B(1), A(8), C(15), B(6), B(7), A(12), A(3)};
+    init(pins, 8);
+    ASSERT_EQ(run_count, 5);
+    EXPECT_EQ(runs[0].pin >> 4, 1);
+    EXPECT_EQ(runs[0].mask, 0x03);
+    EXPECT_EQ(runs[0].shift, 0);
+    EXPECT_EQ(runs[1].pin >> 4, 1);
+    EXPECT_EQ(runs[1].mask, 0xC0);
+    EXPECT_EQ(runs[1].shift, -2);
+    EXPECT_EQ(runs[2].pin >> 4, 0);
+    EXPECT_EQ(runs[2].mask, 0x1100);
+    EXPECT_EQ(runs[2].shift, -6);
+    EXPECT_EQ(runs[3].pin >> 4, 0);
+    EXPECT_EQ(runs[3].mask, 0x08);
+    EXPECT_EQ(runs[3].shift, 4);
+    EXPECT_EQ(runs[4].pin >> 4, 2);
+    EXPECT_EQ(runs[4].mask, 0x8000);
+    EXPECT_EQ(runs[4].shift, -12);
+    EXPECT_TRUE(runs[0].new_port);
+    EXPECT_TRUE(runs[2].new_port);
+    EXPECT_TRUE(runs[4].new_port);
+    expect_same_as_read_pin(pins, 8);
+}
@@ -44,6 +44,7 @@
 
 #include "raw_hid.h"
 #include "dynamic_keymap.h"
+#include "scan_profile.h"
 #include "tmk_core/common/eeprom.h"
 #include "version.h"  // for QMK_BUILDDATE used in EEPROM magic
 
@@ -116,6 +117,7 @@ void via_init(void) {
         dynamic_keymap_reset();
         // This resets the macros in EEPROM to nothing.
         dynamic_keymap_macro_reset();
+        dynamic_keymap_flush();
         // Save the magic number last, in case saving was interrupted
         via_eeprom_set_valid(true);
     }
@@ -380,10 +382,16 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             raw_hid_send(data, length);
             // Give host time to read it
             wait_ms(100);
+            dynamic_keymap_flush();
             bootloader_jump();
             break;
         }
         default: {
+#ifdef SCAN_PROFILE_ENABLE
+            if (scan_profile_raw_hid_receive(data, length)) {
+                break;
+            }
+#endif
             // The command ID is not known
             // Return the unhandled state
             *command_id = id_unhandled;
@@ -0,0 +1,256 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "synth.h"
+}
+
+namespace {
+
+constexpr size_t kSamplesPerMs = AUDIO_SAMPLE_RATE / 1000;
+
+float startup_sound[][2] = SONG(STARTUP_SOUND);
+float ode_to_joy[][2]    = SONG(ODE_TO_JOY);
+
+std::vector<int16_t> render_ms(size_t ms) {
+    std::vector<int16_t> pcm(ms * kSamplesPerMs);
+    audio_synth_render(pcm.data(), pcm.size());
+    return pcm;
+}
+
+// Renders a millisecond at a time until the song is over
+std::vector<int16_t> render_song(size_t limit_ms) {
+    std::vector<int16_t> pcm;
+    while (is_playing_notes() && pcm.size() < limit_ms * kSamplesPerMs) {
+        size_t at = pcm.size();
+        pcm.resize(at + kSamplesPerMs);
+        audio_synth_render(&pcm[at], kSamplesPerMs);
+    }
+    return pcm;
+}
+
+// Length of a song in ms, with the 5 ms gap after every note but the last
+size_t song_length_ms(float (*song)[2], size_t count, uint8_t tempo) {
+    size_t ms = 5 * (count - 1);
+    for (size_t i = 0; i < count; i++) {
+        ms += (uint32_t)song[i][1] * tempo * 8192 / 100000;
+    }
+    return ms;
+}
+
+// Frequency of the square wave between two points in ms, from the distance between its rising edges
+double measure_frequency(const std::vector<int16_t> &pcm, size_t from_ms, size_t to_ms) {
+    size_t first = 0, last = 0, edges = 0;
+    for (size_t i = from_ms * kSamplesPerMs + 1; i < to_ms * kSamplesPerMs; i++) {
+        if (pcm[i - 1] <= 0 && pcm[i] > 0) {
+            if (!edges) {
+                first = i;
+            }
+            last = i;
+            edges++;
+        }
+    }
+    return edges < 2 ? 0 : (double)(edges - 1) * AUDIO_SAMPLE_RATE / (last - first);
+}
+
+// Amplitude of one frequency in the signal, by the Goertzel algorithm over a Hann window
+double measure_amplitude(const std::vector<int16_t> &pcm, double freq) {
+    double coeff = 2 * std::cos(2 * M_PI * freq / AUDIO_SAMPLE_RATE);
+    double s1 = 0, s2 = 0;
+    for (size_t i = 0; i < pcm.size(); i++) {
+        double window = 0.5 - 0.5 * std::cos(2 * M_PI * i / pcm.size());
+        double s0     = pcm[i] * window + coeff * s1 - s2;
+        s2            = s1;
+        s1            = s0;
+    }
+    return 4 * std::sqrt(s1 * s1 + s2 * s2 - coeff * s1 * s2) / pcm.size();
+}
+
+int16_t peak(const std::vector<int16_t> &pcm) {
+    int16_t peak = 0;
+    for (int16_t sample : pcm) {
+        peak = std::max<int16_t>(peak, std::abs(sample));
+    }
+    return peak;
+}
+
+}  // namespace
+
+class AudioSynth : public TestFixture {
+   public:
+    void SetUp() override {
+        audio_on();
+        set_tempo(TEMPO_DEFAULT);
+        audio_synth_set_waveform(AUDIO_WAVEFORM_SQUARE);
+        stop_all_notes();
+        render_ms(1);
+    }
+};
+
+TEST_F(AudioSynth, PitchConversionsFollowEqualTemperament) {
+    for (int semitones = -48; semitones <= 36; semitones++) {
+        float freq = 440.0f * std::pow(2.0f, semitones / 12.0f);
+        EXPECT_NEAR(audio_synth_freq_to_pitch(freq), semitones * AUDIO_SYNTH_SEMITONE, 1) << freq << " Hz";
+        double rendered = (double)audio_synth_pitch_to_increment(semitones * AUDIO_SYNTH_SEMITONE) * AUDIO_SAMPLE_RATE / 4294967296.0;
+        EXPECT_NEAR(rendered, freq, freq * 0.001) << freq << " Hz";
+    }
+}
+
+TEST_F(AudioSynth, StartupSoundPlaysItsNotes) {
+    PLAY_SONG(startup_sound);
+    std::vector<int16_t> pcm = render_song(1000);
+
+    EXPECT_EQ(pcm.size() / kSamplesPerMs, song_length_ms(startup_sound, NOTE_ARRAY_SIZE(startup_sound), TEMPO_DEFAULT));
+    EXPECT_FALSE(is_playing_notes());
+    // E6, A6 and E7, measured away from the edges of each note
+    EXPECT_NEAR(measure_frequency(pcm, 5, 60), NOTE_E6, NOTE_E6 * 0.002);
+    EXPECT_NEAR(measure_frequency(pcm, 75, 130), NOTE_A6, NOTE_A6 * 0.002);
+    EXPECT_NEAR(measure_frequency(pcm, 145, 230), NOTE_E7, NOTE_E7 * 0.002);
+
+    render_ms(1);
+    EXPECT_FALSE(audio_synth_is_active());
+}
+
+TEST_F(AudioSynth, TempoScalesTheSong) {
+    set_tempo(TEMPO_DEFAULT * 2);
+    PLAY_SONG(ode_to_joy);
+    std::vector<int16_t> pcm = render_song(10000);
+
+    EXPECT_EQ(pcm.size() / kSamplesPerMs, song_length_ms(ode_to_joy, NOTE_ARRAY_SIZE(ode_to_joy), TEMPO_DEFAULT * 2));
+    EXPECT_NEAR(measure_frequency(pcm, 10, 250), NOTE_E4, NOTE_E4 * 0.002);
+}
+
+TEST_F(AudioSynth, RepeatedNotesAreSeparatedByARest) {
+    PLAY_SONG(ode_to_joy);
+    std::vector<int16_t> pcm = render_song(10000);
+
+    // The first two notes are both a quarter note E4
+    size_t first_end = song_length_ms(ode_to_joy, 1, TEMPO_DEFAULT);
+    EXPECT_NE(pcm[first_end * kSamplesPerMs - 1], 0);
+    for (size_t i = first_end * kSamplesPerMs; i < (first_end + 5) * kSamplesPerMs; i++) {
+        ASSERT_EQ(pcm[i], 0) << "at sample " << i;
+    }
+    EXPECT_NE(pcm[(first_end + 5) * kSamplesPerMs], 0);
+}
+
+TEST_F(AudioSynth, HeldNotesAreMixed) {
+    play_note(NOTE_A4, 0xF);
+    play_note(NOTE_E5, 0xF);
+    std::vector<int16_t> both = render_ms(50);
+    std::set<int16_t>    levels(both.begin(), both.end());
+    // Each square wave is either up or down, together they cancel out or add up
+    EXPECT_EQ(levels.size(), 3u);
+    EXPECT_EQ(levels.count(0), 1u);
+
+    stop_note(NOTE_E5);
+    std::vector<int16_t> one = render_ms(50);
+    EXPECT_EQ(std::set<int16_t>(one.begin(), one.end()).size(), 2u);
+    EXPECT_NEAR(measure_frequency(one, 1, 50), NOTE_A4, NOTE_A4 * 0.002);
+
+    stop_note(NOTE_A4);
+    std::vector<int16_t> none = render_ms(2);
+    EXPECT_EQ(std::set<int16_t>(none.begin() + kSamplesPerMs, none.end()).size(), 1u);
+    EXPECT_FALSE(audio_synth_is_active());
+}
+
+TEST_F(AudioSynth, WaveformsKeepTheirPitch) {
+    for (audio_waveform_t waveform : {AUDIO_WAVEFORM_SQUARE, AUDIO_WAVEFORM_TRIANGLE, AUDIO_WAVEFORM_SINE}) {
+        audio_synth_set_waveform(waveform);
+        play_note(NOTE_A4, 0xF);
+        std::vector<int16_t> pcm = render_ms(100);
+        EXPECT_NEAR(measure_frequency(pcm, 1, 100), NOTE_A4, NOTE_A4 * 0.002) << "waveform " << waveform;
+        EXPECT_NEAR(peak(pcm), 16383, 200) << "waveform " << waveform;
+        // Only the square wave spends its time at the peaks
+        EXPECT_EQ(std::set<int16_t>(pcm.begin() + kSamplesPerMs, pcm.end()).size() == 2, waveform == AUDIO_WAVEFORM_SQUARE) << "waveform " << waveform;
+        stop_all_notes();
+        render_ms(1);
+    }
+}
+
+TEST_F(AudioSynth, NewestNotesEachGetAnOscillator) {
+    const float chord[] = {NOTE_A4, NOTE_CS5, NOTE_E5, NOTE_A5};
+    for (float note : chord) {
+        play_note(note, 0xF);
+    }
+    std::vector<int16_t> pcm = render_ms(100);
+    for (float note : chord) {
+        EXPECT_GT(measure_amplitude(pcm, note), 3000) << note << " Hz";
+    }
+    EXPECT_LT(measure_amplitude(pcm, NOTE_D5), 500);
+    // Four square waves at full swing only just fit
+    EXPECT_LE(peak(pcm), 32767);
+    EXPECT_GT(peak(pcm), 30000);
+
+    // A fifth note takes over from the oldest one
+    play_note(NOTE_C6, 0xF);
+    render_ms(1);
+    pcm = render_ms(100);
+    EXPECT_LT(measure_amplitude(pcm, NOTE_A4), 500);
+    EXPECT_GT(measure_amplitude(pcm, NOTE_C6), 3000);
+}
+
+TEST_F(AudioSynth, StreamsThroughTheRingBuffer) {
+    play_note(NOTE_A4, 0xF);
+    std::vector<int16_t> pcm(AUDIO_SAMPLE_RATE / 10);
+    // Render ahead more often than the samples are taken, and in pieces that do not line up with the chunks
+    for (size_t at = 0; at < pcm.size(); at += 37) {
+        audio_synth_task();
+        audio_synth_task();
+        audio_synth_read(&pcm[at], std::min<size_t>(37, pcm.size() - at));
+    }
+    EXPECT_NEAR(measure_frequency(pcm, 1, 100), NOTE_A4, NOTE_A4 * 0.002);
+    for (size_t i = kSamplesPerMs; i < pcm.size(); i++) {
+        ASSERT_NE(pcm[i], 0) << "gap at sample " << i;
+    }
+
+    // Whatever was rendered ahead still plays after the note stops
+    stop_all_notes();
+    EXPECT_TRUE(audio_synth_is_active());
+    pcm.resize(AUDIO_SYNTH_BUFFER_SIZE + kSamplesPerMs);
+    audio_synth_read(pcm.data(), pcm.size());
+    EXPECT_FALSE(audio_synth_is_active());
+}
+
+TEST_F(AudioSynth, RenderThroughput) {
+    const size_t         seconds = 10;
+    const char *         names[] = {"square", "triangle", "sine"};
+    std::vector<int16_t> block(AUDIO_SAMPLE_RATE / 100);
+    for (audio_waveform_t waveform : {AUDIO_WAVEFORM_SQUARE, AUDIO_WAVEFORM_TRIANGLE, AUDIO_WAVEFORM_SINE}) {
+        audio_synth_set_waveform(waveform);
+        for (int notes = 1; notes <= AUDIO_OSCILLATORS; notes *= 2) {
+            stop_all_notes();
+            for (int i = 0; i < notes; i++) {
+                play_note(NOTE_A4 * (i + 1), 0xF);
+            }
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < seconds * AUDIO_SAMPLE_RATE / block.size(); i++) {
+                audio_synth_render(block.data(), block.size());
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            double                        rate    = seconds * AUDIO_SAMPLE_RATE / elapsed.count();
+            std::cout << "[ BENCH    ] " << names[waveform] << ", " << notes << " notes: " << (uint64_t)rate << " samples/s, " << rate / AUDIO_SAMPLE_RATE << "x real time" << std::endl;
+            EXPECT_GT(rate, AUDIO_SAMPLE_RATE);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "test_events.h"
+void set_time(uint32_t t);
+}
+
+using testing::_;
+using testing::InSequence;
+
+class BatchKeyEvents : public TestFixture {
+   protected:
+    void SetUp() override { num_recorded_events = 0; }
+};
+
+TEST_F(BatchKeyEvents, TwoKeysAreReportedInOneScan) {
+    TestDriver driver;
+    InSequence s;
+    press_key(1, 0);
+    press_key(0, 3);
+    // Same order as the one key per scan mode, but without waiting for a second scan
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C)));
+    keyboard_task();
+    release_key(1, 0);
+    release_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(BatchKeyEvents, EventsAreDispatchedInMatrixOrder) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    press_key(0, 3);
+    press_key(1, 1);
+    press_key(0, 0);
+    keyboard_task();
+    ASSERT_EQ(num_recorded_events, 3);
+    EXPECT_EQ(recorded_events[0].key.row, 0);
+    EXPECT_EQ(recorded_events[0].key.col, 0);
+    EXPECT_EQ(recorded_events[1].key.row, 1);
+    EXPECT_EQ(recorded_events[1].key.col, 1);
+    EXPECT_EQ(recorded_events[2].key.row, 3);
+    EXPECT_EQ(recorded_events[2].key.col, 0);
+    for (uint8_t i = 0; i < num_recorded_events; i++) {
+        EXPECT_TRUE(recorded_events[i].pressed);
+    }
+}
+
+TEST_F(BatchKeyEvents, EventsShareTheScanTimestamp) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    set_time(1000);
+    press_key(0, 0);
+    press_key(1, 0);
+    keyboard_task();
+    ASSERT_EQ(num_recorded_events, 2);
+    // The time is taken when the matrix is read, and is never 0
+    EXPECT_EQ(recorded_events[0].time, 1000 | 1);
+    EXPECT_EQ(recorded_events[1].time, 1000 | 1);
+}
+
+TEST_F(BatchKeyEvents, ChangesBeyondTheQueueSizeAreDeferredToTheNextScan) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    set_time(2000);
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(6, 0);
+    press_key(7, 0);
+    press_key(8, 0);
+    press_key(9, 0);
+    keyboard_task();
+    ASSERT_EQ(num_recorded_events, QMK_BATCH_KEY_EVENTS_SIZE);
+    EXPECT_EQ(recorded_events[3].key.col, 7);
+    set_time(2010);
+    keyboard_task();
+    ASSERT_EQ(num_recorded_events, 6);
+    EXPECT_EQ(recorded_events[4].key.col, 8);
+    EXPECT_EQ(recorded_events[5].key.col, 9);
+    EXPECT_EQ(recorded_events[4].time, 2010 | 1);
+    EXPECT_EQ(recorded_events[5].time, 2010 | 1);
+}
@@ -0,0 +1,69 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+#include "test_combos.h"
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J},
+        {KC_K, KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T},
+        {KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z, KC_1, KC_2, KC_3, KC_4},
+        {KC_5, KC_6, KC_7, KC_8, KC_9, KC_0, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+const uint16_t PROGMEM ab_combo[]   = {KC_A, KC_B, COMBO_END};
+const uint16_t PROGMEM abc_combo[]  = {KC_A, KC_B, KC_C, COMBO_END};
+const uint16_t PROGMEM de_combo[]   = {KC_D, KC_E, COMBO_END};
+const uint16_t PROGMEM fg_combo[]   = {KC_F, KC_G, COMBO_END};
+const uint16_t PROGMEM long_combo[] = {
+    KC_K, KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T,
+    KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z, KC_1, KC_2, KC_3, KC_4,
+    COMBO_END
+};
+// clang-format on
+
+static uint16_t benchmark_combos[COMBO_BENCHMARK_COUNT][BENCHMARK_COMBO_SIZE + 1];
+
+combo_t key_combos[COMBO_COUNT] = {
+    [AB_ESC]    = COMBO(ab_combo, KC_ESC),
+    [ABC_TAB]   = COMBO(abc_combo, KC_TAB),
+    [DE_ENT]    = COMBO(de_combo, KC_ENT),
+    [FG_ACTION] = COMBO_ACTION(fg_combo),
+    [LONG_SPC]  = COMBO(long_combo, KC_SPC),
+};
+
+combo_event_t combo_events[MAX_COMBO_EVENTS];
+uint8_t       num_combo_events = 0;
+
+void process_combo_event(uint8_t combo_index, bool pressed) {
+    if (num_combo_events < MAX_COMBO_EVENTS) {
+        combo_events[num_combo_events++] = (combo_event_t){.combo_index = combo_index, .pressed = pressed};
+    }
+}
+
+void keyboard_post_init_user(void) {
+    // Spread the benchmark combos over a set of keycodes, so that each of them is in many combos
+    for (uint16_t i = 0; i < COMBO_BENCHMARK_COUNT; i++) {
+        for (uint8_t k = 0; k < BENCHMARK_COMBO_SIZE; k++) {
+            benchmark_combos[i][k] = BENCHMARK_KEYCODE_FIRST + (i * (k + 1) + k * 7) % BENCHMARK_KEYCODE_COUNT;
+        }
+        benchmark_combos[i][BENCHMARK_COMBO_SIZE] = COMBO_END;
+        key_combos[COMBO_FUNCTIONAL_COUNT + i]     = (combo_t)COMBO_ACTION(benchmark_combos[i]);
+    }
+}
@@ -0,0 +1,185 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+
+extern "C" {
+#include "test_combos.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class Combo : public TestFixture {
+   protected:
+    void SetUp() override { num_combo_events = 0; }
+};
+
+TEST_F(Combo, ComboWithoutLongerCombosFiresImmediately) {
+    TestDriver driver;
+    InSequence s;
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ENT)));
+    run_one_scan_loop();
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, LongestComboWins) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(2, 0);
+    // A+B is held back while A+B+C can still be completed
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_TAB)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    idle_for(3);
+}
+
+TEST_F(Combo, ShorterComboFiresAfterComboTerm) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    idle_for(2);
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    idle_for(2);
+}
+
+TEST_F(Combo, ShorterComboFiresWhenAKeyIsReleased) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(2);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    run_one_scan_loop();
+}
+
+TEST_F(Combo, ShorterComboFiresBeforeAnUnrelatedKey) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(2);
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC, KC_H)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_H)));
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(3);
+}
+
+TEST_F(Combo, ComboActionCallsProcessComboEvent) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(5, 0);
+    press_key(6, 0);
+    idle_for(2);
+    ASSERT_EQ(num_combo_events, 1);
+    EXPECT_EQ(combo_events[0].combo_index, FG_ACTION);
+    EXPECT_TRUE(combo_events[0].pressed);
+    release_key(5, 0);
+    release_key(6, 0);
+    idle_for(2);
+    ASSERT_EQ(num_combo_events, 2);
+    EXPECT_EQ(combo_events[1].combo_index, FG_ACTION);
+    EXPECT_FALSE(combo_events[1].pressed);
+}
+
+TEST_F(Combo, ComboWithTwentyKeys) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    for (uint8_t row = 1; row <= 2; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (row == 2 && col == MATRIX_COLS - 1) {
+                EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_SPC)));
+            }
+            press_key(col, row);
+            run_one_scan_loop();
+        }
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    clear_all_keys();
+    idle_for(MATRIX_ROWS * MATRIX_COLS);
+}
+
+TEST_F(Combo, Benchmark) {
+    // Keep the cost of the mocked driver out of the measurement
+    host_set_driver(nullptr);
+    const int iterations = 20000;
+
+    // Keys that aren't part of any combo, which is what most typing is
+    keyrecord_t record = {};
+    auto        start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        record.event.pressed = !(i & 1);
+        process_combo(KC_H, &record);
+    }
+    auto not_in_combo = std::chrono::steady_clock::now() - start;
+
+    // Press and release keys that are each part of dozens of the benchmark combos
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        record.event.pressed = !(i & 1);
+        process_combo(BENCHMARK_KEYCODE_FIRST + (i / 2) % BENCHMARK_KEYCODE_COUNT, &record);
+    }
+    auto in_combos = std::chrono::steady_clock::now() - start;
+
+    std::cout << "[ BENCH    ] " << COMBO_COUNT << " combos, key in no combo: " << std::chrono::duration_cast<std::chrono::nanoseconds>(not_in_combo).count() / iterations << " ns/event" << std::endl;
+    std::cout << "[ BENCH    ] " << COMBO_COUNT << " combos, key in many combos: " << std::chrono::duration_cast<std::chrono::nanoseconds>(in_combos).count() / iterations << " ns/event" << std::endl;
+    combo_disable();
+    combo_enable();
+    clear_keyboard();
+}
@@ -0,0 +1,36 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+enum test_combos { AB_ESC, ABC_TAB, DE_ENT, FG_ACTION, LONG_SPC };
+
+// Keycodes used only by the benchmark combos, none of them are on the matrix
+#define BENCHMARK_KEYCODE_FIRST KC_F13
+#define BENCHMARK_KEYCODE_COUNT 40
+#define BENCHMARK_COMBO_SIZE 3
+
+// Every call of process_combo_event, in order
+#define MAX_COMBO_EVENTS 8
+typedef struct {
+    uint8_t combo_index;
+    bool    pressed;
+} combo_event_t;
+
+extern combo_event_t combo_events[MAX_COMBO_EVENTS];
+extern uint8_t       num_combo_events;
@@ -0,0 +1,105 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "eeconfig.h"
+#include "eeprom.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class DynamicKeymap : public TestFixture {
+   protected:
+    void SetUp() override {
+        dynamic_keymap_reset();
+        dynamic_keymap_flush();
+    }
+
+    // What the EEPROM holds for a key, as opposed to what the keyboard uses
+    static uint16_t stored_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+        uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(layer, row, column);
+        return (eeprom_read_byte(address) << 8) | eeprom_read_byte(address + 1);
+    }
+
+    static void store_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+        uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(layer, row, column);
+        eeprom_update_byte(address, keycode >> 8);
+        eeprom_update_byte(address + 1, keycode & 0xFF);
+    }
+};
+
+TEST_F(DynamicKeymap, ChangesAreUsedBeforeTheyAreWritten) {
+    TestDriver driver;
+    InSequence s;
+    dynamic_keymap_set_keycode(0, 0, 0, KC_B);
+    EXPECT_EQ(stored_keycode(0, 0, 0), KC_A);
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_EQ(stored_keycode(0, 0, 0), KC_A);
+}
+
+TEST_F(DynamicKeymap, ChangesAreWrittenOnceTheKeymapIsLeftAlone) {
+    TestDriver driver;
+    dynamic_keymap_set_keycode(0, 0, 0, KC_B);
+    dynamic_keymap_set_keycode(1, 3, 9, KC_C);
+    idle_for(DYNAMIC_KEYMAP_WRITE_DELAY);
+    EXPECT_EQ(stored_keycode(0, 0, 0), KC_A);
+
+    // The range between both keys goes out a chunk per scan
+    idle_for(1);
+    EXPECT_EQ(stored_keycode(0, 0, 0), KC_B);
+    EXPECT_EQ(stored_keycode(1, 3, 9), KC_NO);
+    idle_for(DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2 / DYNAMIC_KEYMAP_WRITE_CHUNK);
+    EXPECT_EQ(stored_keycode(1, 3, 9), KC_C);
+}
+
+TEST_F(DynamicKeymap, FlushWritesEverythingAtOnce) {
+    dynamic_keymap_set_keycode(0, 0, 0, KC_B);
+    dynamic_keymap_set_keycode(1, 3, 9, KC_C);
+    dynamic_keymap_flush();
+    EXPECT_EQ(stored_keycode(0, 0, 0), KC_B);
+    EXPECT_EQ(stored_keycode(1, 3, 9), KC_C);
+}
+
+TEST_F(DynamicKeymap, EepromResetReloadsTheRamCopy) {
+    TestDriver driver;
+    InSequence s;
+    dynamic_keymap_set_keycode(0, 0, 0, KC_B);
+    // Stands in for the EEPROM erase in eeconfig_init_quantum on ARM
+    store_keycode(0, 0, 0, KC_C);
+    eeconfig_init();
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 0), KC_C);
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    // The change made before the reset is not written over it
+    idle_for(DYNAMIC_KEYMAP_WRITE_DELAY * 2);
+    EXPECT_EQ(stored_keycode(0, 0, 0), KC_C);
+}
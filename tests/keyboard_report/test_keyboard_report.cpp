@@ -0,0 +1,106 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class KeyboardReportBatching : public TestFixture {};
+
+TEST_F(KeyboardReportBatching, KeysPressedInOneScanGoOutInOneReport) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_LSFT)));
+    keyboard_task();
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
+
+TEST_F(KeyboardReportBatching, ATapWithinOneScanIsStillSeenByTheHost) {
+    TestDriver driver;
+    InSequence s;
+    press_key(4, 0);
+    run_one_scan_loop();
+    // The press and the release of the tap are both registered when the key goes up
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(KeyboardReportBatching, ModifiersChangedBackAreStillSeenByTheHost) {
+    TestDriver driver;
+    InSequence s;
+    // S(KC_1) adds and removes a weak shift within one scan
+    press_key(5, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_1)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(5, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(KeyboardReportBatching, ModsInTheReportAreCurrentBeforeItIsSent) {
+    TestDriver driver;
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    add_mods(MOD_BIT(KC_LSFT));
+    send_keyboard_report();
+    EXPECT_EQ(keyboard_report->mods, MOD_BIT(KC_LSFT));
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    flush_keyboard_report();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    del_mods(MOD_BIT(KC_LSFT));
+    send_keyboard_report();
+    EXPECT_EQ(keyboard_report->mods, 0);
+    flush_keyboard_report();
+}
+
+TEST_F(KeyboardReportBatching, IdenticalReportsAreLeftOut) {
+    TestDriver driver;
+    uint8_t    generation = get_keyboard_report_generation();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    send_keyboard_report();
+    flush_keyboard_report();
+    clear_keyboard();
+    flush_keyboard_report();
+    EXPECT_EQ(get_keyboard_report_generation(), generation);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    add_key(KC_A);
+    send_keyboard_report();
+    flush_keyboard_report();
+    send_keyboard_report();
+    flush_keyboard_report();
+    EXPECT_EQ(get_keyboard_report_generation(), (uint8_t)(generation + 1));
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    del_key(KC_A);
+    send_keyboard_report();
+    flush_keyboard_report();
+}
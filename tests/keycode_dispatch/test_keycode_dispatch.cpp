@@ -0,0 +1,192 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+#include "process_dispatch.h"
+
+extern bool     block_user_keycodes;
+extern uint32_t user_keycode_count;
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class KeycodeDispatch : public TestFixture {
+   protected:
+    void SetUp() override {
+        block_user_keycodes = false;
+        user_keycode_count  = 0;
+    }
+};
+
+TEST_F(KeycodeDispatch, AlphaKeyReachesProcessRecordUser) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_EQ(user_keycode_count, 2u);
+}
+
+TEST_F(KeycodeDispatch, RangedStageStillHandlesItsKeycode) {
+    TestDriver driver;
+    InSequence s;
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    run_one_scan_loop();
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    press_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_GRV)));
+    run_one_scan_loop();
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(KeycodeDispatch, UserHookStillRunsBeforeRangedStages) {
+    TestDriver driver;
+    block_user_keycodes = true;
+    // process_record_user swallowing GRAVE_ESC must keep process_grave_esc from seeing it
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    press_key(3, 0);
+    run_one_scan_loop();
+    release_key(3, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(user_keycode_count, 2u);
+}
+
+static std::vector<int> calls;
+
+static bool handler_0(uint16_t keycode, keyrecord_t *record) {
+    calls.push_back(0);
+    return true;
+}
+static bool handler_1(uint16_t keycode, keyrecord_t *record) {
+    calls.push_back(1);
+    return true;
+}
+static bool handler_2(uint16_t keycode, keyrecord_t *record) {
+    calls.push_back(2);
+    return keycode != 0x15;
+}
+static bool handler_3(uint16_t keycode, keyrecord_t *record) {
+    calls.push_back(3);
+    return true;
+}
+
+static const process_dispatch_entry_t test_handlers[] = {
+    PROCESS_ALL(handler_0),
+    PROCESS_RANGE(handler_1, 0x10, 0x20),
+    PROCESS_RANGE(handler_1, 0x8000, 0xFFFF),
+    PROCESS_KEYCODE(handler_2, 0x15),
+    PROCESS_RANGE(handler_2, 0x18, 0x30),
+    PROCESS_ALL(handler_3),
+};
+
+PROCESS_DISPATCH_DEFINE(test_dispatch, test_handlers);
+
+// Which handler each entry of test_handlers calls
+static const int test_handler_ids[] = {0, 1, 1, 2, 2, 3};
+
+class ProcessDispatch : public testing::Test {
+   protected:
+    std::vector<int> run(uint16_t keycode, bool expected_result = true) {
+        keyrecord_t record = {};
+        calls.clear();
+        EXPECT_EQ(test_dispatch(keycode, &record), expected_result);
+        return calls;
+    }
+};
+
+TEST_F(ProcessDispatch, OnlyCoveringHandlersRunInTableOrder) {
+    EXPECT_EQ(run(KC_A), std::vector<int>({0, 3}));
+    EXPECT_EQ(run(0x10), std::vector<int>({0, 1, 3}));
+    EXPECT_EQ(run(0x18), std::vector<int>({0, 1, 2, 3}));
+    EXPECT_EQ(run(0x21), std::vector<int>({0, 2, 3}));
+    EXPECT_EQ(run(0x31), std::vector<int>({0, 3}));
+    EXPECT_EQ(run(0x8000), std::vector<int>({0, 1, 3}));
+    EXPECT_EQ(run(0xFFFF), std::vector<int>({0, 1, 3}));
+}
+
+TEST_F(ProcessDispatch, StopsAtFirstHandlerReturningFalse) { EXPECT_EQ(run(0x15, false), std::vector<int>({0, 1, 2})); }
+
+TEST_F(ProcessDispatch, CalledHandlersMatchRangesForEveryKeycode) {
+    for (uint32_t keycode = 0; keycode <= 0xFFFF; keycode++) {
+        std::vector<int> expected;
+        for (uint8_t i = 0; i < PROCESS_DISPATCH_COUNT(test_handlers); i++) {
+            if (test_handlers[i].first <= keycode && keycode <= test_handlers[i].last) {
+                expected.push_back(test_handler_ids[i]);
+                // handler_2 stops the chain for 0x15
+                if (test_handler_ids[i] == 2 && keycode == 0x15) {
+                    break;
+                }
+            }
+        }
+        ASSERT_EQ(run(keycode, keycode != 0x15), expected) << "keycode " << keycode;
+    }
+}
+
+#if defined(UNICODE_ENABLE) && defined(SPACE_CADET_ENABLE) && defined(MAGIC_KEYCODE_ENABLE) && defined(GRAVE_ESC_ENABLE)
+// The stages enabled for this keyboard, run the way process_record_quantum used to: every stage sees every keycode
+static bool __attribute__((noinline)) process_record_chain(uint16_t keycode, keyrecord_t *record) {
+    return process_record_kb(keycode, record) && process_unicode_common(keycode, record) && process_space_cadet(keycode, record) && process_magic(keycode, record) && process_grave_esc(keycode, record);
+}
+
+TEST_F(KeycodeDispatch, Benchmark) {
+    const int   iterations = 2000000;
+    keyrecord_t record     = {};
+    bool        result     = true;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        record.event.pressed = i & 1;
+        result &= process_record_chain(KC_A + (i >> 1) % 26, &record);
+    }
+    auto chain = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        record.event.pressed = i & 1;
+        result &= process_record_dispatch(KC_A + (i >> 1) % 26, &record);
+    }
+    auto table = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(result);
+    EXPECT_EQ(user_keycode_count, 2u * iterations);
+
+    std::cout << "[ BENCH    ] alpha keys through every stage: " << std::chrono::duration<double, std::nano>(chain).count() / iterations << " ns/event" << std::endl;
+    std::cout << "[ BENCH    ] alpha keys through the dispatch table: " << std::chrono::duration<double, std::nano>(table).count() / iterations << " ns/event" << std::endl;
+}
+#endif
@@ -0,0 +1,29 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+#include "test_keymap.h"
+
+// Only referenced by the default keymap_key_to_keycode, which is overridden below
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {{{KC_NO}}};
+
+uint16_t test_keymap[TEST_LAYER_COUNT][MATRIX_ROWS][MATRIX_COLS];
+uint32_t keycode_lookups = 0;
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    keycode_lookups++;
+    return test_keymap[layer][key.row][key.col];
+}
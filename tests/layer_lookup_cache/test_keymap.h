@@ -0,0 +1,26 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "keyboard.h"
+
+#define TEST_LAYER_COUNT 32
+
+// Writable keymap that replaces keymaps[][][], similar to what dynamic_keymap does
+extern uint16_t test_keymap[TEST_LAYER_COUNT][MATRIX_ROWS][MATRIX_COLS];
+// Number of times keymap_key_to_keycode has been called
+extern uint32_t keycode_lookups;
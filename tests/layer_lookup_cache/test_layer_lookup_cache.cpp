@@ -0,0 +1,147 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+
+extern "C" {
+#include "test_keymap.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class LayerLookupCache : public TestFixture {
+   protected:
+    // Layer changes send reports, which aren't of interest here
+    TestDriver driver;
+
+    void SetUp() override {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+        // Layer 0 maps every key, every other layer is transparent
+        for (uint8_t layer = 0; layer < TEST_LAYER_COUNT; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    test_keymap[layer][row][col] = layer == 0 ? KC_A : KC_TRNS;
+                }
+            }
+        }
+        layer_lookup_cache_invalidate();
+        layer_clear();
+        keycode_lookups = 0;
+    }
+};
+
+static const keypos_t key_a = {.col = 0, .row = 0};
+static const keypos_t key_b = {.col = 1, .row = 0};
+
+TEST_F(LayerLookupCache, ReturnsTopmostNonTransparentLayer) {
+    test_keymap[1][0][0] = KC_B;
+    test_keymap[2][0][0] = KC_C;
+    layer_on(1);
+    layer_on(3);
+    EXPECT_EQ(layer_switch_get_layer(key_a), 1);
+    EXPECT_EQ(layer_switch_get_layer(key_b), 0);
+    layer_on(2);
+    EXPECT_EQ(layer_switch_get_layer(key_a), 2);
+    EXPECT_EQ(layer_switch_get_layer(key_b), 0);
+}
+
+TEST_F(LayerLookupCache, RepeatedLookupsDoNotReadTheKeymap) {
+    layer_on(5);
+    EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+    uint32_t lookups = keycode_lookups;
+    EXPECT_GT(lookups, 0u);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+    }
+    EXPECT_EQ(keycode_lookups, lookups);
+}
+
+TEST_F(LayerLookupCache, LayerStateChangeInvalidatesTheCache) {
+    test_keymap[4][0][0] = KC_B;
+    EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+    layer_on(4);
+    EXPECT_EQ(layer_switch_get_layer(key_a), 4);
+    layer_off(4);
+    EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+}
+
+TEST_F(LayerLookupCache, DirectLayerStateWritesInvalidateTheCache) {
+    test_keymap[4][0][0] = KC_B;
+    EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+    layer_state = 1UL << 4;
+    EXPECT_EQ(layer_switch_get_layer(key_a), 4);
+    layer_state = 0;
+}
+
+TEST_F(LayerLookupCache, DefaultLayerChangeInvalidatesTheCache) {
+    test_keymap[1][0][0] = KC_B;
+    EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+    default_layer_set(1UL << 1);
+    EXPECT_EQ(layer_switch_get_layer(key_a), 1);
+    default_layer_set(0);
+    EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+}
+
+TEST_F(LayerLookupCache, KeymapWritesNeedAnInvalidate) {
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+    test_keymap[1][0][0] = KC_B;
+    EXPECT_EQ(layer_switch_get_layer(key_a), 0);
+    layer_lookup_cache_invalidate();
+    EXPECT_EQ(layer_switch_get_layer(key_a), 1);
+}
+
+TEST_F(LayerLookupCache, PressedKeyUsesTheCachedLayer) {
+    test_keymap[1][0][0] = KC_B;
+    layer_on(1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    press_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(LayerLookupCache, Benchmark) {
+    const int iterations = 100000;
+    // Worst case for the walk: every layer is on, and only layer 0 maps the key
+    layer_state = ~(layer_state_t)0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        layer_lookup_cache_invalidate();
+        layer_switch_get_layer(key_a);
+    }
+    auto miss = std::chrono::steady_clock::now() - start;
+    uint32_t miss_lookups = keycode_lookups;
+
+    keycode_lookups = 0;
+    start           = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        layer_switch_get_layer(key_a);
+    }
+    auto hit = std::chrono::steady_clock::now() - start;
+
+    layer_state = 0;
+    EXPECT_EQ(keycode_lookups, 0u);
+    EXPECT_EQ(miss_lookups, (uint32_t)iterations * TEST_LAYER_COUNT);
+
+    std::cout << "[ BENCH    ] miss (refill + walk of " << TEST_LAYER_COUNT << " layers): " << std::chrono::duration_cast<std::chrono::nanoseconds>(miss).count() / iterations << " ns/lookup" << std::endl;
+    std::cout << "[ BENCH    ] hit: " << std::chrono::duration_cast<std::chrono::nanoseconds>(hit).count() / iterations << " ns/lookup" << std::endl;
+}
@@ -0,0 +1,103 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "action_tapping.h"
+#include "matrix_idle.h"
+extern bool block_idle;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class MatrixIdle : public TestFixture {
+   protected:
+    void SetUp() override {
+        TestFixture::SetUp();
+        block_idle = false;
+        // start every test scanning, with the timeout restarted
+        matrix_idle_leave(true);
+    }
+
+    // Runs scans for ms ms and returns whether the matrix went idle after any of them
+    bool idle_after(uint16_t ms) {
+        bool idle = false;
+        for (uint16_t i = 0; i < ms; i++) {
+            run_one_scan_loop();
+            idle |= matrix_idle_enter(false);
+        }
+        return idle;
+    }
+};
+
+TEST_F(MatrixIdle, EntersIdleAfterTimeout) {
+    TestDriver driver;
+    EXPECT_FALSE(idle_after(MATRIX_IDLE_TIMEOUT - 1));
+    EXPECT_FALSE(matrix_idle_is_active());
+    EXPECT_TRUE(idle_after(1));
+    EXPECT_TRUE(matrix_idle_is_active());
+}
+
+TEST_F(MatrixIdle, KeysDownRestartTheTimeout) {
+    TestDriver driver;
+    EXPECT_FALSE(idle_after(MATRIX_IDLE_TIMEOUT - 1));
+    EXPECT_FALSE(matrix_idle_enter(true));
+    EXPECT_FALSE(idle_after(MATRIX_IDLE_TIMEOUT - 1));
+    EXPECT_TRUE(idle_after(1));
+}
+
+TEST_F(MatrixIdle, LeavesIdleWhenAKeyGoesDown) {
+    TestDriver driver;
+    EXPECT_TRUE(idle_after(MATRIX_IDLE_TIMEOUT));
+    EXPECT_FALSE(matrix_idle_leave(false));
+    EXPECT_TRUE(matrix_idle_is_active());
+    EXPECT_TRUE(matrix_idle_leave(true));
+    EXPECT_FALSE(matrix_idle_is_active());
+    // the timeout starts over once back to full scans
+    EXPECT_FALSE(idle_after(MATRIX_IDLE_TIMEOUT - 1));
+    EXPECT_TRUE(idle_after(1));
+}
+
+TEST_F(MatrixIdle, DoesNotGoIdleWhileATapDanceIsPending) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    // longer than MATRIX_IDLE_TIMEOUT, shorter than TAPPING_TERM
+    EXPECT_FALSE(idle_after(TAPPING_TERM - 10));
+    EXPECT_FALSE(matrix_idle_allowed());
+
+    // the dance finishes once TAPPING_TERM runs out, then the timeout starts
+    while (!matrix_idle_allowed()) {
+        EXPECT_FALSE(idle_after(1));
+    }
+    // counted from the scan that finished it
+    EXPECT_FALSE(idle_after(MATRIX_IDLE_TIMEOUT - 2));
+    EXPECT_TRUE(idle_after(1));
+}
+
+TEST_F(MatrixIdle, LeavesIdleWhenTheUserHookDisallowsIt) {
+    TestDriver driver;
+    EXPECT_TRUE(idle_after(MATRIX_IDLE_TIMEOUT));
+    block_idle = true;
+    EXPECT_FALSE(matrix_idle_allowed());
+    EXPECT_TRUE(matrix_idle_leave(false));
+    EXPECT_FALSE(idle_after(MATRIX_IDLE_TIMEOUT * 2));
+}
@@ -0,0 +1,91 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "quantum.h"
+#include "test_rgb_driver.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J},
+            {KC_K, KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T},
+            {KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z, KC_1, KC_2, KC_3, KC_4},
+            {KC_LCTL, KC_LSFT, KC_LALT, KC_SPC, KC_SPC, KC_SPC, KC_SPC, KC_RALT, KC_RSFT, KC_RCTL},
+        },
+};
+
+// One LED per key, laid out on the usual 224x64 grid, with the bottom row as modifiers
+#define P(row, col) \
+    { (col)*224 / (MATRIX_COLS - 1), (row)*64 / (MATRIX_ROWS - 1) }
+#define ROW_POINTS(row) P(row, 0), P(row, 1), P(row, 2), P(row, 3), P(row, 4), P(row, 5), P(row, 6), P(row, 7), P(row, 8), P(row, 9)
+#define KEY LED_FLAG_KEYLIGHT
+#define MOD LED_FLAG_MODIFIER
+
+led_config_t g_led_config = {{
+                                 {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                                 {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+                                 {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+                                 {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+                             },
+                             {ROW_POINTS(0), ROW_POINTS(1), ROW_POINTS(2), ROW_POINTS(3)},
+                             {
+                                 KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY,  //
+                                 KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY,  //
+                                 KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY, KEY,  //
+                                 MOD, MOD, MOD, KEY, KEY, KEY, KEY, MOD, MOD, MOD,  //
+                             }};
+
+uint8_t  test_rgb_leds[DRIVER_LED_TOTAL][3];
+uint32_t test_rgb_frames_hash;
+uint32_t test_rgb_frames;
+
+void test_rgb_reset_frames(void) {
+    test_rgb_frames_hash = 2166136261u;
+    test_rgb_frames      = 0;
+}
+
+static void init(void) {}
+
+// FNV-1a over every flushed frame
+static void flush(void) {
+    const uint8_t *data = &test_rgb_leds[0][0];
+    for (uint16_t i = 0; i < sizeof(test_rgb_leds); i++) {
+        test_rgb_frames_hash = (test_rgb_frames_hash ^ data[i]) * 16777619u;
+    }
+    test_rgb_frames++;
+}
+
+static void set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index >= 0 && index < DRIVER_LED_TOTAL) {
+        test_rgb_leds[index][0] = red;
+        test_rgb_leds[index][1] = green;
+        test_rgb_leds[index][2] = blue;
+    }
+}
+
+static void set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        set_color(i, red, green, blue);
+    }
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = init,
+    .flush         = flush,
+    .set_color     = set_color,
+    .set_color_all = set_color_all,
+};
@@ -0,0 +1,75 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "color.h"
+#include "lib/lib8tion/lib8tion.h"
+}
+
+static uint32_t pack(uint8_t a, uint8_t b, uint8_t c, uint8_t d) { return a | (b << 8) | (c << 16) | ((uint32_t)d << 24); }
+
+static uint8_t lane(uint32_t packed, uint8_t i) { return packed >> (i * 8); }
+
+TEST(Lib8tionBatch, Scale8x4MatchesScale8) {
+    for (uint16_t i = 0; i < 256; i++) {
+        for (uint16_t scale = 0; scale < 256; scale++) {
+            uint32_t in  = pack(i, 255 - i, i ^ 0x5A, scale);
+            uint32_t out = scale8x4(in, scale);
+            for (uint8_t k = 0; k < 4; k++) {
+                ASSERT_EQ(lane(out, k), scale8(lane(in, k), scale)) << "lane " << (int)k << " of 0x" << std::hex << in << " by 0x" << scale;
+            }
+        }
+    }
+}
+
+TEST(Lib8tionBatch, Qadd8x4MatchesQadd8) {
+    for (uint16_t i = 0; i < 256; i++) {
+        for (uint16_t j = 0; j < 256; j++) {
+            uint32_t a   = pack(i, j, 255 - i, i ^ j);
+            uint32_t b   = pack(j, i, 255 - j, i);
+            uint32_t out = qadd8x4(a, b);
+            for (uint8_t k = 0; k < 4; k++) {
+                ASSERT_EQ(lane(out, k), qadd8(lane(a, k), lane(b, k))) << "lane " << (int)k << " of 0x" << std::hex << a << " + 0x" << b;
+            }
+        }
+    }
+}
+
+TEST(Lib8tionBatch, HsvToRgbArrayMatchesHsvToRgb) {
+    HSV hsv[256];
+    RGB rgb[256];
+    for (uint16_t s = 0; s < 256; s += 3) {
+        for (uint16_t v = 0; v < 256; v += 5) {
+            for (uint16_t h = 0; h < 256; h++) {
+                hsv[h] = {(uint8_t)h, (uint8_t)s, (uint8_t)v};
+            }
+            // Break up some of the batches so the mixed saturation and value path runs too
+            hsv[9].s ^= 1;
+            hsv[130].v ^= 1;
+            // An odd count leaves a tail that is converted one color at a time
+            hsv_to_rgb_array(hsv, rgb, 255);
+            for (uint8_t i = 0; i < 255; i++) {
+                RGB expected = hsv_to_rgb(hsv[i]);
+                ASSERT_EQ(rgb[i].r, expected.r) << "hsv " << (int)hsv[i].h << "," << (int)hsv[i].s << "," << (int)hsv[i].v;
+                ASSERT_EQ(rgb[i].g, expected.g) << "hsv " << (int)hsv[i].h << "," << (int)hsv[i].s << "," << (int)hsv[i].v;
+                ASSERT_EQ(rgb[i].b, expected.b) << "hsv " << (int)hsv[i].h << "," << (int)hsv[i].s << "," << (int)hsv[i].v;
+            }
+        }
+    }
+}
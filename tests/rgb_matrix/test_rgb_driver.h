@@ -0,0 +1,29 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+// Colors written by rgb_matrix to the fake driver
+extern uint8_t test_rgb_leds[DRIVER_LED_TOTAL][3];
+
+// Hash of all the frames flushed since the last reset, and their count
+extern uint32_t test_rgb_frames_hash;
+extern uint32_t test_rgb_frames;
+
+void test_rgb_reset_frames(void);
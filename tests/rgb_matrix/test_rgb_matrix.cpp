@@ -0,0 +1,178 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+
+extern "C" {
+#include "rgb_matrix.h"
+#include "test_rgb_driver.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+// The random effects would otherwise render whatever the C library's rand() returns, so the
+// test build replaces it with a generator of its own (xorshift32, the top 31 bits). Where
+// RAND_MAX is 2^31 - 1, as with glibc, musl and macOS, the golden frames match everywhere.
+static uint32_t test_rand_state = 1;
+
+int rand(void) {
+    test_rand_state ^= test_rand_state << 13;
+    test_rand_state ^= test_rand_state >> 17;
+    test_rand_state ^= test_rand_state << 5;
+    return (test_rand_state >> 1) % ((uint32_t)RAND_MAX + 1);
+}
+
+void srand(unsigned int seed) { test_rand_state = seed ? seed : 1; }
+}
+
+struct Effect {
+    uint8_t     mode;
+    const char* name;
+};
+
+static const Effect effects[] = {
+#define RGB_MATRIX_EFFECT(name, ...) {RGB_MATRIX_##name, #name},
+#include "rgb_matrix_animations/rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+};
+
+// Hash of the first 200 frames of each effect, as rendered by render() below.
+// When an effect is changed on purpose, update its hash with the one reported by the failure.
+static const std::map<std::string, uint32_t> golden_frames = {
+    {"SOLID_COLOR", 0x1cdf8285},
+    {"ALPHAS_MODS", 0x6e7f0885},
+    {"GRADIENT_UP_DOWN", 0x90e5b105},
+    {"GRADIENT_LEFT_RIGHT", 0x99604245},
+    {"BREATHING", 0x968d11bd},
+    {"BAND_SAT", 0xcc348735},
+    {"BAND_VAL", 0xa26b309d},
+    {"BAND_PINWHEEL_SAT", 0x1f5a4200},
+    {"BAND_PINWHEEL_VAL", 0xe096034f},
+    {"BAND_SPIRAL_SAT", 0x69bb8b74},
+    {"BAND_SPIRAL_VAL", 0x33edfcc9},
+    {"CYCLE_ALL", 0xb0ed9385},
+    {"CYCLE_LEFT_RIGHT", 0xf4d2ff3d},
+    {"CYCLE_UP_DOWN", 0x234a1f75},
+    {"RAINBOW_MOVING_CHEVRON", 0xb784c20d},
+    {"CYCLE_OUT_IN", 0x1ba29c51},
+    {"CYCLE_OUT_IN_DUAL", 0x63eb7327},
+    {"CYCLE_PINWHEEL", 0xa701c049},
+    {"CYCLE_SPIRAL", 0x4d53b249},
+    {"DUAL_BEACON", 0x5ad8f2b},
+    {"RAINBOW_BEACON", 0xbe171cf1},
+    {"RAINBOW_PINWHEELS", 0xa450fe7b},
+    {"RAINDROPS", 0xd5de0103},
+    {"JELLYBEAN_RAINDROPS", 0xa3cf2b23},
+    {"TYPING_HEATMAP", 0x1a41b9a5},
+    {"DIGITAL_RAIN", 0x4a080a7c},
+    {"SOLID_REACTIVE_SIMPLE", 0x63bef19d},
+    {"SOLID_REACTIVE", 0xe60cd835},
+    {"SOLID_REACTIVE_WIDE", 0x247b9475},
+    {"SOLID_REACTIVE_MULTIWIDE", 0x247b9475},
+    {"SOLID_REACTIVE_CROSS", 0xa3e765},
+    {"SOLID_REACTIVE_MULTICROSS", 0xa3e765},
+    {"SOLID_REACTIVE_NEXUS", 0x7461ca35},
+    {"SOLID_REACTIVE_MULTINEXUS", 0x7461ca35},
+    {"SPLASH", 0x8b37c50b},
+    {"MULTISPLASH", 0xa775fd6b},
+    {"SOLID_SPLASH", 0x9c84397c},
+    {"SOLID_MULTISPLASH", 0x8e39df85},
+};
+
+static const uint32_t golden_frame_count = 200;
+
+class RgbMatrix : public TestFixture {
+   protected:
+    // Renders frames of the effect from the same state every time, pressing a few keys along the way.
+    // Returns the time spent in rgb_matrix_task.
+    std::chrono::nanoseconds render(uint8_t mode, uint32_t frames) {
+        // Let the hits of the previous effect expire with no effect running, so the next one starts from init
+        // at the same time every render
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_NONE);
+        set_time(1000000 - 70000);
+        for (int i = 0; i < 70; i++) {
+            advance_time(1000);
+            rgb_matrix_task();
+        }
+
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_sethsv_noeeprom(16, 255, 255);
+        rgb_matrix_config.speed = 128;
+        rgb_matrix_mode(mode);
+        srand(1);
+        memset(test_rgb_leds, 0, sizeof(test_rgb_leds));
+        test_rgb_reset_frames();
+
+        std::chrono::nanoseconds spent(0);
+        while (test_rgb_frames < frames) {
+            if (test_rgb_frames % 50 == 10) {
+                press_key(test_rgb_frames % MATRIX_ROWS, test_rgb_frames % MATRIX_COLS);
+            }
+            auto start = std::chrono::steady_clock::now();
+            rgb_matrix_task();
+            spent += std::chrono::steady_clock::now() - start;
+            advance_time(1);
+        }
+        return spent;
+    }
+
+    uint32_t last_pressed_frame = UINT32_MAX;
+
+    void press_key(uint8_t row, uint8_t col) {
+        if (last_pressed_frame == test_rgb_frames) {
+            return;
+        }
+        last_pressed_frame = test_rgb_frames;
+        keyrecord_t record = {.event = {.key = {.col = col, .row = row}, .pressed = true, .time = (uint16_t)(timer_read() | 1)}};
+        process_rgb_matrix(KC_A, &record);
+    }
+};
+
+TEST_F(RgbMatrix, GoldenFrames) {
+    for (const Effect& effect : effects) {
+        SCOPED_TRACE(effect.name);
+        render(effect.mode, golden_frame_count);
+        auto golden = golden_frames.find(effect.name);
+        if (golden == golden_frames.end()) {
+            ADD_FAILURE() << "No golden frames for " << effect.name << ", rendered {\"" << effect.name << "\", 0x" << std::hex << test_rgb_frames_hash << std::dec << "},";
+            continue;
+        }
+        EXPECT_EQ(test_rgb_frames_hash, golden->second) << "0x" << std::hex << test_rgb_frames_hash;
+    }
+}
+
+TEST_F(RgbMatrix, RendersEveryEffectRepeatably) {
+    for (const Effect& effect : effects) {
+        SCOPED_TRACE(effect.name);
+        render(effect.mode, 20);
+        uint32_t first = test_rgb_frames_hash;
+        render(effect.mode, 20);
+        EXPECT_EQ(test_rgb_frames_hash, first);
+    }
+}
+
+TEST_F(RgbMatrix, Benchmark) {
+    const uint32_t frames = 1000;
+    for (const Effect& effect : effects) {
+        auto spent = render(effect.mode, frames);
+        std::cout << "[ BENCH    ] " << effect.name << ": " << spent.count() / frames << " ns/frame" << std::endl;
+    }
+}
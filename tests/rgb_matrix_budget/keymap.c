@@ -0,0 +1,55 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] =
+        {
+            {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J},
+            {KC_K, KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T},
+            {KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z, KC_1, KC_2, KC_3, KC_4},
+            {KC_LCTL, KC_LSFT, KC_LALT, KC_SPC, KC_SPC, KC_SPC, KC_SPC, KC_RALT, KC_RSFT, KC_RCTL},
+        },
+};
+
+#define P(row, col) \
+    { (col)*224 / (MATRIX_COLS - 1), (row)*64 / (MATRIX_ROWS - 1) }
+#define ROW_POINTS(row) P(row, 0), P(row, 1), P(row, 2), P(row, 3), P(row, 4), P(row, 5), P(row, 6), P(row, 7), P(row, 8), P(row, 9)
+#define K LED_FLAG_KEYLIGHT
+#define ROW_FLAGS K, K, K, K, K, K, K, K, K, K
+
+led_config_t g_led_config = {{
+                                 {0, 1, 2, 3, 4, 5, 6, 7, 8, 9},
+                                 {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+                                 {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+                                 {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+                             },
+                             {ROW_POINTS(0), ROW_POINTS(1), ROW_POINTS(2), ROW_POINTS(3)},
+                             {ROW_FLAGS, ROW_FLAGS, ROW_FLAGS, ROW_FLAGS}};
+
+static void init(void) {}
+static void flush(void) {}
+static void set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {}
+static void set_color_all(uint8_t red, uint8_t green, uint8_t blue) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = init,
+    .flush         = flush,
+    .set_color     = set_color,
+    .set_color_all = set_color_all,
+};
@@ -0,0 +1,114 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include "rgb_matrix.h"
+#include "test_budget.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+typedef std::pair<uint8_t, uint8_t>   Slice;
+typedef std::vector<std::vector<Slice>> Frames;
+
+uint32_t test_led_cost_us = 0;
+
+static std::vector<Slice> slices;
+
+void test_render_slice(uint8_t led_min, uint8_t led_max) { slices.push_back(Slice(led_min, led_max)); }
+
+class RgbMatrixBudget : public TestFixture {
+   protected:
+    // Runs the COSTLY effect for a couple of seconds, and returns the chunks of each frame it completed
+    Frames render(uint32_t led_cost_us) {
+        test_led_cost_us = led_cost_us;
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_CUSTOM_COSTLY);
+        set_time(1000);
+        slices.clear();
+        for (int i = 0; i < 2000; i++) {
+            rgb_matrix_task();
+            advance_time(1);
+        }
+
+        Frames frames;
+        for (const Slice& slice : slices) {
+            if (slice.first == 0) {
+                frames.push_back(std::vector<Slice>());
+            }
+            if (!frames.empty()) {
+                frames.back().push_back(slice);
+            }
+        }
+        // the last one may not be complete
+        if (!frames.empty()) {
+            frames.pop_back();
+        }
+        return frames;
+    }
+
+    // Cost of the effect per LED in us, as measured by rgb_matrix
+    double measured_cost() { return rgb_matrix_get_effect_cost(RGB_MATRIX_CUSTOM_COSTLY) / 16.0; }
+};
+
+TEST_F(RgbMatrixBudget, RendersEveryLedOncePerFrame) {
+    Frames frames = render(15);
+    ASSERT_GT(frames.size(), 10u);
+    for (const std::vector<Slice>& frame : frames) {
+        uint8_t next = 0;
+        for (const Slice& slice : frame) {
+            EXPECT_EQ(slice.first, next);
+            EXPECT_GT(slice.second, slice.first);
+            next = slice.second;
+        }
+        EXPECT_EQ(next, DRIVER_LED_TOTAL);
+    }
+}
+
+TEST_F(RgbMatrixBudget, FillsTheBudget) {
+    Frames frames = render(10);
+    ASSERT_GT(frames.size(), 10u);
+    EXPECT_NEAR(measured_cost(), 10, 0.25);
+    // 200us fit 20 LEDs
+    EXPECT_EQ(frames.back(), std::vector<Slice>({Slice(0, 20), Slice(20, 40)}));
+}
+
+TEST_F(RgbMatrixBudget, AccountsTheLastChunkByWhatItRendered) {
+    Frames frames = render(15);
+    ASSERT_GT(frames.size(), 10u);
+    // 200us fit 13 LEDs, which leaves a single one for the last chunk of each frame
+    EXPECT_EQ(frames.back(), std::vector<Slice>({Slice(0, 13), Slice(13, 26), Slice(26, 39), Slice(39, 40)}));
+    EXPECT_NEAR(measured_cost(), 15, 0.25);
+}
+
+TEST_F(RgbMatrixBudget, FollowsChangesInCost) {
+    render(10);
+    EXPECT_NEAR(measured_cost(), 10, 0.25);
+
+    Frames frames = render(40);
+    EXPECT_NEAR(measured_cost(), 40, 0.25);
+    ASSERT_FALSE(frames.empty());
+    EXPECT_EQ(frames.back().size(), 8u);
+    for (const Slice& slice : frames.back()) {
+        EXPECT_EQ(slice.second - slice.first, 5);
+    }
+}
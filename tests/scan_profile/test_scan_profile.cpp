@@ -0,0 +1,188 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+#include <cstring>
+#include <string>
+
+extern "C" {
+#include "scan_profile.h"
+
+extern uint16_t user_delay_us;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class ScanProfile : public TestFixture {
+   protected:
+    void SetUp() override {
+        user_delay_us = 0;
+        scan_profile_reset();
+    }
+
+    uint8_t process_stage(const char *name) {
+        for (uint8_t stage = SCAN_PROFILE_PROCESS; stage < scan_profile_stage_count(); stage++) {
+            const char *stage_name = scan_profile_stage_name(stage);
+            if (stage_name && strcmp(stage_name, name) == 0) {
+                return stage;
+            }
+        }
+        ADD_FAILURE() << name << " is not profiled";
+        return scan_profile_stage_count();
+    }
+};
+
+TEST_F(ScanProfile, EachStageSeesTheTimeSpentInIt) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    user_delay_us = 300;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+
+    const scan_profile_stats_t *action_exec = scan_profile_get(SCAN_PROFILE_ACTION_EXEC);
+    EXPECT_EQ(action_exec->count, 1);
+    EXPECT_EQ(action_exec->min, 300);
+    EXPECT_EQ(action_exec->max, 300);
+
+    const scan_profile_stats_t *record_kb = scan_profile_get(process_stage("process_record_kb"));
+    EXPECT_EQ(record_kb->count, 1);
+    EXPECT_EQ(record_kb->max, 300);
+
+    const scan_profile_stats_t *space_cadet = scan_profile_get(process_stage("process_space_cadet"));
+    EXPECT_EQ(space_cadet->count, 1);
+    EXPECT_EQ(space_cadet->max, 0);
+
+    // process_grave_esc is never handed KC_A
+    EXPECT_EQ(scan_profile_get(process_stage("process_grave_esc"))->count, 0);
+
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_MATRIX_SCAN)->count, 1);
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_HOST_KEYBOARD_SEND)->count, 1);
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_SCAN_LOOP)->max, 300);
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_KEY_TO_REPORT)->max, 300);
+
+    // Ticks are not key events
+    idle_for(10);
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_ACTION_EXEC)->count, 1);
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_SCAN_LOOP)->count, 11);
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_SCAN_LOOP)->min, 0);
+
+    release_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_KEY_TO_REPORT)->count, 2);
+}
+
+TEST_F(ScanProfile, KeyLockAndEveryDispatchEntryAreProfiled) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_KEY_LOCK)->count, 1);
+    EXPECT_EQ(std::string(scan_profile_stage_name(SCAN_PROFILE_KEY_LOCK)), "process_key_lock");
+
+    // One stage per entry of the table, however many there are
+    for (uint8_t stage = SCAN_PROFILE_PROCESS; stage < scan_profile_stage_count(); stage++) {
+        EXPECT_NE(scan_profile_stage_name(stage), nullptr);
+        EXPECT_NE(scan_profile_get(stage), nullptr);
+    }
+    EXPECT_EQ(scan_profile_stage_name(scan_profile_stage_count()), nullptr);
+
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(ScanProfile, KeyWithoutReportDoesNotCountTowardsTheNextOne) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    // KC_NO never produces a report
+    press_key(3, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_KEY_TO_REPORT)->count, 0);
+
+    idle_for(SCAN_PROFILE_LATENCY_LIMIT + 1);
+    press_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_KEY_TO_REPORT)->count, 1);
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_KEY_TO_REPORT)->max, 0);
+
+    release_key(1, 0);
+    release_key(3, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(ScanProfile, KeepsMinAverageMaxAndHistogram) {
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 10);
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 20);
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 100);
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 5000);
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 100000);
+
+    const scan_profile_stats_t *s = scan_profile_get(SCAN_PROFILE_DEBOUNCE);
+    EXPECT_EQ(s->count, 5);
+    EXPECT_EQ(s->min, 10);
+    EXPECT_EQ(s->max, UINT16_MAX);
+    EXPECT_EQ(scan_profile_average(s), (10 + 20 + 100 + 5000 + UINT16_MAX) / 5);
+    const uint16_t buckets[SCAN_PROFILE_BUCKETS] = {1, 1, 0, 1, 0, 0, 0, 2};
+    EXPECT_EQ(memcmp(s->buckets, buckets, sizeof(buckets)), 0);
+
+    scan_profile_record(scan_profile_stage_count(), 10);
+    EXPECT_EQ(scan_profile_get(scan_profile_stage_count()), nullptr);
+}
+
+TEST_F(ScanProfile, CountHalvesInsteadOfWrapping) {
+    for (uint32_t i = 0; i < UINT16_MAX; i++) {
+        scan_profile_record(SCAN_PROFILE_DEBOUNCE, i & 1 ? 30 : 10);
+    }
+    scan_profile_record(SCAN_PROFILE_DEBOUNCE, 20);
+
+    const scan_profile_stats_t *s = scan_profile_get(SCAN_PROFILE_DEBOUNCE);
+    EXPECT_EQ(s->count, UINT16_MAX / 2 + 1);
+    EXPECT_EQ(scan_profile_average(s), 20);
+    EXPECT_EQ(s->buckets[0] + s->buckets[1], s->count);
+}
+
+TEST_F(ScanProfile, ReadableOverRawHid) {
+    scan_profile_record(SCAN_PROFILE_MATRIX_SCAN, 40);
+    scan_profile_record(SCAN_PROFILE_MATRIX_SCAN, 60);
+
+    uint8_t data[32] = {SCAN_PROFILE_RAW_HID_ID, scan_profile_raw_hid_get, SCAN_PROFILE_MATRIX_SCAN};
+    ASSERT_TRUE(scan_profile_raw_hid_receive(data, sizeof(data)));
+    const uint8_t expected[] = {SCAN_PROFILE_RAW_HID_ID, scan_profile_raw_hid_get, SCAN_PROFILE_MATRIX_SCAN, scan_profile_stage_count(), 0, 40, 0, 50, 0, 60, 0, 2, 0, 0, 0, 0, 0, 2};
+    EXPECT_EQ(memcmp(data, expected, sizeof(expected)), 0);
+
+    uint8_t name[32] = {SCAN_PROFILE_RAW_HID_ID, scan_profile_raw_hid_name, SCAN_PROFILE_MATRIX_SCAN};
+    ASSERT_TRUE(scan_profile_raw_hid_receive(name, sizeof(name)));
+    EXPECT_EQ(std::string((char *)&name[4]), "matrix_scan");
+
+    // Reports too short for the name get as much of it as fits, and nothing past their end
+    const uint8_t expected_short[3][4] = {{0xAA, 0xAA, 0xAA, 0xAA}, {0, 0xAA, 0xAA, 0xAA}, {'m', 0, 0xAA, 0xAA}};
+    for (uint8_t length = 4; length <= 6; length++) {
+        uint8_t short_name[8] = {SCAN_PROFILE_RAW_HID_ID, scan_profile_raw_hid_name, SCAN_PROFILE_MATRIX_SCAN, 0, 0xAA, 0xAA, 0xAA, 0xAA};
+        ASSERT_TRUE(scan_profile_raw_hid_receive(short_name, length));
+        EXPECT_EQ(memcmp(&short_name[4], expected_short[length - 4], 4), 0) << "length " << (int)length;
+    }
+
+    uint8_t reset[32] = {SCAN_PROFILE_RAW_HID_ID, scan_profile_raw_hid_reset};
+    ASSERT_TRUE(scan_profile_raw_hid_receive(reset, sizeof(reset)));
+    EXPECT_EQ(scan_profile_get(SCAN_PROFILE_MATRIX_SCAN)->count, 0);
+
+    uint8_t other[32] = {0x01};
+    EXPECT_FALSE(scan_profile_raw_hid_receive(other, sizeof(other)));
+}
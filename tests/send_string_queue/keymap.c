@@ -0,0 +1,78 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "quantum.h"
+
+enum custom_keycodes {
+    TYPE_AB = SAFE_RANGE,
+    TYPE_DELAYED,
+    TYPE_HELD,
+    TYPE_RAM,
+    TYPE_LONG,
+};
+
+enum unicode_names {
+    LOWER_A,
+    UPPER_B,
+};
+
+const uint32_t PROGMEM unicode_map[] = {
+    [LOWER_A] = 0x0061,
+    [UPPER_B] = 0x0042,
+};
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {TYPE_AB, TYPE_DELAYED, TYPE_HELD, TYPE_RAM, TYPE_LONG, KC_X,  XP(LOWER_A, UPPER_B), KC_LSFT, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,        KC_NO,     KC_NO,    KC_NO,     KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,        KC_NO,     KC_NO,    KC_NO,     KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO,        KC_NO,     KC_NO,    KC_NO,     KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+// clang-format on
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return true;
+    }
+    switch (keycode) {
+        case TYPE_AB:
+            SEND_STRING("ab");
+            return false;
+        case TYPE_DELAYED:
+            SEND_STRING("a" SS_DELAY(20) "b");
+            return false;
+        case TYPE_HELD:
+            SEND_STRING(SS_DOWN(X_LSFT) "c");
+            return false;
+        case TYPE_RAM: {
+            // Longer than the queue, and gone once this returns
+            char alphabet[27];
+            for (uint8_t i = 0; i < 26; i++) {
+                alphabet[i] = 'a' + i;
+            }
+            alphabet[26] = 0;
+            send_string(alphabet);
+            return false;
+        }
+        case TYPE_LONG:
+            SEND_STRING("abcdefghijklmnopqrstuvwxyzabcdefghijklmn");
+            return false;
+    }
+    return true;
+}
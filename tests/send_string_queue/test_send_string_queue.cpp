@@ -0,0 +1,157 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+using testing::Mock;
+
+class SendStringQueue : public TestFixture {};
+
+TEST_F(SendStringQueue, TypesOneReportPerScan) {
+    TestDriver driver;
+    // The macro key itself does not send anything, the string is typed by the following scans
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    press_key(0, 0);
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_FALSE(send_string_queue_busy());
+    release_key(0, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(SendStringQueue, KeysAreScannedWhileADelayRuns) {
+    TestDriver driver;
+    InSequence s;
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(5);
+
+    // The delay is still running, a key pressed now goes straight through
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    press_key(5, 0);
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(5, 0);
+    run_one_scan_loop();
+    Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_TRUE(send_string_queue_busy());
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(25);
+    EXPECT_FALSE(send_string_queue_busy());
+}
+
+TEST_F(SendStringQueue, CancelReleasesHeldKeys) {
+    TestDriver driver;
+    InSequence s;
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_C)));
+    idle_for(3);
+    release_key(2, 0);
+    EXPECT_TRUE(send_string_queue_busy());
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    send_string_queue_cancel();
+    EXPECT_FALSE(send_string_queue_busy());
+    idle_for(10);
+}
+
+TEST_F(SendStringQueue, StringsInRamWaitForRoomInTheQueue) {
+    TestDriver driver;
+    InSequence s;
+    for (uint8_t i = 0; i < 26; i++) {
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A + i)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    press_key(3, 0);
+    uint16_t start = timer_read();
+    keyboard_task();
+    // Whatever did not fit was played back before send_string() returned
+    EXPECT_GE(timer_elapsed(start), 26 * 2 - SEND_STRING_QUEUE_SIZE);
+    EXPECT_EQ(send_string_queue_free(), 0);
+    release_key(3, 0);
+    idle_for(2 * SEND_STRING_QUEUE_SIZE);
+    EXPECT_FALSE(send_string_queue_busy());
+}
+
+TEST_F(SendStringQueue, StringsInFlashDoNotBlock) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(80);
+    press_key(4, 0);
+    uint16_t start = timer_read();
+    keyboard_task();
+    EXPECT_EQ(timer_read(), start);
+    EXPECT_TRUE(send_string_queue_busy());
+    release_key(4, 0);
+    idle_for(100);
+    EXPECT_FALSE(send_string_queue_busy());
+}
+
+TEST_F(SendStringQueue, UnicodePairSeesShiftWhileQueued) {
+    TestDriver           driver;
+    std::vector<uint8_t> typed;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&](report_keyboard_t &report) {
+        for (uint8_t key : report.keys) {
+            if (key >= KC_1 && key <= KC_0) {
+                typed.push_back(key);
+            }
+        }
+    }));
+    press_key(7, 0);
+    run_one_scan_loop();
+    // The second press comes while the queue has shift released to type the first one
+    press_key(6, 0);
+    run_one_scan_loop();
+    release_key(6, 0);
+    idle_for(5);
+    press_key(6, 0);
+    run_one_scan_loop();
+    release_key(6, 0);
+    idle_for(100);
+    EXPECT_FALSE(send_string_queue_busy());
+    release_key(7, 0);
+    run_one_scan_loop();
+
+    std::vector<uint8_t> upper_b = {KC_0, KC_0, KC_4, KC_2};
+    std::vector<uint8_t> expected;
+    expected.insert(expected.end(), upper_b.begin(), upper_b.end());
+    expected.insert(expected.end(), upper_b.begin(), upper_b.end());
+    EXPECT_EQ(typed, expected);
+}
@@ -0,0 +1,68 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+CUSTOM_MATRIX = yes
+COMBO_ENABLE = yes
+OPT_DEFS += -DSIMULATOR_TRACES=\"tests/simulator/traces\"
+
+# `make test:simulator SIM_KEYBOARD=<keyboard> SIM_KEYMAP=<keymap>` replays
+# traces against a keymap from keyboards/ instead of the one in this folder.
+# Only the keymap and its rules.mk sources are built: the keyboard's own code
+# and the features below drive hardware that doesn't exist on the host.
+ifneq ($(strip $(SIM_KEYBOARD)),)
+    SIM_KEYMAP ?= default
+    SIM_EMPTY :=
+    SIM_SPACE := $(SIM_EMPTY) $(SIM_EMPTY)
+    SIM_KEYBOARD_WORDS := $(subst /, ,$(SIM_KEYBOARD))
+    SIM_KEYBOARD_PATHS := $(foreach n,1 2 3 4 5,$(if $(word $(n),$(SIM_KEYBOARD_WORDS)),keyboards/$(subst $(SIM_SPACE),/,$(wordlist 1,$(n),$(SIM_KEYBOARD_WORDS)))))
+    SIM_KEYMAP_PATH := $(lastword $(wildcard $(addsuffix /keymaps/$(SIM_KEYMAP),$(SIM_KEYBOARD_PATHS))))
+    ifeq ($(SIM_KEYMAP_PATH),)
+        $(error Could not find keymap $(SIM_KEYMAP) for $(SIM_KEYBOARD))
+    endif
+
+    $(foreach path,$(SIM_KEYBOARD_PATHS),$(eval -include $(path)/rules.mk))
+    SRC =
+    COMBO_ENABLE = no
+    -include $(SIM_KEYMAP_PATH)/rules.mk
+
+    CUSTOM_MATRIX = yes
+    SPLIT_KEYBOARD = no
+    BACKLIGHT_ENABLE = no
+    RGBLIGHT_ENABLE = no
+    RGB_MATRIX_ENABLE = no
+    LED_MATRIX_ENABLE = no
+    AUDIO_ENABLE = no
+    MIDI_ENABLE = no
+    HAPTIC_ENABLE = no
+    OLED_DRIVER_ENABLE = no
+    ENCODER_ENABLE = no
+    DIP_SWITCH_ENABLE = no
+    RAW_ENABLE = no
+    VIA_ENABLE = no
+    BLUETOOTH_ENABLE = no
+    POINTING_DEVICE_ENABLE = no
+    PS2_MOUSE_ENABLE = no
+    NKRO_ENABLE = no
+    CONSOLE_ENABLE = no
+
+    TEST_KEYMAP_C := $(SIM_KEYMAP_PATH)/keymap.c
+    TEST_CONFIG_H := $(wildcard $(addsuffix /config.h,$(SIM_KEYBOARD_PATHS)) $(SIM_KEYMAP_PATH)/config.h)
+    VPATH += $(SIM_KEYBOARD_PATHS) $(SIM_KEYMAP_PATH)
+    OPT_DEFS := $(filter-out -DSIMULATOR_TRACES=%,$(OPT_DEFS))
+    OPT_DEFS += -DSIMULATOR_TRACES=\"$(SIM_KEYMAP_PATH)/traces\"
+    OPT_DEFS += -DNO_PRINT
+    OPT_DEFS += -DQMK_KEYBOARD_H=\"$(lastword $(SIM_KEYBOARD_WORDS)).h\" -DQMK_KEYMAP_CONFIG_H=\"$(SIM_KEYMAP_PATH)/config.h\"
+endif
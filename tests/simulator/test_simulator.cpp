@@ -0,0 +1,272 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "action_tapping.h"
+#include "timer.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+// Replays typing traces through keyboard_task and compares the reports that
+// come out of it against a recorded baseline.
+//
+// A trace is a `<name>.trace` file with one matrix event per line:
+//     <time in ms> <row> <col> <down|up>
+// Lines starting with # are comments. The reports it produced when it was
+// recorded live next to it in `<name>.trace.reports`, one per line:
+//     <time in ms> <mods> <keys...>
+// with mods and keys in hex.
+//
+// SIM_TRACES=<directory or file> replays other traces than the built in ones,
+// SIM_RECORD=yes overwrites the baselines with the current output.
+
+namespace {
+
+const uint32_t SIMULATOR_TAIL = TAPPING_TERM * 2;
+
+struct SimulatorEvent {
+    uint32_t time;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed;
+};
+
+struct SimulatorReport {
+    uint32_t    time;
+    std::string text;
+};
+
+bool ends_with(const std::string &str, const std::string &suffix) { return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0; }
+
+std::vector<std::string> find_traces() {
+    const char *       env  = std::getenv("SIM_TRACES");
+    std::string        path = env && *env ? env : SIMULATOR_TRACES;
+    std::vector<std::string> traces;
+    if (ends_with(path, ".trace")) {
+        traces.push_back(path);
+        return traces;
+    }
+    DIR *dir = opendir(path.c_str());
+    if (!dir) {
+        return traces;
+    }
+    while (struct dirent *entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (ends_with(name, ".trace")) {
+            traces.push_back(path + "/" + name);
+        }
+    }
+    closedir(dir);
+    std::sort(traces.begin(), traces.end());
+    return traces;
+}
+
+bool load_trace(const std::string &path, std::vector<SimulatorEvent> &events) {
+    std::ifstream file(path);
+    std::string   line;
+    unsigned      line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        std::istringstream fields(line);
+        std::string        first;
+        if (!(fields >> first) || first[0] == '#') {
+            continue;
+        }
+        unsigned    row, col;
+        std::string state;
+        if (!(fields >> row >> col >> state) || (state != "down" && state != "up")) {
+            ADD_FAILURE() << path << ":" << line_number << ": expected <time> <row> <col> <down|up>";
+            return false;
+        }
+        if (row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+            ADD_FAILURE() << path << ":" << line_number << ": (" << row << ", " << col << ") is outside the " << MATRIX_ROWS << "x" << MATRIX_COLS << " matrix";
+            return false;
+        }
+        SimulatorEvent event = {(uint32_t)std::stoul(first), (uint8_t)row, (uint8_t)col, state == "down"};
+        if (!events.empty() && event.time < events.back().time) {
+            ADD_FAILURE() << path << ":" << line_number << ": events have to be in time order";
+            return false;
+        }
+        events.push_back(event);
+    }
+    return true;
+}
+
+std::string format_report(const report_keyboard_t &report) {
+    char        buffer[8];
+    std::string text;
+    snprintf(buffer, sizeof(buffer), "%02X", report.mods);
+    text += buffer;
+    for (unsigned i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report.keys[i]) {
+            snprintf(buffer, sizeof(buffer), " %02X", report.keys[i]);
+            text += buffer;
+        }
+    }
+    return text;
+}
+
+std::vector<std::string> load_lines(const std::string &path) {
+    std::vector<std::string> lines;
+    std::ifstream            file(path);
+    std::string              line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+// A line based diff of the longest common subsequence, - for lines only in
+// the baseline and + for lines only in the new output
+std::string diff_lines(const std::vector<std::string> &expected, const std::vector<std::string> &actual) {
+    size_t                           n = expected.size(), m = actual.size();
+    std::vector<std::vector<size_t>> lcs(n + 1, std::vector<size_t>(m + 1, 0));
+    for (size_t i = n; i-- > 0;) {
+        for (size_t j = m; j-- > 0;) {
+            lcs[i][j] = expected[i] == actual[j] ? lcs[i + 1][j + 1] + 1 : std::max(lcs[i + 1][j], lcs[i][j + 1]);
+        }
+    }
+    std::string diff;
+    size_t      i = 0, j = 0;
+    while (i < n || j < m) {
+        if (i < n && j < m && expected[i] == actual[j]) {
+            i++, j++;
+        } else if (j == m || (i < n && lcs[i + 1][j] >= lcs[i][j + 1])) {
+            diff += "-" + expected[i++] + "\n";
+        } else {
+            diff += "+" + actual[j++] + "\n";
+        }
+    }
+    return diff;
+}
+
+}  // namespace
+
+class Simulator : public TestFixture {
+   protected:
+    std::vector<SimulatorReport> replay(const std::vector<SimulatorEvent> &events, const std::string &name) {
+        TestDriver                   driver;
+        std::vector<SimulatorReport> reports;
+        uint32_t                     start    = timer_read32();
+        bool                         settling = false;
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&](report_keyboard_t &report) {
+            if (!settling) {
+                reports.push_back({timer_read32() - start, format_report(report)});
+            }
+        }));
+
+        uint32_t end   = (events.empty() ? 0 : events.back().time) + SIMULATOR_TAIL;
+        size_t   next  = 0;
+        auto     begin = std::chrono::steady_clock::now();
+        for (uint32_t now = 0; now < end; now++) {
+            for (; next < events.size() && events[next].time == now; next++) {
+                if (events[next].pressed) {
+                    press_key(events[next].col, events[next].row);
+                } else {
+                    release_key(events[next].col, events[next].row);
+                }
+            }
+            run_one_scan_loop();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+
+        // Release whatever the trace left held down before the next one starts
+        settling = true;
+        clear_all_keys();
+        idle_for(SIMULATOR_TAIL);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        // The latency of an event is the time until the next report, which is
+        // how long tap-hold and combos buffer it before the host sees anything
+        uint32_t latency_min = UINT32_MAX, latency_max = 0, latency_sum = 0, answered = 0;
+        size_t   report      = 0;
+        for (const SimulatorEvent &event : events) {
+            while (report < reports.size() && reports[report].time < event.time) {
+                report++;
+            }
+            if (report == reports.size()) {
+                break;
+            }
+            uint32_t latency = reports[report].time - event.time;
+            latency_min      = std::min(latency_min, latency);
+            latency_max      = std::max(latency_max, latency);
+            latency_sum += latency;
+            answered++;
+        }
+
+        printf("[ BENCH    ] %s: %zu events, %zu reports, %.0f events/s, %lld ns/scan\n", name.c_str(), events.size(), reports.size(), events.size() * 1e9 / std::max<long long>(elapsed, 1), (long long)(elapsed / std::max<uint32_t>(end, 1)));
+        if (answered) {
+            printf("[ BENCH    ] %s: event to report latency min %u ms, avg %.1f ms, max %u ms\n", name.c_str(), latency_min, (double)latency_sum / answered, latency_max);
+        }
+        return reports;
+    }
+};
+
+TEST_F(Simulator, TracesMatchTheirBaselines) {
+    std::vector<std::string> traces = find_traces();
+    ASSERT_FALSE(traces.empty()) << "No traces found";
+    const char *record = std::getenv("SIM_RECORD");
+
+    for (const std::string &trace : traces) {
+        SCOPED_TRACE(trace);
+        std::vector<SimulatorEvent> events;
+        if (!load_trace(trace, events)) {
+            continue;
+        }
+
+        std::string                  name    = trace.substr(trace.find_last_of('/') + 1);
+        std::vector<SimulatorReport> reports = replay(events, name);
+        std::vector<std::string>     actual;
+        for (const SimulatorReport &report : reports) {
+            actual.push_back(std::to_string(report.time) + " " + report.text);
+        }
+
+        std::string baseline = trace + ".reports";
+        if (record && std::string(record) == "yes") {
+            std::ofstream file(baseline);
+            for (const std::string &line : actual) {
+                file << line << "\n";
+            }
+            printf("[ RECORD   ] %s\n", baseline.c_str());
+        } else {
+            std::ifstream file(baseline);
+            if (!file) {
+                ADD_FAILURE() << "No baseline, record one with SIM_RECORD=yes";
+                continue;
+            }
+            std::vector<std::string> expected = load_lines(baseline);
+            EXPECT_TRUE(expected == actual) << "Reports differ from " << baseline << ":\n" << diff_lines(expected, actual);
+        }
+    }
+}
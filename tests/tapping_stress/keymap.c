@@ -0,0 +1,48 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "quantum.h"
+
+// The first two rows are 20 mod-taps on KC_A to KC_T, the third plain keys
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {LCTL_T(KC_A), LSFT_T(KC_B), LALT_T(KC_C), LGUI_T(KC_D), LCTL_T(KC_E), LSFT_T(KC_F), LALT_T(KC_G), LGUI_T(KC_H), LCTL_T(KC_I), LSFT_T(KC_J)},
+        {LALT_T(KC_K), LGUI_T(KC_L), LCTL_T(KC_M), LSFT_T(KC_N), LALT_T(KC_O), LGUI_T(KC_P), LCTL_T(KC_Q), LSFT_T(KC_R), LALT_T(KC_S), LGUI_T(KC_T)},
+        {KC_1,         KC_2,         KC_3,         KC_4,         KC_5,         KC_6,         KC_7,         KC_8,         KC_9,         KC_0},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO,        KC_NO},
+    },
+};
+// clang-format on
+
+uint32_t tapping_term_lookups = 0;
+uint16_t tapping_term         = TAPPING_TERM;
+uint16_t taps                 = 0;
+uint16_t tapped[64];
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    if (record->event.pressed && record->tap.count > 0) {
+        tapped[taps++ % 64] = keycode & 0xFF;
+    }
+    return true;
+}
+
+uint16_t get_tapping_term(uint16_t keycode) {
+    tapping_term_lookups++;
+    return tapping_term;
+}
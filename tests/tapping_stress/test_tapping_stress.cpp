@@ -0,0 +1,143 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+extern uint32_t tapping_term_lookups;
+extern uint16_t tapping_term;
+extern uint16_t taps;
+extern uint16_t tapped[64];
+}
+
+using testing::_;
+using testing::Invoke;
+
+// 20 mod-taps pressed 5 ms apart, so that all of them are down at once
+static const uint8_t  MOD_TAP_COUNT = 20;
+static const uint16_t KEY_INTERVAL  = 5;
+
+class TappingStress : public TestFixture {
+   protected:
+    TestDriver                     driver;
+    std::vector<report_keyboard_t> reports;
+
+    void SetUp() override {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([this](report_keyboard_t &report) { reports.push_back(report); }));
+        tapping_term_lookups = 0;
+        tapping_term         = TAPPING_TERM;
+        taps                 = 0;
+    }
+
+    void press_mod_taps() {
+        for (uint8_t i = 0; i < MOD_TAP_COUNT; i++) {
+            press_key(i % MATRIX_COLS, i / MATRIX_COLS);
+            idle_for(KEY_INTERVAL);
+        }
+    }
+
+    void release_mod_taps() {
+        for (uint8_t i = 0; i < MOD_TAP_COUNT; i++) {
+            release_key(i % MATRIX_COLS, i / MATRIX_COLS);
+            idle_for(KEY_INTERVAL);
+        }
+    }
+
+    static bool has_key(const report_keyboard_t &report, uint8_t key) {
+        for (uint8_t k : report.keys) {
+            if (k == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint8_t mods_seen() {
+        uint8_t mods = 0;
+        for (const report_keyboard_t &report : reports) {
+            mods |= report.mods;
+        }
+        return mods;
+    }
+};
+
+TEST_F(TappingStress, OverlappingModTapsReleasedWithinTheTermAllTap) {
+    press_mod_taps();
+    release_mod_taps();
+    idle_for(TAPPING_TERM);
+
+    // More keys are down at once than a 6KRO report has room for, so check
+    // what tapped in process_record_user
+    std::vector<uint16_t> expected;
+    for (uint8_t i = 0; i < MOD_TAP_COUNT; i++) {
+        expected.push_back(KC_A + i);
+    }
+    EXPECT_EQ(std::vector<uint16_t>(tapped, tapped + taps), expected);
+    EXPECT_EQ(mods_seen(), 0);
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ(reports.back().mods, 0);
+    EXPECT_FALSE(has_key(reports.back(), KC_T));
+}
+
+TEST_F(TappingStress, OverlappingModTapsHeldPastTheTermAllHold) {
+    press_mod_taps();
+    idle_for(TAPPING_TERM);
+    press_key(0, 2);
+    run_one_scan_loop();
+
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ(reports.back().mods, MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT) | MOD_BIT(KC_LALT) | MOD_BIT(KC_LGUI));
+    EXPECT_TRUE(has_key(reports.back(), KC_1));
+    EXPECT_EQ(taps, 0);
+
+    release_key(0, 2);
+    release_mod_taps();
+    EXPECT_EQ(reports.back().mods, 0);
+    EXPECT_FALSE(has_key(reports.back(), KC_1));
+}
+
+TEST_F(TappingStress, TappingTermChangedWhileAKeyIsHeldApplies) {
+    press_key(0, 0);
+    idle_for(TAPPING_TERM / 2);
+    // get_tapping_term() may depend on state that changes at any time
+    tapping_term = TAPPING_TERM / 4;
+    run_one_scan_loop();
+    release_key(0, 0);
+    idle_for(TAPPING_TERM);
+
+    EXPECT_EQ(taps, 0);
+    EXPECT_EQ(mods_seen(), MOD_BIT(KC_LCTL));
+}
+
+TEST_F(TappingStress, Benchmark) {
+    const int rounds = 100;
+    auto      start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        press_mod_taps();
+        release_mod_taps();
+        idle_for(TAPPING_TERM);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Every round types all of the keys
+    EXPECT_EQ(taps, rounds * MOD_TAP_COUNT);
+    int scans = rounds * (2 * MOD_TAP_COUNT * KEY_INTERVAL + TAPPING_TERM);
+    std::cout << "[ BENCH    ] " << (int)MOD_TAP_COUNT << " overlapping mod-taps: " << std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / scans << " ns/scan, " << tapping_term_lookups / rounds << " tapping term lookups/round" << std::endl;
+}
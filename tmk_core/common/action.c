@@ -345,6 +345,7 @@ void process_action(keyrecord_t *record, action_t action) {
                         if (tap_count > 0) {
                             dprint("MODS_TAP: Tap: unregister_code\n");
                             if (action.layer_tap.code == KC_CAPS) {
+                                flush_keyboard_report();
                                 wait_ms(TAP_HOLD_CAPS_DELAY);
                             }
                             unregister_code(action.key.code);
@@ -547,6 +548,7 @@ void process_action(keyrecord_t *record, action_t action) {
                     } else {
                         if (tap_count > 0) {
                             dprint("KEYMAP_TAP_KEY: Tap: unregister_code\n");
+                            flush_keyboard_report();
                             if (action.layer_tap.code == KC_CAPS) {
                                 wait_ms(TAP_HOLD_CAPS_DELAY);
                             } else {
@@ -619,6 +621,7 @@ void process_action(keyrecord_t *record, action_t action) {
                         if (event.pressed) {
                             register_code(action.swap.code);
                         } else {
+                            flush_keyboard_report();
                             wait_ms(TAP_CODE_DELAY);
                             unregister_code(action.swap.code);
                             *record = (keyrecord_t){};  // hack: reset tap mode
@@ -860,6 +863,8 @@ void unregister_code(uint8_t code) {
  */
 void tap_code(uint8_t code) {
     register_code(code);
+    // the host has to see the press for the whole delay
+    flush_keyboard_report();
     if (code == KC_CAPS) {
         wait_ms(TAP_HOLD_CAPS_DELAY);
     } else {
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "action.h"
 #include "util.h"
@@ -246,16 +247,34 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
-/** \brief Layer switch get layer
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+#    define LAYER_LOOKUP_CACHE_EMPTY 0xFF
+
+/** \brief layer lookup cache
  *
- * Gets the layer based on key info
+ * The topmost non-transparent layer of each key, valid for the layer state in layer_lookup_cache_state.
+ * Entries are resolved lazily on the first lookup after the cache has been flushed.
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
+static uint8_t       layer_lookup_cache[MATRIX_ROWS][MATRIX_COLS];
+static layer_state_t layer_lookup_cache_state;
+static bool          layer_lookup_cache_stale = true;
+
+/** \brief invalidate layer lookup cache
+ *
+ * Call when the keymap contents change, so every key gets resolved again on its next lookup
+ */
+void layer_lookup_cache_invalidate(void) { layer_lookup_cache_stale = true; }
+#endif
+
 #ifndef NO_ACTION_LAYER
+/** \brief Layer switch find layer
+ *
+ * Walks the active layers from the top to find the first one where the key isn't transparent
+ */
+static uint8_t layer_switch_find_layer(layer_state_t layers, keypos_t key) {
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = sizeof(layer_state_t) * 8 - 1; i >= 0; i--) {
         if (layers & (1UL << i)) {
@@ -267,6 +286,32 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     }
     /* fall back to layer 0 */
     return 0;
+}
+#endif
+
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+#ifndef NO_ACTION_LAYER
+    layer_state_t layers = layer_state | default_layer_state;
+#    ifdef LAYER_LOOKUP_CACHE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        // layer_state may also be written directly, so compare rather than rely on the setters
+        if (layer_lookup_cache_stale || layers != layer_lookup_cache_state) {
+            memset(layer_lookup_cache, LAYER_LOOKUP_CACHE_EMPTY, sizeof(layer_lookup_cache));
+            layer_lookup_cache_state = layers;
+            layer_lookup_cache_stale = false;
+        }
+        uint8_t *cached = &layer_lookup_cache[key.row][key.col];
+        if (*cached == LAYER_LOOKUP_CACHE_EMPTY) {
+            *cached = layer_switch_find_layer(layers, key);
+        }
+        return *cached;
+    }
+#    endif
+    return layer_switch_find_layer(layers, key);
 #else
     return get_highest_layer(default_layer_state);
 #endif
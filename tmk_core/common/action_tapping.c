@@ -4,6 +4,7 @@
 #include "action_layer.h"
 #include "action_tapping.h"
 #include "keycode.h"
+#include "matrix.h"
 #include "timer.h"
 
 #ifdef DEBUG_ACTION
@@ -19,6 +20,13 @@
 #    define IS_TAPPING_RELEASED() (IS_TAPPING() && !tapping_key.event.pressed)
 #    define IS_TAPPING_KEY(k) (IS_TAPPING() && KEYEQ(tapping_key.event.key, (k)))
 
+#    if (WAITING_BUFFER_SIZE & (WAITING_BUFFER_SIZE - 1)) != 0 || WAITING_BUFFER_SIZE > 128
+#        error "WAITING_BUFFER_SIZE has to be a power of two, no larger than 128"
+#    endif
+#    define WAITING_BUFFER_MASK (WAITING_BUFFER_SIZE - 1)
+#    define WAITING_BUFFER_AT(i) waiting_buffer[(uint8_t)(i)&WAITING_BUFFER_MASK]
+#    define IS_MATRIX_KEY(k) ((k).row < MATRIX_ROWS && (k).col < MATRIX_COLS)
+
 __attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode) { return TAPPING_TERM; }
 
 #    ifdef TAPPING_TERM_PER_KEY
@@ -37,12 +45,20 @@ __attribute__((weak)) bool get_permissive_hold(uint16_t keycode, keyrecord_t *re
 
 static keyrecord_t tapping_key                         = {};
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
-static uint8_t     waiting_buffer_head                 = 0;
-static uint8_t     waiting_buffer_tail                 = 0;
+/* head and tail run freely, WAITING_BUFFER_AT() wraps them into the buffer */
+static uint8_t waiting_buffer_head = 0;
+static uint8_t waiting_buffer_tail = 0;
+/* what is in the buffer, so that lookups don't have to scan it */
+static uint8_t      waiting_buffer_pressed  = 0;
+static uint8_t      waiting_buffer_unmapped = 0;
+static matrix_row_t waiting_buffer_presses[MATRIX_ROWS];
+static matrix_row_t waiting_buffer_releases[MATRIX_ROWS];
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_deq(void);
 static void waiting_buffer_clear(void);
+static bool waiting_buffer_contains(keypos_t key, bool pressed);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
 static void waiting_buffer_scan_tap(void);
@@ -74,13 +90,14 @@ void action_tapping_process(keyrecord_t record) {
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+    while (waiting_buffer_tail != waiting_buffer_head) {
+        if (process_tapping(&WAITING_BUFFER_AT(waiting_buffer_tail))) {
             debug("processed: waiting_buffer[");
-            debug_dec(waiting_buffer_tail);
+            debug_dec(waiting_buffer_tail & WAITING_BUFFER_MASK);
             debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]);
+            debug_record(WAITING_BUFFER_AT(waiting_buffer_tail));
             debug("\n\n");
+            waiting_buffer_deq();
         } else {
             break;
         }
@@ -312,59 +329,114 @@ bool process_tapping(keyrecord_t *keyp) {
 
 /** \brief Waiting buffer enq
  *
- * FIXME: Needs docs
+ * Adds a key event to the head of the buffer. Returns false when the buffer is full.
  */
 bool waiting_buffer_enq(keyrecord_t record) {
     if (IS_NOEVENT(record.event)) {
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if ((uint8_t)(waiting_buffer_head - waiting_buffer_tail) == WAITING_BUFFER_SIZE) {
         debug("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
-    waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    WAITING_BUFFER_AT(waiting_buffer_head) = record;
+    waiting_buffer_head++;
+
+    keypos_t key = record.event.key;
+    if (record.event.pressed) {
+        waiting_buffer_pressed++;
+    }
+    if (IS_MATRIX_KEY(key)) {
+        if (record.event.pressed) {
+            waiting_buffer_presses[key.row] |= MATRIX_ROW_SHIFTER << key.col;
+        } else {
+            waiting_buffer_releases[key.row] |= MATRIX_ROW_SHIFTER << key.col;
+        }
+    } else {
+        waiting_buffer_unmapped++;
+    }
 
     debug("waiting_buffer_enq: ");
     debug_waiting_buffer();
     return true;
 }
 
+/** \brief Waiting buffer deq
+ *
+ * Drops the key event at the tail of the buffer, once it has been processed.
+ */
+void waiting_buffer_deq(void) {
+    keyevent_t event = WAITING_BUFFER_AT(waiting_buffer_tail).event;
+    waiting_buffer_tail++;
+
+    if (waiting_buffer_tail == waiting_buffer_head) {
+        waiting_buffer_clear();
+        return;
+    }
+    if (event.pressed) {
+        waiting_buffer_pressed--;
+    }
+    if (!IS_MATRIX_KEY(event.key)) {
+        waiting_buffer_unmapped--;
+    } else if (!waiting_buffer_contains(event.key, event.pressed)) {
+        // the bit stays set while another event of the key is still waiting
+        if (event.pressed) {
+            waiting_buffer_presses[event.key.row] &= ~(MATRIX_ROW_SHIFTER << event.key.col);
+        } else {
+            waiting_buffer_releases[event.key.row] &= ~(MATRIX_ROW_SHIFTER << event.key.col);
+        }
+    }
+}
+
 /** \brief Waiting buffer clear
  *
- * FIXME: Needs docs
+ * Empties the buffer.
  */
 void waiting_buffer_clear(void) {
-    waiting_buffer_head = 0;
-    waiting_buffer_tail = 0;
+    waiting_buffer_head     = 0;
+    waiting_buffer_tail     = 0;
+    waiting_buffer_pressed  = 0;
+    waiting_buffer_unmapped = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        waiting_buffer_presses[row]  = 0;
+        waiting_buffer_releases[row] = 0;
+    }
 }
 
-/** \brief Waiting buffer typed
+/** \brief Waiting buffer contains
  *
- * FIXME: Needs docs
+ * Searches the buffer for a press or release of a key.
  */
-bool waiting_buffer_typed(keyevent_t event) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) {
+bool waiting_buffer_contains(keypos_t key, bool pressed) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i++) {
+        if (KEYEQ(key, WAITING_BUFFER_AT(i).event.key) && pressed == WAITING_BUFFER_AT(i).event.pressed) {
             return true;
         }
     }
     return false;
 }
 
-/** \brief Waiting buffer has anykey pressed
+/** \brief Waiting buffer typed
  *
- * FIXME: Needs docs
+ * Whether the buffer holds the opposite of this event for the same key, i.e.
+ * the key was typed while the tapping key was waiting.
  */
-__attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (waiting_buffer[i].event.pressed) return true;
+bool waiting_buffer_typed(keyevent_t event) {
+    if (IS_MATRIX_KEY(event.key)) {
+        matrix_row_t row = event.pressed ? waiting_buffer_releases[event.key.row] : waiting_buffer_presses[event.key.row];
+        return row & (MATRIX_ROW_SHIFTER << event.key.col);
     }
-    return false;
+    return waiting_buffer_unmapped && waiting_buffer_contains(event.key, !event.pressed);
 }
 
+/** \brief Waiting buffer has anykey pressed
+ *
+ * Whether any of the events in the buffer is a key press.
+ */
+__attribute__((unused)) bool waiting_buffer_has_anykey_pressed(void) { return waiting_buffer_pressed; }
+
 /** \brief Scan buffer for tapping
  *
  * FIXME: Needs docs
@@ -374,15 +446,17 @@ void waiting_buffer_scan_tap(void) {
     if (tapping_key.tap.count > 0) return;
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
+    // no release of the tapping key is waiting
+    if (!waiting_buffer_typed(tapping_key.event)) return;
 
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
-        if (IS_TAPPING_KEY(waiting_buffer[i].event.key) && !waiting_buffer[i].event.pressed && WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
-            tapping_key.tap.count       = 1;
-            waiting_buffer[i].tap.count = 1;
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i++) {
+        if (IS_TAPPING_KEY(WAITING_BUFFER_AT(i).event.key) && !WAITING_BUFFER_AT(i).event.pressed && WITHIN_TAPPING_TERM(WAITING_BUFFER_AT(i).event)) {
+            tapping_key.tap.count          = 1;
+            WAITING_BUFFER_AT(i).tap.count = 1;
             process_record(&tapping_key);
 
             debug("waiting_buffer_scan_tap: found at [");
-            debug_dec(i);
+            debug_dec(i & WAITING_BUFFER_MASK);
             debug("]\n");
             debug_waiting_buffer();
             return;
@@ -406,11 +480,11 @@ static void debug_tapping_key(void) {
  */
 static void debug_waiting_buffer(void) {
     debug("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i++) {
         debug("[");
-        debug_dec(i);
+        debug_dec(i & WAITING_BUFFER_MASK);
         debug("]=");
-        debug_record(waiting_buffer[i]);
+        debug_record(WAITING_BUFFER_AT(i));
         debug(" ");
     }
     debug("}\n");
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_layer.h"
 #include "timer.h"
 #include "keycode_config.h"
+#include <string.h>
 
 extern keymap_config_t keymap_config;
 
@@ -42,9 +43,62 @@ static int8_t cb_count = 0;
 // report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
 
-extern inline void add_key(uint8_t key);
-extern inline void del_key(uint8_t key);
-extern inline void clear_keys(void);
+/* The report the host was sent last, to leave out reports that change nothing */
+static report_keyboard_t last_report                = {};
+static bool              last_report_valid          = false;
+static bool              keyboard_report_dirty      = false;
+static uint8_t           keyboard_report_mods       = 0;
+static uint8_t           keyboard_report_generation = 0;
+#ifdef NKRO_ENABLE
+static bool last_report_nkro = false;
+#endif
+
+/** \brief Keyboard report init
+ *
+ * Forgets what the host was sent, so that the next report goes out whatever it contains.
+ */
+void keyboard_report_init(void) { last_report_valid = false; }
+
+/** \brief Add key
+ *
+ * Adds a key to the keyboard report, without sending it.
+ */
+void add_key(uint8_t key) {
+    if (is_key_pressed(keyboard_report, key)) return;
+#ifdef QMK_BATCH_REPORTS
+    // the host has to see the release before the key goes down again
+    if (is_key_pressed(&last_report, key)) flush_keyboard_report();
+#endif
+    add_key_to_report(keyboard_report, key);
+    keyboard_report_dirty = true;
+}
+
+/** \brief Del key
+ *
+ * Removes a key from the keyboard report, without sending it.
+ */
+void del_key(uint8_t key) {
+    if (!is_key_pressed(keyboard_report, key)) return;
+#ifdef QMK_BATCH_REPORTS
+    // the host has to see the press before the key goes up again
+    if (!is_key_pressed(&last_report, key)) flush_keyboard_report();
+#endif
+    del_key_from_report(keyboard_report, key);
+    keyboard_report_dirty = true;
+}
+
+/** \brief Clear keys
+ *
+ * Removes all keys from the keyboard report, without sending it.
+ */
+void clear_keys(void) {
+    if (!has_anykey(keyboard_report)) return;
+#ifdef QMK_BATCH_REPORTS
+    flush_keyboard_report();
+#endif
+    clear_keys_from_report(keyboard_report);
+    keyboard_report_dirty = true;
+}
 
 #ifndef NO_ACTION_ONESHOT
 static uint8_t oneshot_mods        = 0;
@@ -132,12 +186,12 @@ bool is_oneshot_layer_active(void) { return get_oneshot_layer_state(); }
 
 /** \brief Send keyboard report
  *
- * FIXME: needs doc
+ * Sends the keys and mods to the host, unless that wouldn't change anything.
+ * With QMK_BATCH_REPORTS the report is only sent by flush_keyboard_report(),
+ * which keyboard_task() calls once per scan.
  */
 void send_keyboard_report(void) {
-    keyboard_report->mods = real_mods;
-    keyboard_report->mods |= weak_mods;
-    keyboard_report->mods |= macro_mods;
+    uint8_t mods = real_mods | weak_mods | macro_mods;
 #ifndef NO_ACTION_ONESHOT
     if (oneshot_mods) {
 #    if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
@@ -146,16 +200,59 @@ void send_keyboard_report(void) {
             clear_oneshot_mods();
         }
 #    endif
-        keyboard_report->mods |= oneshot_mods;
+        mods |= oneshot_mods;
         if (has_anykey(keyboard_report)) {
             clear_oneshot_mods();
         }
     }
 
 #endif
+    if (mods != keyboard_report_mods) {
+#ifdef QMK_BATCH_REPORTS
+        // the host has to see a modifier change before it is undone
+        if ((last_report.mods ^ keyboard_report_mods) & (keyboard_report_mods ^ mods)) flush_keyboard_report();
+#endif
+        keyboard_report_mods  = mods;
+        keyboard_report_dirty = true;
+    }
+    // keymaps and IS_COMMAND() read the mods straight from the report, keep them current while the report waits
+    keyboard_report->mods = mods;
+#ifndef QMK_BATCH_REPORTS
+    flush_keyboard_report();
+#endif
+}
+
+/** \brief Flush keyboard report
+ *
+ * Sends the keyboard report if it has changed since the host was last sent one.
+ */
+void flush_keyboard_report(void) {
+#ifdef NKRO_ENABLE
+    // the first report after switching between 6KRO and NKRO always goes out
+    bool nkro = keyboard_protocol && keymap_config.nkro;
+    if (nkro != last_report_nkro) {
+        last_report_nkro  = nkro;
+        last_report_valid = false;
+    }
+#endif
+    if (!keyboard_report_dirty && last_report_valid) return;
+    keyboard_report_dirty = false;
+
+    // host_keyboard_send() moves the mods around for NKRO, put them back before comparing
+    keyboard_report->mods = keyboard_report_mods;
+    if (last_report_valid && memcmp(keyboard_report, &last_report, sizeof(report_keyboard_t)) == 0) return;
+    last_report       = *keyboard_report;
+    last_report_valid = true;
+    keyboard_report_generation++;
     host_keyboard_send(keyboard_report);
 }
 
+/** \brief Get keyboard report generation
+ *
+ * Counts the keyboard reports sent to the host, so that a change can be noticed without comparing reports.
+ */
+uint8_t get_keyboard_report_generation(void) { return keyboard_report_generation; }
+
 /** \brief Get mods
  *
  * FIXME: needs doc
@@ -26,14 +26,15 @@ extern "C" {
 
 extern report_keyboard_t *keyboard_report;
 
-void send_keyboard_report(void);
+void    keyboard_report_init(void);
+void    send_keyboard_report(void);
+void    flush_keyboard_report(void);
+uint8_t get_keyboard_report_generation(void);
 
 /* key */
-inline void add_key(uint8_t key) { add_key_to_report(keyboard_report, key); }
-
-inline void del_key(uint8_t key) { del_key_from_report(keyboard_report, key); }
-
-inline void clear_keys(void) { clear_keys_from_report(keyboard_report); }
+void add_key(uint8_t key);
+void del_key(uint8_t key);
+void clear_keys(void);
 
 /* modifier */
 uint8_t get_mods(void);
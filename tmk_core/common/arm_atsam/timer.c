@@ -16,4 +16,25 @@ uint16_t timer_elapsed(uint16_t tlast) { return TIMER_DIFF_16(timer_read(), tlas
 
 uint32_t timer_elapsed32(uint32_t tlast) { return TIMER_DIFF_32(timer_read32(), tlast); }
 
+// TC4 counts microseconds up to the match that advances ms_clk every millisecond
+uint32_t timer_read_us32(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t ms               = (uint32_t)ms_clk;
+    TC4->COUNT16.CTRLBSET.reg = TC_CTRLBSET_CMD_READSYNC;
+    while (TC4->COUNT16.SYNCBUSY.bit.CTRLB) {
+    }
+    uint16_t count = TC4->COUNT16.COUNT.reg;
+    if (TC4->COUNT16.INTFLAG.bit.MC0 && count < 500) {
+        // the count started over before the interrupt could advance ms_clk
+        ms++;
+    }
+
+    __set_PRIMASK(primask);
+    return ms * 1000 + count;
+}
+
+uint32_t timer_elapsed_us32(uint32_t tlast) { return TIMER_DIFF_32(timer_read_us32(), tlast); }
+
 void timer_clear(void) { set_time(0); }
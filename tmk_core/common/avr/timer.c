@@ -124,6 +124,36 @@ inline uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(t, last);
 }
 
+#if defined(__AVR_ATmega32A__) || defined(__AVR_ATtiny85__)
+#    define TIMER_INTERRUPT_FLAGS TIFR
+#else
+#    define TIMER_INTERRUPT_FLAGS TIFR0
+#endif
+#ifndef __AVR_ATmega32A__
+#    define TIMER_INTERRUPT_FLAG OCF0A
+#else
+#    define TIMER_INTERRUPT_FLAG OCF0
+#endif
+
+// Adds the position of Timer0 within the current millisecond to the counter
+uint32_t timer_read_us32(void) {
+    uint32_t t;
+    uint8_t  raw;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        t   = timer_count;
+        raw = TIMER_RAW;
+        // the compare match happened, but the interrupt hasn't run yet
+        if ((TIMER_INTERRUPT_FLAGS & _BV(TIMER_INTERRUPT_FLAG)) && raw < TIMER_RAW_TOP) {
+            t++;
+        }
+    }
+
+    return t * 1000 + (uint16_t)raw * 1000 / (TIMER_RAW_TOP + 1);
+}
+
+uint32_t timer_elapsed_us32(uint32_t last) { return TIMER_DIFF_32(timer_read_us32(), last); }
+
 // excecuted once per 1ms.(excess for just timer count?)
 #ifndef __AVR_ATmega32A__
 #    define TIMER_INTERRUPT_VECTOR TIMER0_COMPA_vect
@@ -1,12 +1,27 @@
-#include "ch.h"
+#include "hal.h"
 
 #include "timer.h"
 
+// The core cycle counter gives timer_read_us32 a microsecond resolution where the port has one
+#if PORT_SUPPORTS_RT == TRUE
+#    if defined(STM32_HCLK)
+#        define TIMER_CYCLES_PER_US (STM32_HCLK / 1000000)
+#    elif defined(KINETIS_SYSCLK_FREQUENCY)
+#        define TIMER_CYCLES_PER_US (KINETIS_SYSCLK_FREQUENCY / 1000000)
+#    endif
+#endif
+
 static uint32_t reset_point = 0;
 #if CH_CFG_ST_RESOLUTION < 32
 static uint32_t last_systime = 0;
 static uint32_t overflow     = 0;
 #endif
+#ifdef TIMER_CYCLES_PER_US
+static uint32_t us_count      = 0;
+static uint32_t us_last_ticks = 0;
+static uint32_t us_last_cycle = 0;
+static uint32_t us_cycle_rem  = 0;
+#endif
 
 void timer_init(void) { timer_clear(); }
 
@@ -16,11 +31,17 @@ void timer_clear(void) {
     last_systime = reset_point;
     overflow     = 0;
 #endif
+#ifdef TIMER_CYCLES_PER_US
+    us_count      = 0;
+    us_last_ticks = 0;
+    us_last_cycle = (uint32_t)port_rt_get_counter_value();
+    us_cycle_rem  = 0;
+#endif
 }
 
 uint16_t timer_read(void) { return (uint16_t)timer_read32(); }
 
-uint32_t timer_read32(void) {
+static uint32_t timer_read_ticks(void) {
     uint32_t systime = (uint32_t)chVTGetSystemTime();
 
 #if CH_CFG_ST_RESOLUTION < 32
@@ -36,12 +57,44 @@ uint32_t timer_read32(void) {
     }
 
     last_systime = systime;
-    return (uint32_t)TIME_I2MS(systime - reset_point + overflow);
+    return systime - reset_point + overflow;
 #else
-    return (uint32_t)TIME_I2MS(systime - reset_point);
+    return systime - reset_point;
 #endif
 }
 
+uint32_t timer_read32(void) { return (uint32_t)TIME_I2MS(timer_read_ticks()); }
+
+#ifdef TIMER_CYCLES_PER_US
+uint32_t timer_read_us32(void) {
+    syssts_t sts = chSysGetStatusAndLockX();
+
+    // The cycle counter wraps every 2^32 cycles (under a minute at 72MHz), so its progress is added up on every read
+    uint32_t ticks  = timer_read_ticks();
+    uint32_t cycles = (uint32_t)port_rt_get_counter_value();
+    uint32_t idle   = (uint32_t)TIME_I2US(ticks - us_last_ticks);
+    if (idle < (UINT32_MAX / TIMER_CYCLES_PER_US) / 2) {
+        uint32_t elapsed  = cycles - us_last_cycle + us_cycle_rem;
+        us_count         += elapsed / TIMER_CYCLES_PER_US;
+        us_cycle_rem      = elapsed % TIMER_CYCLES_PER_US;
+    } else {
+        // not read for long enough that the cycle counter may have wrapped, go by the system tick instead
+        us_count    += idle;
+        us_cycle_rem = 0;
+    }
+    us_last_ticks = ticks;
+    us_last_cycle = cycles;
+    uint32_t us   = us_count;
+
+    chSysRestoreStatusX(sts);
+    return us;
+}
+#else
+uint32_t timer_read_us32(void) { return (uint32_t)TIME_I2US(timer_read_ticks()); }
+#endif
+
 uint16_t timer_elapsed(uint16_t last) { return TIMER_DIFF_16(timer_read(), last); }
 
 uint32_t timer_elapsed32(uint32_t last) { return TIMER_DIFF_32(timer_read32(), last); }
+
+uint32_t timer_elapsed_us32(uint32_t last) { return TIMER_DIFF_32(timer_read_us32(), last); }
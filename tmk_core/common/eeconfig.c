@@ -13,6 +13,10 @@
 #    include "eeprom_driver.h"
 #endif
 
+#ifdef DYNAMIC_KEYMAP_ENABLE
+#    include "dynamic_keymap.h"
+#endif
+
 /** \brief eeconfig enable
  *
  * FIXME: needs doc
@@ -54,6 +58,10 @@ void eeconfig_init_quantum(void) {
     eeprom_update_byte(EECONFIG_VELOCIKEY, 0);
     eeprom_update_dword(EECONFIG_RGB_MATRIX, 0);
     eeprom_update_byte(EECONFIG_RGB_MATRIX_SPEED, 0);
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    // The EEPROM may have been erased underneath the keymap's RAM copy
+    dynamic_keymap_invalidate();
+#endif
 
     // TODO: Remove once ARM has a way to configure EECONFIG_HANDEDNESS
     //        within the emulated eeprom via dfu-util or another tool
@@ -92,6 +100,9 @@ void eeconfig_disable(void) {
     eeprom_driver_erase();
 #endif
     eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_invalidate();
+#endif
 }
 
 /** \brief eeconfig is enabled
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "scan_profile.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -62,7 +63,12 @@ void host_keyboard_send(report_keyboard_t *report) {
         report->report_id = REPORT_ID_KEYBOARD;
 #endif
     }
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_HOST_KEYBOARD_SEND);
     (*driver->send_keyboard)(report);
+    SCAN_PROFILE_END(SCAN_PROFILE_HOST_KEYBOARD_SEND);
+#ifdef SCAN_PROFILE_ENABLE
+    scan_profile_report_sent();
+#endif
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -30,6 +30,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "action_util.h"
+#include "scan_profile.h"
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -107,6 +109,14 @@ void matrix_scan_perf_task(void) {
 #    define matrix_scan_perf_task()
 #endif
 
+#ifdef QMK_BATCH_KEY_EVENTS
+#    ifndef QMK_BATCH_KEY_EVENTS_SIZE
+#        define QMK_BATCH_KEY_EVENTS_SIZE 16
+#    endif
+// Events collected from a single matrix scan, dispatched in matrix order once the scan has been drained
+static keyevent_t key_event_queue[QMK_BATCH_KEY_EVENTS_SIZE];
+#endif
+
 #ifdef MATRIX_HAS_GHOST
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
 static matrix_row_t   get_real_keys(uint8_t row, matrix_row_t rowdata) {
@@ -226,6 +236,7 @@ __attribute__((weak)) bool should_process_keypress(void) { return is_keyboard_ma
  */
 void keyboard_init(void) {
     timer_init();
+    keyboard_report_init();
     matrix_init();
 #ifdef VIA_ENABLE
     via_init();
@@ -270,6 +281,9 @@ void keyboard_init(void) {
     eeconfig_update_keymap(keymap_config.raw);
 #endif
     keyboard_post_init_kb(); /* Always keep this last */
+#ifdef QMK_BATCH_REPORTS
+    flush_keyboard_report();
+#endif
 }
 
 /** \brief Keyboard task: Do keyboard routine jobs
@@ -292,12 +306,24 @@ void keyboard_task(void) {
 #ifdef QMK_KEYS_PER_SCAN
     uint8_t keys_processed = 0;
 #endif
+#ifdef QMK_BATCH_KEY_EVENTS
+    uint8_t  key_event_count = 0;
+    uint16_t scan_time;
+#endif
 
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_SCAN_LOOP);
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_MATRIX_SCAN);
 #if defined(OLED_DRIVER_ENABLE) && !defined(OLED_DISABLE_TIMEOUT)
     uint8_t ret = matrix_scan();
 #else
     matrix_scan();
 #endif
+    SCAN_PROFILE_END(SCAN_PROFILE_MATRIX_SCAN);
+
+#ifdef QMK_BATCH_KEY_EVENTS
+    // all events from this scan share the time the matrix was read
+    scan_time = timer_read() | 1; /* time should not be 0 */
+#endif
 
     if (should_process_keypress()) {
         for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
@@ -313,37 +339,66 @@ void keyboard_task(void) {
                 matrix_row_t col_mask = 1;
                 for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
                     if (matrix_change & col_mask) {
+                        SCAN_PROFILE_KEY_EVENT(SCAN_PROFILE_MATRIX_SCAN);
+#ifdef QMK_BATCH_KEY_EVENTS
+                        key_event_queue[key_event_count++] = (keyevent_t){.key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = scan_time};
+                        // record a queued key
+                        matrix_prev[r] ^= col_mask;
+                        // remaining changes are picked up by the next scan
+                        if (key_event_count >= QMK_BATCH_KEY_EVENTS_SIZE) goto MATRIX_SCAN_END;
+#else
+                        SCAN_PROFILE_BEGIN(SCAN_PROFILE_ACTION_EXEC);
                         action_exec((keyevent_t){
                             .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
                         });
+                        SCAN_PROFILE_END(SCAN_PROFILE_ACTION_EXEC);
                         // record a processed key
                         matrix_prev[r] ^= col_mask;
-#ifdef QMK_KEYS_PER_SCAN
+#    ifdef QMK_KEYS_PER_SCAN
                         // only jump out if we have processed "enough" keys.
                         if (++keys_processed >= QMK_KEYS_PER_SCAN)
-#endif
+#    endif
                             // process a key per task call
                             goto MATRIX_LOOP_END;
+#endif
                     }
                 }
             }
         }
     }
+#ifdef QMK_BATCH_KEY_EVENTS
+MATRIX_SCAN_END:
+    for (uint8_t i = 0; i < key_event_count; i++) {
+        SCAN_PROFILE_BEGIN(SCAN_PROFILE_ACTION_EXEC);
+        action_exec(key_event_queue[i]);
+        SCAN_PROFILE_END(SCAN_PROFILE_ACTION_EXEC);
+    }
     // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
+    if (!key_event_count) action_exec(TICK);
+#else
+    // call with pseudo tick event when no real key event.
+#    ifdef QMK_KEYS_PER_SCAN
     // we can get here with some keys processed now.
     if (!keys_processed)
-#endif
+#    endif
         action_exec(TICK);
 
 MATRIX_LOOP_END:
+#endif
+
+#ifdef QMK_BATCH_REPORTS
+    // everything this scan changed goes out in one report
+    flush_keyboard_report();
+#endif
 
 #ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_scan_perf_task();
 #endif
 
 #if defined(RGBLIGHT_ENABLE)
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_RGBLIGHT);
     rgblight_task();
+    SCAN_PROFILE_END(SCAN_PROFILE_RGBLIGHT);
 #endif
 
 #if defined(BACKLIGHT_ENABLE)
@@ -357,7 +412,9 @@ MATRIX_LOOP_END:
 #endif
 
 #ifdef OLED_DRIVER_ENABLE
+    SCAN_PROFILE_BEGIN(SCAN_PROFILE_OLED);
     oled_task();
+    SCAN_PROFILE_END(SCAN_PROFILE_OLED);
 #    ifndef OLED_DISABLE_TIMEOUT
     // Wake up oled if user is using those fabulous keys!
     if (ret) oled_on();
@@ -408,6 +465,11 @@ MATRIX_LOOP_END:
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+
+#ifdef SCAN_PROFILE_ENABLE
+    SCAN_PROFILE_END(SCAN_PROFILE_SCAN_LOOP);
+    scan_profile_task();
+#endif
 }
 
 /** \brief keyboard set leds
@@ -16,7 +16,8 @@
 
 #include "eeprom.h"
 
-#define EEPROM_SIZE 32
+// Same as the ATmega32u4, the default dynamic keymap EEPROM size
+#define EEPROM_SIZE 1024
 
 static uint8_t buffer[EEPROM_SIZE];
 
@@ -44,6 +44,12 @@ uint32_t timer_read32(void);
 uint16_t timer_elapsed(uint16_t last);
 uint32_t timer_elapsed32(uint32_t last);
 
+// Microsecond counter for measuring short intervals, wraps around every ~71 minutes.
+// The resolution depends on the platform: 4us on AVR at 16MHz, 1us on arm_atsam and on ChibiOS cores with a cycle
+// counter (Cortex-M3/M4/M7), the system tick on the others (Cortex-M0).
+uint32_t timer_read_us32(void);
+uint32_t timer_elapsed_us32(uint32_t last);
+
 // Utility functions to check if a future time has expired & autmatically handle time wrapping if checked / reset frequently (half of max value)
 #define timer_expired(current, future) (((uint16_t)current - (uint16_t)future) < 0x8000)
 #define timer_expired32(current, future) (((uint32_t)current - (uint32_t)future) < 0x80000000)
@@ -68,6 +68,29 @@ static virtual_timer_t keyboard_idle_timer;
 static void            keyboard_idle_timer_cb(void *arg);
 
 report_keyboard_t keyboard_report_sent = {{0}};
+#ifdef KEYBOARD_REPORT_QUEUE_SIZE
+#    if KEYBOARD_REPORT_QUEUE_SIZE < 2 || KEYBOARD_REPORT_QUEUE_SIZE > 128 || (KEYBOARD_REPORT_QUEUE_SIZE & (KEYBOARD_REPORT_QUEUE_SIZE - 1)) != 0
+#        error "KEYBOARD_REPORT_QUEUE_SIZE must be a power of two between 2 and 128"
+#    endif
+#    define KEYBOARD_REPORT_QUEUE_AT(i) (keyboard_report_queue[(i) & (KEYBOARD_REPORT_QUEUE_SIZE - 1)])
+
+/* One report waiting for (or in the middle of) its IN transfer. The
+ * endpoint and length are fixed when the report is queued, so a protocol
+ * switch never reinterprets a report that is already on the way out. */
+typedef struct {
+    report_keyboard_t report;
+    usbep_t           ep;
+    uint8_t           size;
+    bool              boot;
+} keyboard_report_entry_t;
+
+static keyboard_report_entry_t     keyboard_report_queue[KEYBOARD_REPORT_QUEUE_SIZE];
+static uint8_t                     keyboard_report_queue_head      = 0;
+static uint8_t                     keyboard_report_queue_tail      = 0;
+static bool                        keyboard_report_queue_in_flight = false;
+static usb_keyboard_report_stats_t keyboard_report_stats           = {0};
+static void                        keyboard_report_queue_resetI(void);
+#endif /* KEYBOARD_REPORT_QUEUE_SIZE */
 #ifdef MOUSE_ENABLE
 report_mouse_t mouse_report_blank = {0};
 #endif /* MOUSE_ENABLE */
@@ -335,6 +358,12 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
                 qmkusbSuspendHookI(&drivers.array[i].driver);
                 chSysUnlockFromISR();
             }
+#ifdef KEYBOARD_REPORT_QUEUE_SIZE
+            /* Transfers in flight are aborted by the reset, drop what is left */
+            chSysLockFromISR();
+            keyboard_report_queue_resetI();
+            chSysUnlockFromISR();
+#endif
             return;
 
         case USB_EVENT_WAKEUP:
@@ -563,12 +592,167 @@ void init_usb_driver(USBDriver *usbp) {
  *                  Keyboard functions
  * ---------------------------------------------------------
  */
+#ifdef KEYBOARD_REPORT_QUEUE_SIZE
+/* Drop everything still queued, counting it as lost
+ * (called in locked state) */
+static void keyboard_report_queue_resetI(void) {
+    keyboard_report_stats.dropped += (uint8_t)(keyboard_report_queue_head - keyboard_report_queue_tail);
+    keyboard_report_queue_tail      = keyboard_report_queue_head;
+    keyboard_report_queue_in_flight = false;
+}
+
+/* Start the IN transfer for the oldest queued report if its endpoint is idle
+ * (called in locked state, from both thread and ISR context) */
+static void keyboard_report_queue_startI(USBDriver *usbp) {
+    if (keyboard_report_queue_in_flight || keyboard_report_queue_head == keyboard_report_queue_tail) {
+        return;
+    }
+
+    keyboard_report_entry_t *entry = &KEYBOARD_REPORT_QUEUE_AT(keyboard_report_queue_tail);
+    /* a previous idle or extrakey transfer may still own the endpoint,
+     * its IN callback will come back here once it is done */
+    if (usbGetTransmitStatusI(usbp, entry->ep)) {
+        return;
+    }
+
+    uint8_t *data = entry->boot ? &entry->report.mods : (uint8_t *)&entry->report;
+    usbStartTransmitI(usbp, entry->ep, data, entry->size);
+    keyboard_report_queue_in_flight = true;
+    keyboard_report_sent            = entry->report;
+}
+
+/* A transfer on ep has completed: retire the report it carried and
+ * start the next one (called from ISR, unlocked state) */
+static void keyboard_report_queue_in_cb(USBDriver *usbp, usbep_t ep) {
+    osalSysLockFromISR();
+    if (keyboard_report_queue_in_flight && KEYBOARD_REPORT_QUEUE_AT(keyboard_report_queue_tail).ep == ep) {
+        keyboard_report_queue_tail++;
+        keyboard_report_queue_in_flight = false;
+        keyboard_report_stats.sent++;
+    }
+    keyboard_report_queue_startI(usbp);
+    osalSysUnlockFromISR();
+}
+
+static bool keyboard_report_has_key(const report_keyboard_t *report, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Whether pending can be overwritten by newer without the host missing a
+ * change: every key and mod that changed between older and pending must
+ * keep its new state in newer. A key pressed and released again, or the
+ * other way round, would otherwise never reach the host. */
+static bool keyboard_report_can_merge(const keyboard_report_entry_t *older, const keyboard_report_entry_t *pending, const report_keyboard_t *newer, usbep_t ep, uint8_t size, bool boot) {
+    if (older->ep != ep || pending->ep != ep || older->size != size || pending->size != size || older->boot != boot || pending->boot != boot) {
+        return false;
+    }
+
+    const report_keyboard_t *a = &older->report;
+    const report_keyboard_t *b = &pending->report;
+#    ifdef NKRO_ENABLE
+    if (size == sizeof(struct nkro_report)) {
+        if ((a->nkro.mods ^ b->nkro.mods) & (b->nkro.mods ^ newer->nkro.mods)) {
+            return false;
+        }
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if ((a->nkro.bits[i] ^ b->nkro.bits[i]) & (b->nkro.bits[i] ^ newer->nkro.bits[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+#    endif
+    if ((a->mods ^ b->mods) & (b->mods ^ newer->mods)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        /* pressed in pending, must still be down */
+        if (b->keys[i] && !keyboard_report_has_key(a, b->keys[i]) && !keyboard_report_has_key(newer, b->keys[i])) {
+            return false;
+        }
+        /* released in pending, must still be up */
+        if (a->keys[i] && !keyboard_report_has_key(b, a->keys[i]) && keyboard_report_has_key(newer, a->keys[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Queue a report for transmission. When the queue is full the host has not
+ * been picking reports up. The newest pending report is overwritten if the
+ * host still sees all of its changes that way, otherwise this waits for the
+ * host to take a report off the queue. If it takes longer than 10 ms the
+ * newest pending report is overwritten anyway, so that at least the latest
+ * key state gets through.
+ * (called in locked state, may suspend the calling thread) */
+static void keyboard_report_queue_pushS(report_keyboard_t *report, usbep_t ep, uint8_t size, bool boot) {
+    uint8_t depth = keyboard_report_queue_head - keyboard_report_queue_tail;
+
+    while (depth == KEYBOARD_REPORT_QUEUE_SIZE) {
+        /* the slot at tail may be in flight, head - 2 and head - 1 are still on the queue with a depth of 2 or more */
+        if (keyboard_report_can_merge(&KEYBOARD_REPORT_QUEUE_AT(keyboard_report_queue_head - 2), &KEYBOARD_REPORT_QUEUE_AT(keyboard_report_queue_head - 1), report, ep, size, boot)) {
+            break;
+        }
+        keyboard_report_stats.waited++;
+        /* the IN callback retires the report before the waiting thread is resumed */
+        usbep_t busy = KEYBOARD_REPORT_QUEUE_AT(keyboard_report_queue_tail).ep;
+        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[busy]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
+            break;
+        }
+        if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+            keyboard_report_stats.dropped++;
+            return;
+        }
+        depth = keyboard_report_queue_head - keyboard_report_queue_tail;
+    }
+
+    keyboard_report_entry_t *entry;
+    if (depth == KEYBOARD_REPORT_QUEUE_SIZE) {
+        entry = &KEYBOARD_REPORT_QUEUE_AT(keyboard_report_queue_head - 1);
+        keyboard_report_stats.merged++;
+    } else {
+        entry = &KEYBOARD_REPORT_QUEUE_AT(keyboard_report_queue_head);
+        keyboard_report_queue_head++;
+        depth++;
+        keyboard_report_stats.queued++;
+        if (depth > keyboard_report_stats.max_depth) {
+            keyboard_report_stats.max_depth = depth;
+        }
+    }
+    entry->report = *report;
+    entry->ep     = ep;
+    entry->size   = size;
+    entry->boot   = boot;
+}
+
+void usb_get_keyboard_report_stats(usb_keyboard_report_stats_t *stats) {
+    osalSysLock();
+    *stats = keyboard_report_stats;
+    osalSysUnlock();
+}
+
+void usb_clear_keyboard_report_stats(void) {
+    osalSysLock();
+    keyboard_report_stats = (usb_keyboard_report_stats_t){0};
+    osalSysUnlock();
+}
+#endif /* KEYBOARD_REPORT_QUEUE_SIZE */
+
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
+#    ifdef KEYBOARD_REPORT_QUEUE_SIZE
+    keyboard_report_queue_in_cb(usbp, ep);
+#    else
     /* STUB */
     (void)usbp;
     (void)ep;
+#    endif
 }
 #endif
 
@@ -612,6 +796,34 @@ static void keyboard_idle_timer_cb(void *arg) {
 /* LED status */
 uint8_t keyboard_leds(void) { return keyboard_led_stats; }
 
+#ifdef KEYBOARD_REPORT_QUEUE_SIZE
+/* queue a report and return straight away, unless the queue is full, the
+ * endpoint IN callbacks drain the queue as fast as the host polls
+ * not callable from ISR or locked state */
+void send_keyboard(report_keyboard_t *report) {
+    osalSysLock();
+    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+        keyboard_report_stats.dropped++;
+        osalSysUnlock();
+        return;
+    }
+
+#    ifdef NKRO_ENABLE
+    if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
+        keyboard_report_queue_pushS(report, SHARED_IN_EPNUM, sizeof(struct nkro_report), false);
+    } else
+#    endif /* NKRO_ENABLE */
+    {
+        if (keyboard_protocol) {
+            keyboard_report_queue_pushS(report, KEYBOARD_IN_EPNUM, KEYBOARD_REPORT_SIZE, false);
+        } else { /* boot protocol */
+            keyboard_report_queue_pushS(report, KEYBOARD_IN_EPNUM, 8, true);
+        }
+    }
+    keyboard_report_queue_startI(&USB_DRIVER);
+    osalSysUnlock();
+}
+#else  /* KEYBOARD_REPORT_QUEUE_SIZE */
 /* prepare and start sending a report IN
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
@@ -672,6 +884,7 @@ void send_keyboard(report_keyboard_t *report) {
 unlock:
     osalSysUnlock();
 }
+#endif /* KEYBOARD_REPORT_QUEUE_SIZE */
 
 /* ---------------------------------------------------------
  *                     Mouse functions
@@ -720,9 +933,14 @@ void send_mouse(report_mouse_t *report) { (void)report; }
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
+#    ifdef KEYBOARD_REPORT_QUEUE_SIZE
+    /* keyboard reports go out here with NKRO or KEYBOARD_SHARED_EP */
+    keyboard_report_queue_in_cb(usbp, ep);
+#    else
     /* STUB */
     (void)usbp;
     (void)ep;
+#    endif
 }
 #endif
 
@@ -739,7 +957,18 @@ static void send_extra(uint8_t report_id, uint16_t data) {
         return;
     }
 
-    report_extra_t report = {.report_id = report_id, .usage = data};
+    /* the shared endpoint may still be busy with a keyboard report (NKRO or
+     * KEYBOARD_SHARED_EP) or the previous extra report, and the report buffer
+     * has to stay untouched until its transfer is done */
+    while (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
+        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT || usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+            osalSysUnlock();
+            return;
+        }
+    }
+
+    static report_extra_t report;
+    report = (report_extra_t){.report_id = report_id, .usage = data};
 
     usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
     osalSysUnlock();
@@ -48,6 +48,24 @@ void kbd_in_cb(USBDriver *usbp, usbep_t ep);
 /* start-of-frame handler */
 void kbd_sof_cb(USBDriver *usbp);
 
+#ifdef KEYBOARD_REPORT_QUEUE_SIZE
+/* keyboard report queue counters, see KEYBOARD_REPORT_QUEUE_SIZE */
+typedef struct {
+    uint32_t queued;    /* reports accepted into an empty slot */
+    uint32_t sent;      /* reports picked up by the host */
+    uint32_t merged;    /* reports that overwrote a pending one while the queue was full */
+    uint32_t waited;    /* times send_keyboard() had to wait for the host to make room */
+    uint32_t dropped;   /* reports discarded because the bus was not active or was reset */
+    uint8_t  max_depth; /* deepest the queue has been */
+} usb_keyboard_report_stats_t;
+
+/* snapshot the keyboard report queue counters */
+void usb_get_keyboard_report_stats(usb_keyboard_report_stats_t *stats);
+
+/* reset the keyboard report queue counters */
+void usb_clear_keyboard_report_stats(void);
+#endif /* KEYBOARD_REPORT_QUEUE_SIZE */
+
 #ifdef NKRO_ENABLE
 /* nkro IN callback hander */
 void nkro_in_cb(USBDriver *usbp, usbep_t ep);